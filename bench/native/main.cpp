@@ -0,0 +1,1509 @@
+//
+// Benchmark nativo (Linux/PC) da biblioteca SGP4 e da geração de passagens.
+//
+//   pio run -e native && .pio/build/native/program
+//
+// 1. Verificação: compara sgp4() (wgs72) com as efemérides de referência do conjunto
+//    de verificação do Vallado (SGP4-VER.TLE / tcppver.out).
+//    Também compara a rotação da Terra por recorrência (gmstsweep) e gstime() a cada
+//    amostra com uma referência em long double, ao longo de 24 h em passos de 10 s.
+// 2. Vazão: propagações por segundo (double, float e Sgp4Model), com o erro de posição e
+//    az/el do float contra o double em 24 h (falha acima do limite), conversões az/el por
+//    segundo (por amostra e em varredura), passagens previstas por segundo, propagações
+//    de nextpass() por passagem (total e no refinamento de AOS/LOS) e tempo até a
+//    primeira passagem (PassPredictor, com Doppler; a geração incremental com orçamento
+//    de tempo deve dar as mesmas passagens),
+//    e a previsão para uma rede de estações com propagação compartilhada comparada a
+//    uma previsão por estação. Memória da trajetória compacta (PassPath) contra SatPosition,
+//    com o erro da interpolação contra a trajetória completa. Previsão em segundo plano
+//    (PassService com std::thread): mesmas passagens pela fila, e um novo pedido ou cancel()
+//    descartam o anterior.
+// 3. Pré-filtro geométrico (passfilter): classificação de cada TLE para vários observadores
+//    conferida com uma varredura de 30 s, e o tempo de generate() com o satélite descartado.
+//    Horizonte local (horizonmask): AOS/LOS de PassPredictor e PassScheduler conferidos com
+//    uma varredura de 1 s da elevação acima da máscara.
+//    Iluminação: posição do Sol interpolada (suncache) contra sun() e o custo por amostra,
+//    e a classificação da trajetória (dia, sombra, visível) conferida ponto a ponto.
+// 4. Grupo: PassScheduler para centenas de satélites (tempo total e propagações por
+//    satélite), com AOS/LOS conferidos contra PassPredictor::generate(), passagens
+//    visíveis a olho nu e o filtro de nextPasses().
+//    Aproximações: ConjunctionScreener no mesmo grupo (e nos TLEs de órbita alta) conferido
+//    com uma varredura de todos os pares a cada passo, com TCA por seção áurea; a triagem
+//    em etapas com orçamento de tempo deve dar as mesmas aproximações.
+// 5. Traço no solo: GroundTrack decimado conferido com todas as amostras de findsat(),
+//    continuidade dos trechos na linha de data e raio da área de visibilidade.
+//
+// Retorna 1 se alguma verificação falhar, para poder ser usado em scripts.
+//
+
+#include <Sgp4.h>
+#include <sgp4coord.h>
+#include <sgp4float.h>
+#include <sgp4model.h>
+#include <sgp4sites.h>
+#include <visible.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "ConjunctionScreener.h"
+#include "GroundTrack.h"
+#include "PassPredictor.h"
+#include "PassScheduler.h"
+#include "PassService.h"
+
+namespace {
+
+/// TLE do conjunto de verificação.
+struct BenchTle {
+    const char* name;
+    const char* line1;
+    const char* line2;
+};
+
+/// Vetor de estado de referência (TEME, km e km/s).
+struct Reference {
+    int tle;          ///< Índice em VERIFICATION_TLES
+    double tsince;    ///< Minutos desde a época
+    double r[3];
+    double v[3];
+};
+
+const BenchTle VERIFICATION_TLES[] = {
+    {"00005", "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+              "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667"},
+    {"06251", "1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985",
+              "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774"},
+    {"28057", "1 28057U 03049A   06177.78615833  .00000060  00000-0  35940-4 0  1836",
+              "2 28057  98.4283 247.6961 0000884  88.1964 271.9322 14.35478080140550"},
+    {"08195", "1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813",
+              "2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656"},
+    {"14128", "1 14128U 83058A   06176.02844893 -.00000158  00000-0  10000-3 0  9627",
+              "2 14128  11.4384  35.2134 0011562  26.4582 333.5652  0.98870114 46093"},
+};
+const int NUM_TLES = sizeof(VERIFICATION_TLES) / sizeof(VERIFICATION_TLES[0]);
+
+// Linhas de tcppver.out: 00005 (excêntrico) ao longo de 3 dias, 06251 a cada 2 h por 12 h,
+// 28057 nas primeiras 4 h, 08195 (Molniya, ressonância de 12 h) nas primeiras 6 h e 14128 na época
+const Reference REFERENCES[] = {
+    {0,    0.0, {  7022.46529266, -1400.08296755,     0.03995155}, {  1.893841015,  6.405893759,  4.534807250}},
+    {0,  360.0, { -7154.03120202, -3783.17682504, -3536.19412294}, {  4.741887409, -4.151817765, -2.093935425}},
+    {0, 1080.0, {  5568.53901181,  4492.06992591,  3863.87641983}, { -4.209106476,  5.159719888,  2.744852980}},
+    {0, 1440.0, {  -938.55923943, -6268.18748831, -4294.02924751}, {  7.536105209, -0.427127707,  0.989878080}},
+    {0, 1800.0, { -9680.56121728,  2802.47771354,   124.10688038}, { -0.905874102, -4.659467970, -3.227347517}},
+    {0, 2160.0, {   190.19796988,  7746.96653614,  5110.00675412}, { -6.112325142,  1.527008184, -0.139152358}},
+    {0, 2520.0, {  5579.55640116, -3995.61396789, -1518.82108966}, {  4.767927483,  5.123185301,  4.276837355}},
+    {0, 2880.0, { -8650.73082219, -1914.93811525, -3007.03603443}, {  3.067165127, -4.828384068, -2.515322836}},
+    {0, 3240.0, { -5429.79204164,  7574.36493792,  3747.39305236}, { -4.999442110, -1.800561422, -2.229392830}},
+    {0, 3600.0, {  6759.04583722,  2001.58198220,  2783.55192533}, { -2.180993947,  6.402085603,  3.644723952}},
+    {0, 3960.0, { -3791.44531559, -5712.95617894, -4533.48630714}, {  6.668817493, -2.516382327, -0.082384354}},
+    {0, 4320.0, { -9060.47373569,  4658.70952502,   813.68673153}, { -2.232832783, -4.110453490, -3.157345433}},
+    {1,    0.0, {  3988.31022699,  5498.96657235,     0.90055879}, { -3.290032738,  2.357652820,  6.496623475}},
+    {1,  120.0, { -3935.69800083,   409.10980837,  5471.33577327}, { -3.374784183, -6.635211043, -1.942056221}},
+    {1,  240.0, { -1675.12766915, -5683.30432352, -3286.21510937}, {  5.282496925,  1.508674259, -5.354872978}},
+    {1,  360.0, {  4993.62642836,  2890.54969900, -3600.40145627}, {  0.347333429,  5.707031557,  5.070699638}},
+    {1,  480.0, { -1115.07959514,  4015.11691491,  5326.99727718}, { -5.524279443, -4.765738774,  2.402255961}},
+    {1,  600.0, { -4329.10008198, -5176.70287935,   409.65313857}, {  2.858408303, -2.933091792, -6.509690397}},
+    {1,  720.0, {  3692.60030028,  -976.24265255, -5623.36447493}, {  3.897257243,  6.415554948,  1.429112190}},
+    {2,    0.0, { -2715.28237486, -6619.26436889,    -0.01341443}, { -1.008587273,  0.422782003,  7.385272942}},
+    {2,  120.0, { -1816.87920942, -1835.78762132,  6661.07926465}, {  2.325140071,  6.655669329,  2.463394512}},
+    {2,  240.0, {  1483.17364291,  5395.21248786,  4448.65907172}, {  2.560540387,  4.039025766, -5.736648561}},
+    {3,    0.0, {  2349.89483350,-14785.93811562,     0.02119378}, {  2.721488096, -3.256811655,  4.498416672}},
+    {3,  120.0, { 15223.91713658,-17852.95881713, 25280.39558224}, {  1.079041732,  0.875187372,  2.485682813}},
+    {3,  240.0, { 19752.78050009, -8600.07130592, 37522.72921258}, {  0.238105279,  1.546110924,  0.986410447}},
+    {3,  360.0, { 19089.29762968,  3107.89495018, 39958.14661699}, { -0.410308034,  1.640332277, -0.306873818}},
+    {4,    0.0, { 34747.57932696, 24502.37114079,    -1.32832986}, { -1.731642662,  2.452772615,  0.608510081}},
+};
+const int NUM_REFERENCES = sizeof(REFERENCES) / sizeof(REFERENCES[0]);
+
+// Tolerâncias da verificação (a maior diferença é de 00005, cerca de 11 m após 3 dias)
+constexpr double POSITION_TOLERANCE_KM  = 0.015;
+constexpr double VELOCITY_TOLERANCE_KMS = 0.000015;
+constexpr double SWEEP_TOLERANCE_RAD    = 1e-9;    // ~7 µm a 7000 km
+
+// Erro aceito de sgp4f() contra sgp4() em 24 h a partir da época (SGP4_SINGLE_PRECISION em Config.h):
+// 00005, excêntrico e a até 10000 km, fica perto de 30 m; 0,01° está abaixo do que a tela mostra
+constexpr double FLOAT_POSITION_TOLERANCE_KM = 0.050;
+constexpr double FLOAT_AZEL_TOLERANCE_DEG    = 0.01;
+
+// Varredura usada na verificação e no benchmark da rotação da Terra
+constexpr int SWEEP_STEP_S  = 10;
+constexpr int SWEEP_SAMPLES = 86400 / SWEEP_STEP_S + 1;
+
+// Observador usado na previsão de passagens (Campinas/SP)
+constexpr double SITE_LAT = -22.90;
+constexpr double SITE_LON = -47.06;
+constexpr double SITE_ALT = 600.0;
+
+/// Observador da previsão de passagens.
+struct BenchSite {
+    const char* name;
+    double lat;
+    double lon;
+    double alt;
+};
+
+// Campinas e McMurdo: perto do polo, uma passagem longa de 08195 termina logo antes da janela
+const BenchSite PASS_SITES[] = {
+    {"Campinas/SP", SITE_LAT, SITE_LON, SITE_ALT},
+    {"McMurdo", -77.85, 166.67, 10.0},
+};
+
+constexpr int PROPAGATIONS       = 200000;   // por TLE e por método
+constexpr unsigned long WINDOW_S = 3 * 86400UL;   // janela da previsão de passagens
+
+// Grupo sintético: cópias de 06251 e 28057 com nodo e anomalia média espalhados
+constexpr int GROUP_COPIES           = 150;      // por TLE
+constexpr unsigned long GROUP_WINDOW_S = 86400UL;
+
+// Triagem de aproximações: o grupo sintético e os TLEs de órbita alta, 24 h
+constexpr double CONJUNCTION_KM             = 10.0;
+constexpr unsigned long CONJUNCTION_STEP_S  = 60;
+constexpr double ESCAPE_SPEED_KMS           = 11.1;   // limite de velocidade da referência (órbitas fechadas)
+
+// Traço no solo: os mesmos valores de GROUND_TRACK_* em config.h
+constexpr double TRACK_ORBITS               = 3.0;
+constexpr unsigned long TRACK_STEP_S        = 10;
+constexpr double TRACK_TOLERANCE            = 0.25;   // graus
+
+double nowSeconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void parseTle(const BenchTle& tle, gravconsttype whichconst, elsetrec& satrec) {
+    char line1[130];
+    char line2[130];
+    strncpy(line1, tle.line1, sizeof(line1) - 1);
+    line1[sizeof(line1) - 1] = '\0';
+    strncpy(line2, tle.line2, sizeof(line2) - 1);
+    line2[sizeof(line2) - 1] = '\0';
+    twoline2rv(line1, line2, 'i', whichconst, satrec);
+}
+
+double distance(const double a[3], const double b[3]) {
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+//
+// Compara as propagações com as efemérides de referência
+//
+bool verify() {
+    bool ok = true;
+    printf("== Verificação (wgs72, referência Vallado) ==\n");
+    printf("%-6s %8s %12s %14s\n", "TLE", "t (min)", "erro r (m)", "erro v (mm/s)");
+
+    for (int i = 0; i < NUM_REFERENCES; i++) {
+        const Reference& ref = REFERENCES[i];
+        elsetrec satrec;
+        double r[3], v[3];
+        parseTle(VERIFICATION_TLES[ref.tle], wgs72, satrec);
+        sgp4(wgs72, satrec, ref.tsince, r, v);
+
+        double dr = distance(r, ref.r);
+        double dv = distance(v, ref.v);
+        bool pass = satrec.error == 0 && dr <= POSITION_TOLERANCE_KM && dv <= VELOCITY_TOLERANCE_KMS;
+        ok = ok && pass;
+        printf("%-6s %8.1f %12.3f %14.4f %s\n", VERIFICATION_TLES[ref.tle].name, ref.tsince,
+               dr * 1000.0, dv * 1e6, pass ? "ok" : "FALHOU");
+    }
+    return ok;
+}
+
+//
+// Posições TEME de 24 h em passos de SWEEP_STEP_S, a partir da época
+//
+void sweepPositions(elsetrec& satrec, std::vector<double>& r, std::vector<double>& v) {
+    r.resize(3 * SWEEP_SAMPLES);
+    v.resize(3 * SWEEP_SAMPLES);
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        sgp4(wgs84, satrec, i * SWEEP_STEP_S / 60.0, &r[3 * i], &v[3 * i]);
+    }
+}
+
+//
+// gstime() em long double, com a data juliana separada em época + minutos: referência
+// para as duas formas (com double, a data juliana já é quantizada em ~40 µs)
+//
+void referenceRotation(double jdepoch, long double minutes, GmstSweep& ref) {
+    const long double twopi = 2.0L * pi;
+    long double tut1 = ((jdepoch - 2451545.0L) + minutes / 1440.0L) / 36525.0L;
+    long double temp = -6.2e-6L * tut1 * tut1 * tut1 + 0.093104L * tut1 * tut1 +
+                       (876600.0L * 3600 + 8640184.812866L) * tut1 + 67310.54841L;
+    long double gmst = fmodl(temp * (pi / 180.0L) / 240.0L, twopi);
+    ref.ct = static_cast<double>(cosl(gmst));
+    ref.st = static_cast<double>(sinl(gmst));
+}
+
+//
+// Compara a varredura (gmstsweep/gmstnext) e gstime() a cada amostra com a referência
+//
+bool verifySweep() {
+    bool ok = true;
+    printf("\n== Verificação da rotação por recorrência (24 h, passos de %d s) ==\n", SWEEP_STEP_S);
+    printf("%-6s %14s %16s %14s %14s\n", "TLE", "gstime (rad)", "varredura (rad)",
+           "gstime (m)", "varredura (m)");
+
+    ObserverFrame frame;
+    observerframe(SITE_LAT * pi / 180.0, SITE_LON * pi / 180.0, SITE_ALT / 1000.0, 0.0, frame);
+
+    for (int k = 0; k < NUM_TLES; k++) {
+        elsetrec satrec;
+        std::vector<double> r, v;
+        parseTle(VERIFICATION_TLES[k], wgs84, satrec);
+        sweepPositions(satrec, r, v);
+        observerpolar(frame, satrec.jdsatepoch);
+
+        // Maior erro angular (az, el) e de alcance de cada forma
+        double maxSample = 0.0, maxSweep = 0.0, rangeSample = 0.0, rangeSweep = 0.0;
+        double jdstep = SWEEP_STEP_S / 86400.0;
+        GmstSweep sweep, ref;
+        gmstsweep(satrec.jdsatepoch, jdstep, sweep);
+        for (int i = 0; i < SWEEP_SAMPLES; i++, gmstnext(sweep)) {
+            double a[3], b[3], c[3];
+            referenceRotation(satrec.jdsatepoch, i * SWEEP_STEP_S / 60.0L, ref);
+            rv2azel(&r[3 * i], frame, ref, c);
+            rv2azel(&r[3 * i], frame, satrec.jdsatepoch + i * jdstep, a);
+            rv2azel(&r[3 * i], frame, sweep, b);
+
+            double da = fabs(remainder(a[1] - c[1], 2.0 * pi)) * cos(c[2]);
+            double db = fabs(remainder(b[1] - c[1], 2.0 * pi)) * cos(c[2]);
+            maxSample   = fmax(maxSample, fmax(da, fabs(a[2] - c[2])));
+            maxSweep    = fmax(maxSweep, fmax(db, fabs(b[2] - c[2])));
+            rangeSample = fmax(rangeSample, fabs(a[0] - c[0]));
+            rangeSweep  = fmax(rangeSweep, fabs(b[0] - c[0]));
+        }
+
+        bool pass = maxSweep <= SWEEP_TOLERANCE_RAD;
+        ok = ok && pass;
+        printf("%-6s %14.2e %16.2e %14.2e %14.2e %s\n", VERIFICATION_TLES[k].name, maxSample, maxSweep,
+               rangeSample * 1000.0, rangeSweep * 1000.0, pass ? "ok" : "FALHOU");
+    }
+    return ok;
+}
+
+//
+// Conversões az/el por segundo: rv2azel() com o site, com o ObserverFrame e em varredura
+//
+void benchSweep() {
+    printf("\n== Conversão az/el (24 h, passos de %d s, %d amostras) ==\n", SWEEP_STEP_S, SWEEP_SAMPLES);
+    printf("%-22s %14s\n", "método", "conversões/s");
+
+    elsetrec satrec;
+    std::vector<double> r, v;
+    parseTle(VERIFICATION_TLES[2], wgs84, satrec);
+    sweepPositions(satrec, r, v);
+
+    double lat = SITE_LAT * pi / 180.0;
+    double lon = SITE_LON * pi / 180.0;
+    double alt = SITE_ALT / 1000.0;
+    double jdstep = SWEEP_STEP_S / 86400.0;
+    ObserverFrame frame;
+    observerframe(lat, lon, alt, satrec.jdsatepoch, frame);
+
+    const int repeats = 20;
+    volatile double sink = 0.0;
+    double razel[3];
+
+    // Caminho original: site(), polarm(), gstime() e senos/cossenos a cada amostra
+    double t0 = nowSeconds();
+    for (int n = 0; n < repeats; n++) {
+        for (int i = 0; i < SWEEP_SAMPLES; i++) {
+            rv2azel(&r[3 * i], lat, lon, alt, satrec.jdsatepoch + i * jdstep, razel);
+            sink = sink + razel[2];
+        }
+    }
+    double rateSite = repeats * SWEEP_SAMPLES / (nowSeconds() - t0);
+
+    t0 = nowSeconds();
+    for (int n = 0; n < repeats; n++) {
+        for (int i = 0; i < SWEEP_SAMPLES; i++) {
+            rv2azel(&r[3 * i], frame, satrec.jdsatepoch + i * jdstep, razel);
+            sink = sink + razel[2];
+        }
+    }
+    double rateFrame = repeats * SWEEP_SAMPLES / (nowSeconds() - t0);
+
+    t0 = nowSeconds();
+    for (int n = 0; n < repeats; n++) {
+        GmstSweep sweep;
+        gmstsweep(satrec.jdsatepoch, jdstep, sweep);
+        for (int i = 0; i < SWEEP_SAMPLES; i++, gmstnext(sweep)) {
+            rv2azel(&r[3 * i], frame, sweep, razel);
+            sink = sink + razel[2];
+        }
+    }
+    double rateSweep = repeats * SWEEP_SAMPLES / (nowSeconds() - t0);
+
+    printf("%-22s %14.0f\n", "site + gstime", rateSite);
+    printf("%-22s %14.0f\n", "ObserverFrame + gstime", rateFrame);
+    printf("%-22s %14.0f\n", "ObserverFrame + sweep", rateSweep);
+}
+
+//
+// Propagações por segundo com sgp4(), sgp4f() e Sgp4Model::propagate(), e o erro de sgp4f()
+// contra sgp4() (posição e az/el com o satélite acima do horizonte) ao longo de 24 h
+//
+bool benchPropagation() {
+    bool ok = true;
+    printf("\n== Propagação (wgs84, %d chamadas; erro do float em 24 h, limite %.0f m e %.3f°) ==\n",
+           PROPAGATIONS, FLOAT_POSITION_TOLERANCE_KM * 1000.0, FLOAT_AZEL_TOLERANCE_DEG);
+    printf("%-6s %6s %14s %14s %14s %12s %12s\n", "TLE", "tipo", "double (1/s)", "float (1/s)", "modelo (1/s)",
+           "erro pos(m)", "erro az/el(°)");
+
+    ObserverFrame frame;
+    observerframe(SITE_LAT * pi / 180.0, SITE_LON * pi / 180.0, SITE_ALT / 1000.0, 0.0, frame);
+
+    for (int k = 0; k < NUM_TLES; k++) {
+        elsetrec satrec;
+        double r[3], v[3];
+        float rf[3], vf[3];
+        volatile double sink = 0.0;
+        parseTle(VERIFICATION_TLES[k], wgs84, satrec);
+
+        // sgp4() em passos de 1 min, percorrendo 2 dias a partir da época
+        double t0 = nowSeconds();
+        for (int i = 0; i < PROPAGATIONS; i++) {
+            sgp4(wgs84, satrec, (i % 2880) * 1.0, r, v);
+            sink = sink + r[0];
+        }
+        double rateDouble = PROPAGATIONS / (nowSeconds() - t0);
+
+        double rateFloat = 0.0;
+        double maxPosition = 0.0;
+        double maxAzel = 0.0;
+        bool pass = true;
+        if (satrec.method == 'n') {
+            t0 = nowSeconds();
+            for (int i = 0; i < PROPAGATIONS; i++) {
+                sgp4f(wgs84, satrec, (i % 2880) * 1.0, rf, vf);
+                sink = sink + rf[0];
+            }
+            rateFloat = PROPAGATIONS / (nowSeconds() - t0);
+
+            // Erro a cada 30 s; o azimute pesa pelo cosseno da elevação (perto do zênite ele gira rápido)
+            for (int i = 0; i <= 2880; i++) {
+                double tsince = i * 0.5;
+                double jd = satrec.jdsatepoch + tsince / 1440.0;
+                double razel[3];
+                float razelf[3];
+                sgp4(wgs84, satrec, tsince, r, v);
+                sgp4f(wgs84, satrec, tsince, rf, vf);
+                double dr[3] = {r[0] - rf[0], r[1] - rf[1], r[2] - rf[2]};
+                maxPosition = fmax(maxPosition, sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]));
+                rv2azel(r, frame, jd, razel);
+                rv2azel(rf, frame, jd, razelf);
+                if (razel[2] > 0.0) {
+                    double daz = fabs(remainder(razel[1] - razelf[1], 2.0 * pi)) * cos(razel[2]);
+                    double del = fabs(razel[2] - razelf[2]);
+                    maxAzel = fmax(maxAzel, fmax(daz, del) * 180.0 / pi);
+                }
+            }
+            pass = maxPosition <= FLOAT_POSITION_TOLERANCE_KM && maxAzel <= FLOAT_AZEL_TOLERANCE_DEG;
+            ok = ok && pass;
+        }
+
+        // Modelo reentrante com o cálculo de azimute/elevação incluído
+        Sgp4Model model;
+        Sgp4Context ctx;
+        model.site(SITE_LAT, SITE_LON, SITE_ALT);
+        model.init(VERIFICATION_TLES[k].name, satrec);
+        model.initcontext(ctx);
+        t0 = nowSeconds();
+        for (int i = 0; i < PROPAGATIONS; i++) {
+            model.propagate(ctx, satrec.jdsatepoch + (i % 2880) / 1440.0);
+            sink = sink + ctx.razel[2];
+        }
+        double rateModel = PROPAGATIONS / (nowSeconds() - t0);
+
+        if (satrec.method == 'n') {
+            printf("%-6s %6s %14.0f %14.0f %14.0f %12.1f %12.4f %s\n", VERIFICATION_TLES[k].name, "near",
+                   rateDouble, rateFloat, rateModel, maxPosition * 1000.0, maxAzel, pass ? "ok" : "FALHOU");
+        } else {
+            printf("%-6s %6s %14.0f %14s %14.0f %12s %12s\n", VERIFICATION_TLES[k].name, "deep",
+                   rateDouble, "-", rateModel, "-", "-");
+        }
+    }
+    return ok;
+}
+
+//
+// Passagens previstas por segundo, propagações de nextpass() por passagem e tempo até a
+// primeira passagem; a geração incremental com orçamento deve dar as mesmas passagens
+//
+bool benchPasses() {
+    bool ok = true;
+    printf("\n== Previsão de passagens (%lu dias, elevação >= 10°) ==\n", WINDOW_S / 86400UL);
+
+    PassPredictor predictor;
+    predictor.setDownlinkFrequency(137.1e6);   // inclui o Doppler da trajetória, como no firmware
+    std::vector<PassData> passes;
+
+    for (const BenchSite& site : PASS_SITES) {
+        printf("%s\n", site.name);
+        printf("%-6s %9s %10s %12s %14s %13s %10s %12s %14s\n", "TLE", "passagens", "tempo (ms)", "passagens/s",
+               "propag./pass.", "AOS+LOS/pass.", "ds/pass.", "1ª pass. (ms)", "incremental");
+        for (int k = 0; k < NUM_TLES; k++) {
+            Sgp4 sat;
+            sat.site(site.lat, site.lon, site.alt);
+            sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+
+            // Janela começando um dia após a época
+            unsigned long start = static_cast<unsigned long>((sat.satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+            unsigned long end = start + WINDOW_S;
+
+            double t0 = nowSeconds();
+            int count = predictor.generate(sat, start, WINDOW_S, passes);
+            double elapsed = nowSeconds() - t0;
+
+            PassStats stats = predictor.lastStats();
+            int n = count > 0 ? count : 0;
+
+            // Mesma janela com 100 µs por chamada: passagens iguais, em mais chamadas, e todas
+            // com alguma parte dentro da janela (nenhuma encerrada antes do início)
+            Sgp4 incremental;
+            incremental.site(site.lat, site.lon, site.alt);
+            incremental.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+            PassGenerator generator;
+            PassData pass;
+            size_t matched = 0;
+            bool same = generator.begin(predictor, incremental, start, WINDOW_S);
+            while (same && !generator.finished()) {
+                if (generator.next(pass, 100)) {
+                    same = matched < passes.size() && passes[matched].startPassUnix == pass.startPassUnix &&
+                           passes[matched].endPassUnix == pass.endPassUnix &&
+                           pass.endPassUnix >= start && pass.startPassUnix <= end;
+                    matched++;
+                }
+            }
+            same = same && matched == passes.size();
+            ok = ok && same;
+
+            printf("%-6s %9d %10.2f %12.1f %14.1f %13.1f %10.1f %12.2f %8d chamadas %s\n", VERIFICATION_TLES[k].name,
+                   n, elapsed * 1000.0, n / elapsed,
+                   n > 0 ? static_cast<double>(stats.evaluations) / n : 0.0,
+                   n > 0 ? static_cast<double>(stats.edgeEvaluations) / n : 0.0,
+                   n > 0 ? static_cast<double>(stats.dssteps) / n : 0.0,
+                   stats.firstPassUs >= 0 ? stats.firstPassUs / 1000.0 : 0.0,
+                   predictor.lastStats().steps, same ? "ok" : "FALHOU");
+        }
+    }
+    return ok;
+}
+
+//
+// Trajetória compacta (PassPath): memória contra SatPosition na grade de 10 s e erro da
+// interpolação contra a trajetória completa
+//
+bool benchPath() {
+    bool ok = true;
+    printf("\n== Trajetória compacta (%lu dias, passo de 10 s, Doppler em 137,1 MHz) ==\n", WINDOW_S / 86400UL);
+    printf("%-6s %9s %8s %9s %12s %12s %8s %10s %12s\n", "TLE", "passagens", "grade", "guardados",
+           "antes (B)", "depois (B)", "redução", "erro (°)", "Doppler (Hz)");
+
+    PassPredictor predictor;
+    predictor.setDownlinkFrequency(137.1e6);
+    std::vector<PassData> passes;
+
+    for (int k = 0; k < NUM_TLES; k++) {
+        Sgp4 sat;
+        sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+        sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        unsigned long start = static_cast<unsigned long>((sat.satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+        predictor.generate(sat, start, WINDOW_S, passes);
+        PassStats stats = predictor.lastStats();
+
+        size_t before = 0;
+        size_t after = 0;
+        double maxAngle = 0.0;
+        double maxDoppler = 0.0;
+        for (const PassData& pass : passes) {
+            after += pass.path.bytes();
+            int n = static_cast<int>((pass.endPassUnix - pass.startPassUnix) / 10) + 1;
+            before += n * sizeof(SatPosition);
+
+            // Trajetória completa na mesma grade
+            std::vector<double> az(n), el(n), rate(n);
+            sat.timeline(pass.startPassUnix, 10UL, n, az.data(), el.data(), nullptr, rate.data());
+            for (int i = 0; i < n; i++) {
+                SatPosition p = pass.path.at(pass.startPassUnix + 10UL * i);
+                double dAz = fabs(p.azimuth - az[i]);
+                dAz = fmin(dAz, 360.0 - dAz) * cos(el[i] * pi / 180.0);
+                double dEl = p.elevation - el[i];
+                maxAngle = fmax(maxAngle, sqrt(dAz * dAz + dEl * dEl));
+                maxDoppler = fmax(maxDoppler, fabs(p.doppler + 137.1e6 * rate[i] / 299792.458));
+            }
+        }
+
+        // Erro limitado a duas vezes o limiar de amostragem (ou ~50 Hz no Doppler)
+        bool pass = maxAngle <= 2.0 * PassPath::MIN_ANGLE_DEG && maxDoppler <= 50.0;
+        ok = ok && pass;
+        printf("%-6s %9d %8ld %9ld %12lu %12lu %7.1fx %10.2f %12.1f %s\n", VERIFICATION_TLES[k].name,
+               static_cast<int>(passes.size()), stats.pathPoints, stats.pathStored,
+               static_cast<unsigned long>(before), static_cast<unsigned long>(after),
+               after > 0 ? static_cast<double>(before) / after : 0.0, maxAngle, maxDoppler, pass ? "ok" : "FALHOU");
+    }
+    return ok;
+}
+
+//
+// Pedido de previsão para a tarefa em segundo plano, nas mesmas condições de benchPasses()
+//
+void serviceRequest(int k, unsigned long duration, PassRequest& request, unsigned long& start) {
+    Sgp4 sat;
+    sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+    start = static_cast<unsigned long>((sat.satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+
+    memset(&request, 0, sizeof(request));
+    strncpy(request.name, VERIFICATION_TLES[k].name, sizeof(request.name) - 1);
+    request.satrec = sat.satrec;
+    request.lat = SITE_LAT;
+    request.lon = SITE_LON;
+    request.alt = SITE_ALT;
+    request.startUnix = start;
+    request.duration = duration;
+    request.minElevation = 10.0;
+    request.downlinkHz = 137.1e6;
+}
+
+//
+// Previsão em segundo plano (PassService com std::thread): passagens iguais às de
+// PassPredictor::generate(), entregues pela fila; um novo pedido e cancel() descartam o anterior
+//
+bool benchService() {
+    bool ok = true;
+    printf("\n== Previsão em segundo plano (PassService, %lu dias, etapas de 20 ms) ==\n", WINDOW_S / 86400UL);
+    printf("%-6s %9s %14s %11s\n", "TLE", "passagens", "1ª pass. (ms)", "total (ms)");
+
+    PassService service;
+    if (!service.begin()) {
+        printf("Erro ao criar a tarefa\n");
+        return false;
+    }
+    service.setStepBudget(20000);
+
+    PassPredictor predictor;
+    predictor.setDownlinkFrequency(137.1e6);
+    std::vector<PassData> reference;
+    PassRequest request;
+    PassResult result;
+    unsigned long start;
+
+    for (int k = 0; k < NUM_TLES; k++) {
+        serviceRequest(k, WINDOW_S, request, start);
+        Sgp4 sat;
+        sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+        sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        predictor.generate(sat, start, WINDOW_S, reference);
+
+        double t0 = nowSeconds();
+        double first = -1.0;
+        uint32_t id = service.submit(request);
+        size_t matched = 0;
+        bool same = id != 0;
+        while (same && service.busy() && service.wait(result, 10000)) {
+            same = result.request == id;
+            if (result.type == PASS_RESULT_FOUND) {
+                if (first < 0.0) {
+                    first = nowSeconds() - t0;
+                }
+                same = same && matched < reference.size() &&
+                       reference[matched].startPassUnix == result.pass->startPassUnix &&
+                       reference[matched].endPassUnix == result.pass->endPassUnix &&
+                       reference[matched].path.size() == result.pass->path.size();
+                matched++;
+                delete result.pass;
+            } else {
+                same = same && result.type == PASS_RESULT_DONE && result.stats.passes == static_cast<int>(matched);
+            }
+        }
+        double elapsed = nowSeconds() - t0;
+        same = same && !service.busy() && matched == reference.size();
+        ok = ok && same;
+        printf("%-6s %9d %14.2f %11.2f %s\n", VERIFICATION_TLES[k].name, static_cast<int>(matched),
+               first >= 0.0 ? first * 1000.0 : 0.0, elapsed * 1000.0, same ? "ok" : "FALHOU");
+    }
+
+    // Novo pedido no meio de uma busca longa (00005, 60 dias): só chegam resultados do novo
+    serviceRequest(0, 60 * 86400UL, request, start);
+    uint32_t stale = service.submit(request);
+    bool found = service.wait(result, 10000) && result.request == stale && result.type == PASS_RESULT_FOUND;
+    if (found) {
+        delete result.pass;
+    }
+    serviceRequest(2, WINDOW_S, request, start);
+    Sgp4 sat;
+    sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+    sat.init(VERIFICATION_TLES[2].name, VERIFICATION_TLES[2].line1, VERIFICATION_TLES[2].line2);
+    predictor.generate(sat, start, WINDOW_S, reference);
+
+    double t0 = nowSeconds();
+    uint32_t id = service.submit(request);
+    size_t matched = 0;
+    bool replaced = found;
+    while (replaced && service.busy() && service.wait(result, 10000)) {
+        replaced = result.request == id;
+        if (result.type == PASS_RESULT_FOUND) {
+            replaced = replaced && matched < reference.size() &&
+                       reference[matched].startPassUnix == result.pass->startPassUnix;
+            matched++;
+            delete result.pass;
+        }
+    }
+    replaced = replaced && matched == reference.size();
+    ok = ok && replaced;
+    printf("Novo pedido durante a busca: %d passagens do novo pedido em %.2f ms %s\n", static_cast<int>(matched),
+           (nowSeconds() - t0) * 1000.0, replaced ? "ok" : "FALHOU");
+
+    // cancel() (botão BACK): nenhum resultado depois do cancelamento
+    serviceRequest(0, 60 * 86400UL, request, start);
+    service.submit(request);
+    found = service.wait(result, 10000) && result.type == PASS_RESULT_FOUND;
+    if (found) {
+        delete result.pass;
+    }
+    t0 = nowSeconds();
+    service.cancel();
+    bool cancelled = found && !service.busy() && !service.wait(result, 200);
+    ok = ok && cancelled;
+
+    // Pedido em andamento para o end(): a tarefa para na próxima etapa
+    service.submit(request);
+    double t1 = nowSeconds();
+    service.end();
+    printf("cancel(): %s; end() com busca em andamento: %.2f ms\n", cancelled ? "ok" : "FALHOU",
+           (nowSeconds() - t1) * 1000.0);
+    return ok;
+}
+
+//
+// Estações da rede: grade de 4 x 4 em torno do observador, 3° entre estações
+//
+void networkSites(int count, Sgp4Sites& sites) {
+    sites.clear();
+    for (int i = 0; i < count; i++) {
+        sites.add(SITE_LAT + 3.0 * (i / 4), SITE_LON + 3.0 * (i % 4), SITE_ALT);
+    }
+}
+
+//
+// Rede de estações: uma propagação compartilhada contra generate() uma vez por estação
+//
+bool benchNetwork() {
+    bool ok = true;
+    const int counts[] = {1, 4, 16};
+
+    printf("\n== Rede de estações (%lu dias, elevação >= 10°) ==\n", WINDOW_S / 86400UL);
+    printf("%-6s %8s %10s %14s %14s %10s %12s\n", "TLE", "estações", "passagens", "por estação (ms)",
+           "rede (ms)", "aceleração", "AOS/LOS (s)");
+
+    PassPredictor predictor;
+    std::vector<PassData> single;
+    std::vector<std::vector<PassData>> network;
+
+    for (int k = 0; k < 3; k++) {    // objetos de órbita baixa
+        Sgp4Model model;
+        model.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        unsigned long start = static_cast<unsigned long>((model.elements().jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+
+        for (int count : counts) {
+            Sgp4Sites sites;
+            networkSites(count, sites);
+            sites.polar(model.elements().jdsatepoch);
+
+            // Uma previsão completa por estação
+            int singlePasses = 0;
+            double maxDiff = 0.0;
+            int unmatched = 0;
+            double t0 = nowSeconds();
+            std::vector<std::vector<PassData>> perSite(count);
+            for (int s = 0; s < count; s++) {
+                Sgp4 sat;
+                sat.site(SITE_LAT + 3.0 * (s / 4), SITE_LON + 3.0 * (s % 4), SITE_ALT);
+                sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+                predictor.generate(sat, start, WINDOW_S, perSite[s]);
+            }
+            double elapsedSingle = nowSeconds() - t0;
+
+            t0 = nowSeconds();
+            int networkPasses = predictor.generate(model, sites, start, WINDOW_S, network);
+            double elapsedNetwork = nowSeconds() - t0;
+
+            // Compara AOS e LOS das passagens que começam dentro da janela
+            for (int s = 0; s < count; s++) {
+                for (const PassData& p : perSite[s]) {
+                    if (p.startPassUnix < start || p.startPassUnix > start + WINDOW_S) {
+                        continue;
+                    }
+                    singlePasses++;
+                    const PassData* match = nullptr;
+                    for (const PassData& q : network[s]) {
+                        if (q.startPassUnix + 120 > p.startPassUnix && q.startPassUnix < p.startPassUnix + 120) {
+                            match = &q;
+                        }
+                    }
+                    if (match == nullptr) {
+                        unmatched++;
+                        continue;
+                    }
+                    maxDiff = fmax(maxDiff, fabs(static_cast<double>(match->startPassUnix) - p.startPassUnix));
+                    maxDiff = fmax(maxDiff, fabs(static_cast<double>(match->endPassUnix) - p.endPassUnix));
+                }
+            }
+
+            bool pass = unmatched == 0 && maxDiff <= 2.0;
+            ok = ok && pass;
+            printf("%-6s %8d %4d / %-4d %14.2f %14.2f %9.1fx %12.0f %s\n", VERIFICATION_TLES[k].name, count,
+                   networkPasses, singlePasses, elapsedSingle * 1000.0, elapsedNetwork * 1000.0,
+                   elapsedSingle / elapsedNetwork, maxDiff, pass ? "ok" : "FALHOU");
+        }
+    }
+    return ok;
+}
+
+/// Observador da verificação do pré-filtro.
+struct FilterSite {
+    const char* name;
+    double lat;
+    double lon;
+};
+
+const FilterSite FILTER_SITES[] = {
+    {"Campinas",  -22.90,  -47.06},
+    {"Quito",      -0.18,  -78.47},
+    {"Tóquio",     35.68,  139.69},
+    {"Tromsø",     69.65,   18.96},
+    {"McMurdo",   -77.85,  166.67},
+};
+const int NUM_FILTER_SITES = sizeof(FILTER_SITES) / sizeof(FILTER_SITES[0]);
+
+constexpr double FILTER_MIN_ELEVATION = 10.0;
+constexpr int FILTER_SCAN_STEP_S      = 30;
+
+//
+// Pré-filtro: "nunca" não pode ter amostra acima do mínimo, "sempre" nenhuma abaixo
+//
+bool verifyPassFilter() {
+    bool ok = true;
+    const char* classNames[] = {"nunca", "candidato", "sempre"};
+    int pruned = 0;
+    int total = 0;
+
+    printf("\n== Pré-filtro geométrico (%lu dias, elevação >= %.0f°) ==\n", WINDOW_S / 86400UL, FILTER_MIN_ELEVATION);
+    printf("%-6s %-10s %-10s %10s %10s %14s\n", "TLE", "local", "classe", "el máx", "el mín", "generate (ms)");
+
+    PassPredictor predictor;
+    std::vector<PassData> passes;
+    const int count = static_cast<int>(WINDOW_S / FILTER_SCAN_STEP_S) + 1;
+    std::vector<double> el(count);
+
+    for (int k = 0; k < NUM_TLES; k++) {
+        for (int s = 0; s < NUM_FILTER_SITES; s++) {
+            const FilterSite& site = FILTER_SITES[s];
+            Sgp4Model model;
+            model.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+            model.site(site.lat, site.lon, SITE_ALT);
+            double jdStart = model.elements().jdsatepoch + 1.0;
+            double jdEnd = jdStart + WINDOW_S / 86400.0;
+            passclass filter = model.passfilter(jdStart, jdEnd, FILTER_MIN_ELEVATION);
+
+            // Referência: elevação a cada 30 s na janela inteira
+            Sgp4Context ctx;
+            model.initcontext(ctx);
+            model.timeline(ctx, jdStart, FILTER_SCAN_STEP_S / 86400.0, count, nullptr, el.data(), nullptr);
+            double maxEl = -90.0;
+            double minEl = 90.0;
+            for (double e : el) {
+                maxEl = fmax(maxEl, e);
+                minEl = fmin(minEl, e);
+            }
+
+            Sgp4 sat;
+            sat.site(site.lat, site.lon, SITE_ALT);
+            sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+            unsigned long start = static_cast<unsigned long>((jdStart - 2440587.5) * 86400.0);
+            double t0 = nowSeconds();
+            predictor.generate(sat, start, WINDOW_S, passes);
+            double elapsed = nowSeconds() - t0;
+
+            bool pass = (filter != passnever || maxEl < FILTER_MIN_ELEVATION) &&
+                        (filter != passalways || minEl >= FILTER_MIN_ELEVATION);
+            ok = ok && pass;
+            total++;
+            pruned += filter == passnever ? 1 : 0;
+            printf("%-6s %-10s %-10s %10.1f %10.1f %14.2f %s\n", VERIFICATION_TLES[k].name, site.name,
+                   classNames[filter], maxEl, minEl, elapsed * 1000.0, pass ? "ok" : "FALHOU");
+        }
+    }
+    printf("descartados: %d de %d\n", pruned, total);
+    return ok;
+}
+
+/// Passagem de referência da varredura de 1 s (elevação acima da máscara).
+struct MaskPass {
+    unsigned long aos;
+    unsigned long los;
+};
+
+//
+// Horizonte local: AOS/LOS de PassPredictor (nextpass com a máscara) e do PassScheduler
+// conferidos com uma varredura de 1 s da elevação acima da máscara
+//
+bool verifyHorizon() {
+    bool ok = true;
+    const int maskTles[] = {1, 2};
+    const double maskAz[] = {0.0, 60.0, 90.0, 150.0, 180.0, 270.0, 330.0};   // prédio a leste, morro a oeste
+    const double maskEl[] = {2.0, 5.0, 25.0, 25.0, 8.0, 15.0, 3.0};
+    horizonmask mask;
+    horizoninit(mask, maskAz, maskEl, sizeof(maskAz) / sizeof(maskAz[0]));
+    const double minElevation = 10.0;
+
+    printf("\n== Horizonte local (%lu dias, 10° acima da máscara de %.0f° a %.0f°) ==\n", WINDOW_S / 86400UL,
+           mask.minel * 180.0 / pi, mask.maxel * 180.0 / pi);
+    printf("%-6s %10s %16s %12s %16s %12s\n", "TLE", "varredura", "PassPredictor", "AOS/LOS (s)",
+           "PassScheduler", "AOS/LOS (s)");
+
+    for (int k : maskTles) {
+        Sgp4 sat;
+        sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+        sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        unsigned long start = static_cast<unsigned long>((sat.satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+
+        // Referência: trechos com elevação acima da máscara que sobem minElevation acima dela
+        std::vector<MaskPass> reference;
+        const int block = 3600;
+        std::vector<double> az(block), el(block);
+        bool above = false;
+        double best = -90.0;
+        MaskPass current = {0, 0};
+        for (unsigned long t0 = start; t0 < start + WINDOW_S + 7200; t0 += block) {
+            sat.timeline(t0, 1UL, block, az.data(), el.data(), nullptr);
+            for (int i = 0; i < block; i++) {
+                double rel = el[i] - horizonelevation(mask, az[i] * pi / 180.0) * 180.0 / pi;
+                if (rel >= 0.0 && !above) {
+                    above = true;
+                    best = rel;
+                    current.aos = t0 + i;
+                } else if (rel >= 0.0) {
+                    best = fmax(best, rel);
+                } else if (above) {
+                    above = false;
+                    current.los = t0 + i - 1;
+                    if (best >= minElevation && current.aos > start && current.aos <= start + WINDOW_S) {
+                        reference.push_back(current);
+                    }
+                }
+            }
+        }
+
+        // Quantas referências têm par (AOS a menos de 120 s) e a maior diferença de AOS/LOS
+        auto compare = [&](const std::vector<MaskPass>& found, int& matched, double& maxDiff) {
+            matched = 0;
+            maxDiff = 0.0;
+            for (const MaskPass& r : reference) {
+                for (const MaskPass& f : found) {
+                    if (f.aos + 120 > r.aos && f.aos < r.aos + 120) {
+                        matched++;
+                        maxDiff = fmax(maxDiff, fabs(static_cast<double>(f.aos) - r.aos));
+                        maxDiff = fmax(maxDiff, fabs(static_cast<double>(f.los) - r.los));
+                        break;
+                    }
+                }
+            }
+        };
+
+        PassPredictor predictor;
+        predictor.setMinElevation(minElevation);
+        sat.sethorizon(&mask);
+        std::vector<PassData> passes;
+        predictor.generate(sat, start, WINDOW_S, passes);
+        std::vector<MaskPass> predicted;
+        for (const PassData& p : passes) {
+            if (p.startPassUnix > start) {
+                predicted.push_back({p.startPassUnix, p.endPassUnix});
+            }
+        }
+
+        PassScheduler scheduler;
+        scheduler.setSite(SITE_LAT, SITE_LON, SITE_ALT);
+        scheduler.setMinElevation(minElevation);
+        scheduler.setHorizon(&mask);
+        scheduler.addSatellite(static_cast<uint16_t>(k), sat.satrec, start, WINDOW_S);
+        scheduler.finish();
+        std::vector<MaskPass> scheduled;
+        for (const ScheduledPass& q : scheduler.timeline()) {
+            if (q.aos > start) {
+                scheduled.push_back({q.aos, q.los});
+            }
+        }
+
+        int matchedPredicted, matchedScheduled;
+        double diffPredicted, diffScheduled;
+        compare(predicted, matchedPredicted, diffPredicted);
+        compare(scheduled, matchedScheduled, diffScheduled);
+
+        int n = static_cast<int>(reference.size());
+        bool pass = matchedPredicted == n && static_cast<int>(predicted.size()) == n && diffPredicted <= 2.0 &&
+                    matchedScheduled == n && static_cast<int>(scheduled.size()) == n && diffScheduled <= 2.0;
+        ok = ok && pass;
+        printf("%-6s %10d %9d (%3d) %12.0f %9d (%3d) %12.0f %s\n", VERIFICATION_TLES[k].name, n,
+               static_cast<int>(predicted.size()), matchedPredicted, diffPredicted,
+               static_cast<int>(scheduled.size()), matchedScheduled, diffScheduled, pass ? "ok" : "FALHOU");
+    }
+    return ok;
+}
+
+//
+// Iluminação: o Sol do cache (sunlook) contra sun() e rv2azel() a cada amostra, e a
+// classificação de cada ponto das trajetórias contra o cálculo direto com o Sol exato
+//
+bool verifyIllumination() {
+    bool ok = true;
+    printf("\n== Iluminação (cache do Sol em blocos de %.0f min) ==\n", SUN_BUCKET);
+
+    Sgp4 site;
+    site.site(SITE_LAT, SITE_LON, SITE_ALT);
+    site.init(VERIFICATION_TLES[2].name, VERIFICATION_TLES[2].line1, VERIFICATION_TLES[2].line2);
+    const ObserverFrame& frame = site.observerframe();
+    double jdStart = site.satrec.jdsatepoch + 1.0;
+
+    // Direção do Sol em 24 h, passo de 10 s
+    suncache cache;
+    suncacheclear(cache);
+    double maxVector = 0.0;
+    double maxAngle = 0.0;
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double jd = jdStart + i * SWEEP_STEP_S / 86400.0;
+        double exact[3], razel[3], rsun[3], az, el;
+        sun(jd, exact);
+        rv2azel(exact, frame, jd, razel);
+        sunlook(cache, frame, jd, rsun, &az, &el);
+        maxVector = fmax(maxVector, acos(fmin(1.0, dot(exact, rsun) / mag(exact) / mag(rsun))) * 180.0 / pi);
+        double dAz = fabs(az - razel[1]);
+        dAz = fmin(dAz, 2.0 * pi - dAz) * cos(razel[2]);
+        double dEl = el - razel[2];
+        maxAngle = fmax(maxAngle, sqrt(dAz * dAz + dEl * dEl) * 180.0 / pi);
+    }
+    bool cacheOk = maxVector < 1e-4 && maxAngle < 0.01;   // precisão de sun()
+    ok = ok && cacheOk;
+    printf("erro máximo do Sol interpolado: vetor %.2e°, az/el %.2e° %s\n", maxVector, maxAngle,
+           cacheOk ? "ok" : "FALHOU");
+
+    // Custo por amostra: Sol exato (sun() + rv2azel()) contra o cache, com a sombra nos dois
+    const int samples = 200000;
+    double rsat[3] = {7000.0, 0.0, 0.0};
+    double t0 = nowSeconds();
+    long direct = 0;
+    for (int i = 0; i < samples; i++) {
+        double jd = jdStart + i * 1.0 / 86400.0;
+        double rsun[3], razel[3];
+        sun(jd, rsun);
+        rv2azel(rsun, frame, jd, razel);
+        direct += illumination(rsat, rsun, razel[2], SUN_DARK_ELEVATION * pi / 180.0) == lighted;
+    }
+    double directS = nowSeconds() - t0;
+    suncacheclear(cache);
+    t0 = nowSeconds();
+    long cached = 0;
+    for (int i = 0; i < samples; i++) {
+        double jd = jdStart + i * 1.0 / 86400.0;
+        double rsun[3], el;
+        sunlook(cache, frame, jd, rsun, nullptr, &el);
+        cached += illumination(rsat, rsun, el, SUN_DARK_ELEVATION * pi / 180.0) == lighted;
+    }
+    double cachedS = nowSeconds() - t0;
+    printf("classificação por amostra: %.3f µs direto, %.3f µs com o cache (%.1fx), iluminadas %ld / %ld\n",
+           directS * 1e6 / samples, cachedS * 1e6 / samples, directS / cachedS, direct, cached);
+
+    // Trajetórias: cada ponto da grade de 10 s contra o Sol exato e o estado do Sgp4Model
+    printf("%-6s %9s %8s %8s %9s %9s %12s\n", "TLE", "passagens", "dia", "sombra", "visíveis", "pontos",
+           "divergentes");
+    PassPredictor predictor;
+    std::vector<PassData> passes;
+    for (int k = 0; k < 3; k++) {
+        Sgp4 sat;
+        sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+        sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        unsigned long start = static_cast<unsigned long>((sat.satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+        predictor.generate(sat, start, WINDOW_S, passes);
+
+        Sgp4Model model;
+        model.site(SITE_LAT, SITE_LON, SITE_ALT);
+        model.init(VERIFICATION_TLES[k].name, sat.satrec);
+        Sgp4Context ctx;
+        model.initcontext(ctx);
+
+        int count[3] = {0, 0, 0};
+        long points = 0;
+        long wrong = 0;
+        for (const PassData& pass : passes) {
+            int sight = sgp4daylight;
+            for (unsigned long t = pass.startPassUnix; t <= pass.endPassUnix; t += 10) {
+                double jd = 2440587.5 + t / 86400.0;
+                double rsun[3], razel[3];
+                model.state(ctx, jd);
+                sun(jd, rsun);
+                rv2azel(rsun, model.observerframe(), jd, razel);
+                visibletype expected = illumination(ctx.ro, rsun, razel[2], SUN_DARK_ELEVATION * pi / 180.0);
+                sight = expected > sight ? expected : sight;
+                points++;
+                if (pass.path.light(t) != expected) {
+                    wrong++;
+                }
+            }
+            count[sight]++;
+            if (pass.path.visible() != (sight == lighted)) {
+                wrong++;
+            }
+        }
+        bool pass = wrong == 0 && count[lighted] == predictor.lastStats().visible;
+        ok = ok && pass;
+        printf("%-6s %9d %8d %8d %9d %9ld %12ld %s\n", VERIFICATION_TLES[k].name, static_cast<int>(passes.size()),
+               count[sgp4daylight], count[eclipsed], count[lighted], points, wrong, pass ? "ok" : "FALHOU");
+    }
+    return ok;
+}
+
+//
+// Cópia de um TLE com nodo ascendente e anomalia média trocados (colunas 18-25 e 44-51)
+//
+void shiftedTle(const BenchTle& tle, double raan, double meanAnomaly, elsetrec& satrec,
+                gravconsttype whichconst = wgs72) {
+    char line1[130];
+    char line2[130];
+    char field[16];
+    strncpy(line1, tle.line1, sizeof(line1) - 1);
+    line1[sizeof(line1) - 1] = '\0';
+    strncpy(line2, tle.line2, sizeof(line2) - 1);
+    line2[sizeof(line2) - 1] = '\0';
+    snprintf(field, sizeof(field), "%8.4f", raan);
+    memcpy(line2 + 17, field, 8);
+    snprintf(field, sizeof(field), "%8.4f", meanAnomaly);
+    memcpy(line2 + 43, field, 8);
+    twoline2rv(line1, line2, 'i', whichconst, satrec);
+}
+
+//
+// Grupo inteiro: tempo e propagações por satélite; AOS/LOS contra PassPredictor
+//
+bool benchSchedule() {
+    bool ok = true;
+    const int groupTles[] = {1, 2};
+
+    elsetrec satrec;
+    parseTle(VERIFICATION_TLES[1], wgs72, satrec);
+    unsigned long start = static_cast<unsigned long>((satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+
+    // Conferência com a previsão por satélite (mesmos TLEs, 3 dias)
+    printf("\n== Grupo: conferência com PassPredictor (%lu dias, elevação >= 10°) ==\n", WINDOW_S / 86400UL);
+    printf("%-6s %10s %12s %12s %10s\n", "TLE", "passagens", "sem par", "AOS/LOS (s)", "visíveis");
+    PassPredictor predictor;
+    std::vector<PassData> reference;
+    for (int k : groupTles) {
+        PassScheduler scheduler;
+        scheduler.setSite(SITE_LAT, SITE_LON, SITE_ALT);
+        parseTle(VERIFICATION_TLES[k], wgs72, satrec);
+        scheduler.addSatellite(static_cast<uint16_t>(k), satrec, start, WINDOW_S);
+        scheduler.finish();
+
+        Sgp4 sat;
+        sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+        sat.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        predictor.generate(sat, start, WINDOW_S, reference);
+
+        int compared = 0;
+        int unmatched = 0;
+        int visible = 0;
+        int visibleReference = 0;
+        double maxDiff = 0.0;
+        for (const PassData& p : reference) {
+            if (p.startPassUnix <= start || p.startPassUnix > start + WINDOW_S) {
+                continue;
+            }
+            compared++;
+            const ScheduledPass* match = nullptr;
+            for (const ScheduledPass& q : scheduler.timeline()) {
+                if (q.aos + 120 > p.startPassUnix && q.aos < p.startPassUnix + 120) {
+                    match = &q;
+                }
+            }
+            if (match == nullptr) {
+                unmatched++;
+                continue;
+            }
+            maxDiff = fmax(maxDiff, fabs(static_cast<double>(match->aos) - p.startPassUnix));
+            maxDiff = fmax(maxDiff, fabs(static_cast<double>(match->los) - p.endPassUnix));
+            visible += match->sight == lighted;
+            visibleReference += p.path.visible();
+        }
+        int scheduled = 0;
+        for (const ScheduledPass& q : scheduler.timeline()) {
+            if (q.aos > start) {
+                scheduled++;
+            }
+        }
+
+        bool pass = unmatched == 0 && scheduled == compared && maxDiff <= 2.0;
+        ok = ok && pass;
+        printf("%-6s %4d / %-4d %12d %12.0f %4d / %-4d %s\n", VERIFICATION_TLES[k].name, scheduled, compared,
+               unmatched, maxDiff, visible, visibleReference, pass ? "ok" : "FALHOU");
+    }
+
+    // Grupo sintético de centenas de satélites
+    PassScheduler scheduler;
+    scheduler.setSite(SITE_LAT, SITE_LON, SITE_ALT);
+    double t0 = nowSeconds();
+    uint16_t index = 0;
+    for (int k : groupTles) {
+        for (int c = 0; c < GROUP_COPIES; c++) {
+            shiftedTle(VERIFICATION_TLES[k], 360.0 * c / GROUP_COPIES, fmod(137.5 * c, 360.0), satrec);
+            scheduler.addSatellite(index++, satrec, start, GROUP_WINDOW_S);
+        }
+    }
+    scheduler.finish();
+    double elapsed = nowSeconds() - t0;
+
+    const ScheduleStats& stats = scheduler.lastStats();
+    printf("\n== Grupo: %d satélites, %lu h, elevação >= 10° ==\n", stats.satellites, GROUP_WINDOW_S / 3600UL);
+    printf("passagens %d (%d visíveis a olho nu), falhas %d, tempo %.1f ms (%.3f ms/satélite), %.0f propagações/satélite\n",
+           stats.passes, stats.visible, stats.failed, elapsed * 1000.0, elapsed * 1000.0 / stats.satellites,
+           static_cast<double>(stats.evaluations) / stats.satellites);
+
+    std::vector<ScheduledPass> next;
+    scheduler.nextPasses(start + GROUP_WINDOW_S / 2, 5, next);
+    bool sorted = true;
+    for (size_t i = 1; i < scheduler.timeline().size(); i++) {
+        sorted = sorted && scheduler.timeline()[i - 1].aos <= scheduler.timeline()[i].aos;
+    }
+    std::vector<ScheduledPass> visibleNext;
+    scheduler.nextPasses(start, static_cast<int>(scheduler.timeline().size()), visibleNext, true);
+    bool filtered = static_cast<int>(visibleNext.size()) == stats.visible;
+    for (const ScheduledPass& p : visibleNext) {
+        filtered = filtered && p.sight == lighted;
+    }
+    printf("filtro de passagens visíveis: %d %s\n", static_cast<int>(visibleNext.size()), filtered ? "ok" : "FALHOU");
+    ok = ok && sorted && filtered && stats.failed == 0 && next.size() == 5;
+    printf("próximas passagens a partir de +12 h:\n");
+    for (const ScheduledPass& p : next) {
+        printf("  sat %3u  AOS %+7ld s  TCA %+7ld s  LOS %+7ld s  max %5.1f°\n", p.satellite,
+               static_cast<long>(p.aos - start), static_cast<long>(p.tca - start),
+               static_cast<long>(p.los - start), p.maxElevation);
+    }
+    return ok;
+}
+
+
+//
+// Referência da triagem: todos os pares a cada passo, com o mesmo critério de intervalo
+// (distância decrescente e depois crescente) e o limite de velocidade de escape, TCA por
+// seção áurea com sgp4()
+//
+struct ReferenceConjunction {
+    int first;
+    int second;
+    double tca;        // s desde o início
+    double distance;   // km
+};
+
+double pairDistance(std::vector<elsetrec>& sats, int a, int b, double minutes) {
+    double ra[3], va[3], rb[3], vb[3];
+    sgp4(wgs84, sats[a], minutes - (sats[a].jdsatepoch - sats[0].jdsatepoch) * 1440.0, ra, va);
+    sgp4(wgs84, sats[b], minutes - (sats[b].jdsatepoch - sats[0].jdsatepoch) * 1440.0, rb, vb);
+    return distance(ra, rb);
+}
+
+void referenceConjunctions(std::vector<elsetrec> sats, double startMinutes, unsigned long duration,
+                           std::vector<ReferenceConjunction>& out) {
+    const int n = static_cast<int>(sats.size());
+    std::vector<double> rPrev(n * 3), vPrev(n * 3), rCur(n * 3), vCur(n * 3);
+    out.clear();
+    for (unsigned long t = 0; t <= duration; t += CONJUNCTION_STEP_S) {
+        for (int i = 0; i < n; i++) {
+            double tsince = startMinutes + t / 60.0 - (sats[i].jdsatepoch - sats[0].jdsatepoch) * 1440.0;
+            sgp4(wgs84, sats[i], tsince, &rCur[i * 3], &vCur[i * 3]);
+        }
+        if (t > 0) {
+            for (int a = 0; a < n; a++) {
+                for (int b = a + 1; b < n; b++) {
+                    double dr0[3], dv0[3], dr1[3], dv1[3];
+                    for (int k = 0; k < 3; k++) {
+                        dr0[k] = rPrev[b * 3 + k] - rPrev[a * 3 + k];
+                        dv0[k] = vPrev[b * 3 + k] - vPrev[a * 3 + k];
+                        dr1[k] = rCur[b * 3 + k] - rCur[a * 3 + k];
+                        dv1[k] = vCur[b * 3 + k] - vCur[a * 3 + k];
+                    }
+                    if (dr0[0] * dv0[0] + dr0[1] * dv0[1] + dr0[2] * dv0[2] >= 0.0 ||
+                        dr1[0] * dv1[0] + dr1[1] * dv1[1] + dr1[2] * dv1[2] < 0.0) {
+                        continue;
+                    }
+                    double d0 = sqrt(dr0[0] * dr0[0] + dr0[1] * dr0[1] + dr0[2] * dr0[2]);
+                    double d1 = sqrt(dr1[0] * dr1[0] + dr1[1] * dr1[1] + dr1[2] * dr1[2]);
+                    if ((d0 + d1 - 2.0 * ESCAPE_SPEED_KMS * CONJUNCTION_STEP_S) / 2.0 >= CONJUNCTION_KM) {
+                        continue;
+                    }
+                    // Seção áurea em minutos, até 1 ms
+                    double lo = startMinutes + (t - CONJUNCTION_STEP_S) / 60.0;
+                    double hi = startMinutes + t / 60.0;
+                    const double g = 0.6180339887498949;
+                    double c = hi - g * (hi - lo);
+                    double d = lo + g * (hi - lo);
+                    double fc = pairDistance(sats, a, b, c);
+                    double fd = pairDistance(sats, a, b, d);
+                    while (hi - lo > 0.001 / 60.0) {
+                        if (fc < fd) {
+                            hi = d; d = c; fd = fc;
+                            c = hi - g * (hi - lo);
+                            fc = pairDistance(sats, a, b, c);
+                        } else {
+                            lo = c; c = d; fc = fd;
+                            d = lo + g * (hi - lo);
+                            fd = pairDistance(sats, a, b, d);
+                        }
+                    }
+                    double tca = (lo + hi) / 2.0;
+                    double dmin = pairDistance(sats, a, b, tca);
+                    if (dmin < CONJUNCTION_KM) {
+                        ReferenceConjunction r = { a, b, (tca - startMinutes) * 60.0, dmin };
+                        out.push_back(r);
+                    }
+                }
+            }
+        }
+        rPrev.swap(rCur);
+        vPrev.swap(vCur);
+    }
+}
+
+//
+// Triagem de aproximações (ConjunctionScreener) contra a referência de todos os pares
+//
+bool verifyConjunctions() {
+    // Grupo sintético de benchSchedule() e os TLEs de período longo (deep space) e excêntricos
+    std::vector<elsetrec> sats;
+    elsetrec satrec;
+    for (int k : {1, 2}) {
+        for (int c = 0; c < GROUP_COPIES; c++) {
+            shiftedTle(VERIFICATION_TLES[k], 360.0 * c / GROUP_COPIES, fmod(137.5 * c, 360.0), satrec, wgs84);
+            sats.push_back(satrec);
+        }
+    }
+    for (int k : {0, 3, 4}) {
+        parseTle(VERIFICATION_TLES[k], wgs84, satrec);
+        sats.push_back(satrec);
+    }
+    const int n = static_cast<int>(sats.size());
+
+    parseTle(VERIFICATION_TLES[1], wgs84, satrec);
+    unsigned long start = static_cast<unsigned long>((satrec.jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+    double startMinutes = ((2440587.5 + start / 86400.0) - sats[0].jdsatepoch) * 1440.0;
+
+    double t0 = nowSeconds();
+    ConjunctionScreener screener;
+    screener.setThreshold(CONJUNCTION_KM);
+    screener.setStep(CONJUNCTION_STEP_S);
+    for (int i = 0; i < n; i++) {
+        screener.addSatellite(static_cast<uint16_t>(i), sats[i]);
+    }
+    screener.screen(start, GROUP_WINDOW_S);
+    double screenTime = nowSeconds() - t0;
+    const ConjunctionStats& stats = screener.lastStats();
+
+    std::vector<ReferenceConjunction> reference;
+    t0 = nowSeconds();
+    referenceConjunctions(sats, startMinutes, GROUP_WINDOW_S, reference);
+    double referenceTime = nowSeconds() - t0;
+
+    // Cada aproximação da referência deve estar no resultado (mesmo par, TCA e distância)
+    int unmatched = 0;
+    double maxTca = 0.0;
+    double maxDistance = 0.0;
+    for (const ReferenceConjunction& r : reference) {
+        const Conjunction* match = nullptr;
+        for (const Conjunction& c : screener.results()) {
+            double dt = fabs(static_cast<double>(c.tca - start) - r.tca);
+            if (c.first == r.first && c.second == r.second && dt <= 1.0) {
+                match = &c;
+                break;
+            }
+        }
+        if (match == nullptr) {
+            unmatched++;
+            continue;
+        }
+        maxTca = fmax(maxTca, fabs(static_cast<double>(match->tca - start) - r.tca));
+        maxDistance = fmax(maxDistance, fabs(match->distance - r.distance));
+    }
+
+    // A triagem em etapas de 1 ms (begin()/run(), como em updateConjunctions()) deve dar o mesmo resultado
+    ConjunctionScreener sliced;
+    sliced.setThreshold(CONJUNCTION_KM);
+    sliced.setStep(CONJUNCTION_STEP_S);
+    for (int i = 0; i < n; i++) {
+        sliced.addSatellite(static_cast<uint16_t>(i), sats[i]);
+    }
+    int calls = 0;
+    bool same = sliced.begin(start, GROUP_WINDOW_S);
+    float lastProgress = 0.0f;
+    while (same && !sliced.run(1000)) {
+        same = sliced.progress() >= lastProgress && sliced.progress() < 1.0f;
+        lastProgress = sliced.progress();
+        calls++;
+    }
+    same = same && sliced.progress() == 1.0f && sliced.results().size() == screener.results().size() &&
+           sliced.lastStats().evaluations == stats.evaluations;
+    for (size_t i = 0; same && i < sliced.results().size(); i++) {
+        const Conjunction& a = sliced.results()[i];
+        const Conjunction& b = screener.results()[i];
+        same = a.first == b.first && a.second == b.second && a.tca == b.tca && a.distance == b.distance;
+    }
+
+    bool pass = unmatched == 0 && stats.conjunctions == static_cast<int>(reference.size()) &&
+                !reference.empty() && maxDistance < 0.01 && stats.failed == 0 && same;
+    printf("\n== Aproximações: %d satélites, %lu h, limite %.0f km, passo %lu s ==\n", n,
+           GROUP_WINDOW_S / 3600UL, CONJUNCTION_KM, CONJUNCTION_STEP_S);
+    printf("pares %ld, cascas sobrepostas %ld (%d satélites isolados), distâncias na grade %.0f/passo, intervalos refinados %ld\n",
+           stats.pairs, stats.shellPairs, stats.isolated,
+           static_cast<double>(stats.checks) / (GROUP_WINDOW_S / CONJUNCTION_STEP_S + 1), stats.candidates);
+    printf("aproximações %d (referência %zu, sem par %d), TCA %.2f s, distância %.4f km %s\n",
+           stats.conjunctions, reference.size(), unmatched, maxTca, maxDistance, pass ? "ok" : "FALHOU");
+    printf("tempo %.1f ms (%.0f propagações), referência com todos os pares %.1f ms (%.1fx)\n",
+           screenTime * 1000.0, static_cast<double>(stats.evaluations), referenceTime * 1000.0,
+           referenceTime / screenTime);
+    printf("em etapas de 1 ms: %d chamadas a run(), mesmo resultado %s\n", calls + 1, same ? "ok" : "FALHOU");
+    for (size_t i = 0; i < screener.results().size() && i < 3; i++) {
+        const Conjunction& c = screener.results()[i];
+        printf("  sat %3u x %3u  TCA %+7ld s  %6.3f km  %5.2f km/s\n", c.first, c.second,
+               static_cast<long>(c.tca - start), c.distance, c.speed);
+    }
+    return pass;
+}
+
+//
+// Traço no solo: desvio máximo do traço decimado contra todas as amostras de findsat(),
+// continuidade dos trechos cortados na linha de data e raio da área de visibilidade
+//
+double polylineDistance(double lat, double lon, const TrackPoint* v, size_t count) {
+    double best = 1e9;
+    for (size_t i = 0; i + 1 < count; i++) {
+        double dx = v[i + 1].lon - v[i].lon;
+        double dy = v[i + 1].lat - v[i].lat;
+        double px = lon - v[i].lon;
+        double py = lat - v[i].lat;
+        double t = dx * dx + dy * dy > 0.0 ? (px * dx + py * dy) / (dx * dx + dy * dy) : 0.0;
+        t = fmin(1.0, fmax(0.0, t));
+        best = fmin(best, hypot(px - t * dx, py - t * dy));
+    }
+    return best;
+}
+
+bool verifyGroundTrack() {
+    bool ok = true;
+    printf("\n== Traço no solo (%.0f órbitas, passo %lu s, tolerância %.2f°) ==\n", TRACK_ORBITS, TRACK_STEP_S,
+           TRACK_TOLERANCE);
+    printf("%-6s %8s %9s %9s %8s %10s %9s %9s\n", "TLE", "amostras", "vértices", "v/órbita", "trechos",
+           "desvio(°)", "saltos", "tempo(ms)");
+
+    GroundTrack track;
+    track.setStep(TRACK_STEP_S);
+    track.setTolerance(TRACK_TOLERANCE);
+    for (int k = 0; k < 5; k++) {
+        Sgp4Model model;
+        model.site(SITE_LAT, SITE_LON, SITE_ALT);
+        model.init(VERIFICATION_TLES[k].name, VERIFICATION_TLES[k].line1, VERIFICATION_TLES[k].line2);
+        unsigned long start =
+            static_cast<unsigned long>((model.elements().jdsatepoch + 1.0 - 2440587.5) * 86400.0);
+
+        double t0 = nowSeconds();
+        track.generate(model, start, TRACK_ORBITS);
+        double trackTime = nowSeconds() - t0;
+        const TrackStats& stats = track.lastStats();
+        const std::vector<TrackPoint>& points = track.points();
+        const std::vector<uint32_t>& starts = track.segments();
+
+        // Trechos: nenhum salto de longitude acima de 180° dentro de um trecho, e cada corte
+        // termina e recomeça na borda do mapa
+        int jumps = 0;
+        for (size_t s = 0; s < starts.size(); s++) {
+            size_t end = s + 1 < starts.size() ? starts[s + 1] : points.size();
+            for (size_t i = starts[s] + 1; i < end; i++) {
+                jumps += fabsf(points[i].lon - points[i - 1].lon) > 180.0f;
+            }
+            if (s > 0 && (fabsf(points[starts[s]].lon) != 180.0f || fabsf(points[starts[s] - 1].lon) != 180.0f)) {
+                jumps++;
+            }
+        }
+
+        // Amostras completas por findsat(), cortadas pela mesma regra, contra o trecho correspondente
+        double period = 2.0 * pi / model.elements().no * 60.0;
+        long count = static_cast<long>(TRACK_ORBITS * period / TRACK_STEP_S) + 1;
+        double jdStart = 2440587.5 + start / 86400.0;
+        Sgp4Context ctx;
+        model.initcontext(ctx);
+        size_t segment = 0;
+        double lastLon = 0.0;
+        double deviation = 0.0;
+        for (long i = 0; i < count && segment < starts.size(); i++) {
+            model.findsat(ctx, jdStart + i * static_cast<double>(TRACK_STEP_S) / 86400.0, findgeodetic);
+            if (i > 0 && fabs(ctx.satLon - lastLon) > 180.0) {
+                segment++;
+                if (segment >= starts.size()) {
+                    deviation = 1e9;
+                    break;
+                }
+            }
+            lastLon = ctx.satLon;
+            size_t end = segment + 1 < starts.size() ? starts[segment + 1] : points.size();
+            deviation = fmax(deviation, polylineDistance(ctx.satLat, ctx.satLon, &points[starts[segment]],
+                                                         end - starts[segment]));
+        }
+        bool pass = jumps == 0 && stats.failed == 0 && stats.samples == count && segment + 1 == starts.size() &&
+                    deviation <= TRACK_TOLERANCE + 1e-4;
+        ok = ok && pass;
+        printf("%-6s %8d %9d %9.1f %8d %10.4f %9d %9.2f %s\n", VERIFICATION_TLES[k].name, stats.samples,
+               stats.vertices, stats.vertices / TRACK_ORBITS, stats.segments, deviation, jumps, trackTime * 1000.0,
+               pass ? "ok" : "FALHOU");
+    }
+
+    // Área de visibilidade: na borda, o satélite deve ser visto exatamente na elevação mínima
+    double maxError = 0.0;
+    for (double altitude : {400.0, 800.0, 1400.0, 20200.0, 35786.0}) {
+        for (double elevation : {0.0, 5.0, 10.0, 30.0}) {
+            double lambda = GroundTrack::footprintRadius(altitude, elevation) * pi / 180.0;
+            double ratio = 6378.135 / (6378.135 + altitude);
+            double seen = atan2(cos(lambda) - ratio, sin(lambda)) * 180.0 / pi;
+            maxError = fmax(maxError, fabs(seen - elevation));
+        }
+    }
+    bool footprintOk = maxError < 1e-9;
+    ok = ok && footprintOk;
+    printf("área de visibilidade: raio %.0f km a 420 km (0°), %.0f km (10°); erro de elevação na borda %.1e° %s\n",
+           GroundTrack::footprintRadius(420.0) * pi / 180.0 * 6378.135,
+           GroundTrack::footprintRadius(420.0, 10.0) * pi / 180.0 * 6378.135, maxError, footprintOk ? "ok" : "FALHOU");
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = verify();
+    ok = verifySweep() && ok;
+    ok = benchPropagation() && ok;
+    benchSweep();
+    ok = benchPasses() && ok;
+    ok = benchPath() && ok;
+    ok = benchService() && ok;
+    ok = benchNetwork() && ok;
+    ok = verifyPassFilter() && ok;
+    ok = verifyHorizon() && ok;
+    ok = verifyIllumination() && ok;
+    ok = benchSchedule() && ok;
+    ok = verifyConjunctions() && ok;
+    ok = verifyGroundTrack() && ok;
+
+    printf("\nVerificação: %s\n", ok ? "ok" : "FALHOU");
+    return ok ? 0 : 1;
+}
@@ -27,5 +27,60 @@
 #define GPS_TX_PIN 17
 #define GPS_BAUD   9600
 
+// ================================
+// Definições para a previsão SGP4
+// ================================
+// 1 = usa o modelo SGP4 em precisão simples (float) para satélites próximos da Terra.
+// Erro típico de poucas dezenas de metros em 24h, conferido pelo benchmark nativo (limite de 50 m
+// e 0,01° em az/el). Desligado até haver a medida de tempo no ESP32 (examples/Sgp4FloatBench).
+#define SGP4_SINGLE_PRECISION 0
+
+// Frequência de downlink (Hz) usada no Doppler de cada ponto das passagens (0 = não calcula).
+// 137.1 MHz = APT do NOAA 19.
+#define DOWNLINK_FREQUENCY_HZ 137.1e6
+
+// Tempo máximo (µs) de cada etapa da busca de passagens na tarefa de previsão: entre etapas a
+// tarefa verifica o cancelamento (botão BACK) e cede o núcleo.
+#define PASS_STEP_BUDGET_US 20000
+
+// Tarefa de previsão de passagens (PassService): núcleo (o loop() do Arduino roda no núcleo 1),
+// pilha em bytes e prioridade FreeRTOS.
+#define PASS_SERVICE_CORE     0
+#define PASS_SERVICE_STACK    8192
+#define PASS_SERVICE_PRIORITY 1
+
+// Previsão do grupo inteiro (menu NEXT PASSES): janela em segundos e elevação mínima (graus).
+// A linha do tempo é recalculada quando passa da metade da janela ou quando o grupo muda.
+#define GROUP_PASS_HORIZON_S     86400
+#define GROUP_PASS_MIN_ELEVATION 10.0
+
+// Tempo máximo (µs) de cada etapa da previsão do grupo (alguns satélites por etapa): entre etapas
+// a tela de progresso, o GPS e as notificações são atualizados e o botão BACK cancela a previsão.
+#define GROUP_PASS_STEP_BUDGET_US 20000
+
+// 1 lista no menu NEXT PASSES só as passagens visíveis a olho nu (satélite iluminado com o
+// céu escuro); 0 lista todas e marca as visíveis com "*".
+#define GROUP_PASS_VISIBLE_ONLY  0
+
+// Triagem de aproximações entre satélites do grupo (menu CLOSE APPROACHES): distância limite (km),
+// janela e passo da varredura em segundos. Passos maiores propagam menos, mas refinam mais pares.
+#define CONJUNCTION_THRESHOLD_KM 10.0
+#define CONJUNCTION_WINDOW_S     86400
+#define CONJUNCTION_STEP_S       60
+
+// Tempo máximo (µs) de cada etapa da triagem de aproximações: entre etapas a tela de progresso,
+// o GPS e as notificações são atualizados e o botão BACK cancela a triagem.
+#define CONJUNCTION_STEP_BUDGET_US 20000
+
+// Traço no solo (menu GROUND TRACK): órbitas desenhadas a partir de agora, passo da amostragem (s)
+// e tolerância da decimação em graus (0,25° fica abaixo de um pixel no mapa de 228 x 114).
+#define GROUND_TRACK_ORBITS        3.0
+#define GROUND_TRACK_STEP_S        10
+#define GROUND_TRACK_TOLERANCE_DEG 0.25
+
+// Horizonte local (prédios, morros) por azimute, ver HorizonMask.h. Sem o arquivo, ou sem
+// seção para o local, as passagens usam o horizonte plano.
+#define HORIZON_MASK_FILE "/horizon.txt"
+
 #endif // CONFIG_H
                                                     
\ No newline at end of file
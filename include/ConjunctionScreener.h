@@ -0,0 +1,179 @@
+#ifndef CONJUNCTION_SCREENER_H
+#define CONJUNCTION_SCREENER_H
+
+#include <Sgp4.h>
+#include <sgp4batch.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Aproximação entre dois satélites do grupo (mínimo local da distância).
+ */
+struct Conjunction {
+    uint16_t first;          ///< Índice do primeiro satélite no grupo (mesma ordem de getSatellite())
+    uint16_t second;         ///< Índice do segundo satélite (second > first)
+    unsigned long tca;       ///< Instante da menor distância (Unix Time)
+    float distance;          ///< Menor distância (km)
+    float speed;             ///< Velocidade relativa no TCA (km/s)
+};
+
+/**
+ * @brief Contadores da última triagem.
+ */
+struct ConjunctionStats {
+    int satellites;         ///< Satélites adicionados
+    int failed;             ///< Satélites com elementos inválidos ou erro de propagação na janela
+    int isolated;           ///< Satélites sem nenhuma casca de perigeu/apogeu em comum com outro
+    long pairs;             ///< Pares possíveis (N(N-1)/2)
+    long shellPairs;        ///< Pares com cascas sobrepostas (sort-and-sweep)
+    long checks;            ///< Distâncias calculadas na grade espacial, somando os passos
+    long candidates;        ///< Intervalos refinados por brentmin()
+    int conjunctions;       ///< Aproximações abaixo da distância limite
+    long evaluations;       ///< Propagações SGP4 no total
+};
+
+/**
+ * @brief Triagem de aproximações entre os satélites de um grupo em uma janela de tempo.
+ *
+ * Em vez de propagar os N(N-1)/2 pares, cada satélite é propagado uma vez por passo
+ * (Sgp4Batch). Os pares são podados em duas etapas: um sort-and-sweep das cascas de
+ * perigeu/apogeu, feito uma vez por triagem, e uma grade espacial ordenada por célula
+ * a cada passo. Só é medida a distância de pares que estão em células vizinhas e têm
+ * cascas sobrepostas.
+ *
+ * Um par entra na lista do passo quando está a menos de limite + (v1 + v2) * passo / 2 (as
+ * velocidades são limitadas pela velocidade no perigeu); assim nenhuma aproximação abaixo do
+ * limite escapa entre duas amostras. Entre amostras consecutivas em que a distância passa de
+ * decrescente a crescente, o TCA é refinado por brentmin() com as duas propagações do par.
+ * Sem display nem Serial, para rodar também no ambiente nativo (bench/native).
+ */
+class ConjunctionScreener {
+public:
+    /// Construtor padrão (limite de 10 km, passo de 60 s).
+    ConjunctionScreener();
+
+    /// Distância limite (km) para que uma aproximação entre no resultado.
+    void setThreshold(double km) { threshold = km; }
+
+    /// Passo da varredura (s); passos maiores aumentam o raio de busca da grade.
+    void setStep(unsigned long seconds) { step = seconds > 0 ? seconds : 1; }
+
+    /// Descarta os satélites, as aproximações e os contadores.
+    void clear();
+
+    /**
+     * @brief Acrescenta um satélite ao grupo.
+     *
+     * @param index Índice do satélite no grupo (devolvido em Conjunction).
+     * @param satrec Elementos já inicializados (twoline2rv ou ElementCache).
+     * @return false se os elementos são inválidos (o satélite é ignorado).
+     */
+    bool addSatellite(uint16_t index, const elsetrec& satrec);
+
+    /**
+     * @brief Procura as aproximações de todos os pares na janela.
+     *
+     * @param startUnix Início da janela (Unix Time).
+     * @param duration Duração da janela em segundos; entram os mínimos dentro da janela.
+     * @return Número de aproximações encontradas (results(), em ordem de TCA).
+     */
+    int screen(unsigned long startUnix, unsigned long duration);
+
+    /**
+     * @brief Prepara a triagem em etapas da janela (as amostras são processadas por run()).
+     *
+     * Os satélites não podem ser alterados até finished().
+     *
+     * @param startUnix Início da janela (Unix Time).
+     * @param duration Duração da janela em segundos.
+     * @return false se o grupo tem menos de dois satélites (nada a fazer).
+     */
+    bool begin(unsigned long startUnix, unsigned long duration);
+
+    /**
+     * @brief Processa amostras da janela até esgotar o orçamento de tempo.
+     *
+     * Uma amostra iniciada é sempre concluída; entre as chamadas o chamador pode atualizar
+     * a tela ou cancelar (basta não chamar mais run()).
+     *
+     * @param budgetUs Tempo máximo de cálculo em µs (0 = até o fim da janela).
+     * @return true quando a janela terminou (results() e lastStats() completos).
+     */
+    bool run(unsigned long budgetUs = 0);
+
+    /// Indica que a triagem terminou (ou que begin() não foi chamado).
+    bool finished() const { return done; }
+
+    /// Fração da janela já processada (0 a 1).
+    float progress() const;
+
+    /// Aproximações da última triagem, em ordem de TCA.
+    const std::vector<Conjunction>& results() const { return conjunctions; }
+
+    /// Contadores da última triagem.
+    const ConjunctionStats& lastStats() const { return stats; }
+
+private:
+    /// Satélite na grade de um passo.
+    struct Cell {
+        uint32_t key;   ///< Célula (x, y, z em 10 bits cada, z nos bits baixos)
+        uint16_t sat;   ///< Posição nos vetores internos
+    };
+
+    /// Sort-and-sweep das cascas: conta os pares sobrepostos e marca os satélites com par.
+    void sweepShells();
+
+    /// Pares a menos do alcance na amostra atual (grade espacial), em ordem de chave.
+    void flagPairs(const double r[][3], const int8_t error[]);
+
+    /// Célula da grade de uma posição (km).
+    uint32_t cellOf(const double r[3]) const;
+
+    /// Cascas de perigeu/apogeu de a e b a menos de shellGap uma da outra.
+    bool shellsOverlap(uint16_t a, uint16_t b) const {
+        return low[a] <= high[b] + shellGap && low[b] <= high[a] + shellGap;
+    }
+
+    /// Distância máxima na amostra para que o par possa ficar abaixo do limite até a próxima.
+    double reach(uint16_t a, uint16_t b) const { return threshold + (speed[a] + speed[b]) * step / 2.0; }
+
+    /// Refina o TCA do par entre t0 e t1 (s desde o início da janela).
+    void refine(uint16_t a, uint16_t b, double t0, double t1, double guess);
+
+    /// Distância do par (km) em t (s desde o início da janela), para brentmin().
+    static double separation(double t, void* data);
+
+    double threshold;                    ///< Distância limite (km)
+    unsigned long step;                  ///< Passo da varredura (s)
+    double jdStart;                      ///< Início da janela em processamento (data juliana)
+    unsigned long startUnix;             ///< Início da janela em processamento (Unix Time)
+    unsigned long window;                ///< Duração da janela em processamento (s)
+    double cellSize;                     ///< Aresta da célula da grade (km), o maior alcance
+    double shellGap;                     ///< Separação radial que ainda permite a aproximação (km)
+    int rejected;                        ///< Satélites recusados por addSatellite()
+    Sgp4Batch batch;                     ///< Elementos do grupo, na ordem de addSatellite()
+    std::vector<uint16_t> indices;       ///< Índice no grupo de cada satélite
+    std::vector<float> low;              ///< Raio mínimo da casca (km)
+    std::vector<float> high;             ///< Raio máximo da casca (km)
+    std::vector<float> speed;            ///< Velocidade máxima (km/s, no perigeu)
+    std::vector<uint8_t> partnered;      ///< Casca sobreposta à de algum outro satélite
+    std::vector<Cell> cells;             ///< Grade do passo atual
+    std::vector<uint32_t> flagged;       ///< Pares próximos na amostra atual (a << 16 | b)
+    std::vector<uint32_t> previous;      ///< Pares próximos na amostra anterior
+    std::vector<uint32_t> merged;        ///< União de previous e flagged
+    std::vector<double> rPrev;           ///< Posições na amostra anterior (km, 3 por satélite)
+    std::vector<double> vPrev;           ///< Velocidades na amostra anterior (km/s)
+    std::vector<double> rCur;            ///< Posições na amostra atual (km)
+    std::vector<double> vCur;            ///< Velocidades na amostra atual (km/s)
+    std::vector<int8_t> errPrev;         ///< Erro de propagação na amostra anterior
+    std::vector<int8_t> errCur;          ///< Erro de propagação na amostra atual
+    std::vector<uint8_t> failed;         ///< Satélite com erro em alguma amostra
+    unsigned long sample;                ///< Próxima amostra a processar
+    unsigned long samples;               ///< Última amostra da janela
+    double tPrev;                        ///< Instante da amostra anterior (s desde o início)
+    bool done;                           ///< Triagem terminada
+    std::vector<Conjunction> conjunctions;   ///< Resultado
+    ConjunctionStats stats;              ///< Contadores
+};
+
+#endif // CONJUNCTION_SCREENER_H
@@ -29,6 +29,12 @@ static constexpr int PROGRESS_BAR_Y = 170;
 static constexpr int PROGRESS_BAR_WIDTH = 180;
 static constexpr int PROGRESS_BAR_HEIGHT = 20;
 
+// Mapa do traço no solo (equirretangular: 360° x 180° na proporção 2:1)
+static constexpr int GROUND_MAP_X = 6;
+static constexpr int GROUND_MAP_Y = 30;
+static constexpr int GROUND_MAP_WIDTH = 228;
+static constexpr int GROUND_MAP_HEIGHT = 114;
+
 // ----------------------------------------------------------
 // Constantes para a barra de RSSI e limites do sinal
 // ----------------------------------------------------------
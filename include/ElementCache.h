@@ -0,0 +1,106 @@
+#ifndef ELEMENT_CACHE_H
+#define ELEMENT_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <SPIFFS.h>
+#include <Sgp4.h>
+#include <vector>
+
+struct SatelliteData;
+
+/**
+ * @brief Cache binário de elementos SGP4 já inicializados (elsetrec) no SPIFFS.
+ *
+ * Para cada arquivo de TLE ("/tle_noaa.txt") é mantido um arquivo ".elc" ("/tle_noaa.elc")
+ * com um registro por satélite, na mesma ordem do arquivo de TLE. Cada registro é identificado
+ * pelo número NORAD e por um checksum das duas linhas do TLE; o cache é reconstruído
+ * automaticamente quando algum registro não corresponde mais aos TLEs carregados.
+ *
+ * Com o cache válido, selecionar um satélite é apenas a leitura de um registro, sem
+ * twoline2rv() nem sgp4init().
+ */
+class ElementCache {
+public:
+    /// Construtor padrão.
+    ElementCache();
+
+    /**
+     * @brief Abre o cache correspondente a um arquivo de TLE, reconstruindo-o se necessário.
+     *
+     * @param tleFilePath Caminho do arquivo de TLE no SPIFFS.
+     * @param satellites Satélites carregados do arquivo, na ordem do arquivo.
+     * @return true se o cache está pronto para uso; false caso contrário.
+     */
+    bool open(const char* tleFilePath, const std::vector<SatelliteData>& satellites);
+
+    /// Fecha o arquivo de cache aberto.
+    void close();
+
+    /**
+     * @brief Lê os elementos inicializados de um satélite.
+     *
+     * @param index Índice do satélite (mesma ordem de open()).
+     * @param satrec Estrutura de saída.
+     * @return true se o registro foi lido e é válido; false caso contrário.
+     */
+    bool load(int index, elsetrec& satrec);
+
+    /**
+     * @brief Indica se há um cache aberto.
+     *
+     * @return true se o cache pode ser consultado.
+     */
+    bool isValid() const { return valid; }
+
+    /// Número NORAD lido da linha 1 do TLE.
+    static uint32_t noradId(const SatelliteData& sat);
+
+    /// Checksum (FNV-1a) das duas linhas do TLE.
+    static uint32_t tleChecksum(const SatelliteData& sat);
+
+private:
+    /// Cabeçalho do arquivo de cache.
+    struct Header {
+        uint32_t magic;       ///< Identificador do formato
+        uint16_t version;     ///< Versão do formato
+        uint16_t recordSize;  ///< sizeof(Record), invalida o cache se elsetrec mudar
+        uint32_t count;       ///< Número de registros
+    };
+
+    /// Registro de um satélite.
+    struct Record {
+        uint32_t norad;       ///< Número NORAD (colunas 3-7 da linha 1)
+        uint32_t checksum;    ///< Checksum das duas linhas do TLE
+        elsetrec satrec;      ///< Elementos prontos para sgp4()
+    };
+
+    static constexpr uint32_t CACHE_MAGIC   = 0x31434C45; // "ELC1"
+    static constexpr uint16_t CACHE_VERSION = 2;   // 2: movimento médio com todos os dígitos (twoline2rv)
+
+    fs::File file;       ///< Arquivo de cache aberto para leitura
+    uint32_t count;      ///< Número de registros no cache
+    bool valid;          ///< Cache aberto e consistente com os TLEs
+
+    /**
+     * @brief Recria o arquivo de cache a partir dos TLEs.
+     *
+     * @param cachePath Caminho do arquivo de cache.
+     * @param satellites Satélites carregados.
+     * @return true se o arquivo foi gravado com sucesso.
+     */
+    bool rebuild(const char* cachePath, const std::vector<SatelliteData>& satellites);
+
+    /**
+     * @brief Verifica se o cache aberto corresponde aos TLEs carregados.
+     *
+     * @param satellites Satélites carregados.
+     * @return true se todos os registros conferem.
+     */
+    bool matches(const std::vector<SatelliteData>& satellites);
+
+    /// Gera o caminho do cache trocando a extensão do arquivo de TLE por ".elc".
+    static void cachePathFor(const char* tleFilePath, char* buffer, size_t bufferSize);
+};
+
+#endif // ELEMENT_CACHE_H
@@ -0,0 +1,100 @@
+#ifndef GROUND_TRACK_H
+#define GROUND_TRACK_H
+
+#include <Sgp4.h>
+#include <sgp4model.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Vértice do traço no solo (ponto subsatélite).
+ */
+struct TrackPoint {
+    float lat;   ///< Latitude geodésica (graus)
+    float lon;   ///< Longitude (graus, -180 a 180)
+};
+
+/**
+ * @brief Contadores da última geração.
+ */
+struct TrackStats {
+    int samples;        ///< Pontos subsatélite calculados (propagações SGP4)
+    int vertices;       ///< Vértices mantidos após a decimação
+    int segments;       ///< Trechos (o traço é cortado na linha de data)
+    int failed;         ///< Amostras com erro de propagação (o trecho é interrompido)
+};
+
+/**
+ * @brief Traço no solo de um satélite ao longo de algumas órbitas, como polilinhas decimadas.
+ *
+ * O ponto subsatélite é amostrado em passos fixos (sgp4(), teme2ecef() e ijk2ll(), por
+ * Sgp4Model::state() e Sgp4Model::subpoint()). O traço é cortado onde cruza a linha de data,
+ * com um vértice interpolado em -180° e 180°, e cada trecho é reduzido por Douglas–Peucker
+ * em graus de latitude/longitude: fica a algumas dezenas de vértices por órbita em vez de
+ * centenas de amostras, o bastante para um mapa no TFT. As amostras de um trecho são
+ * decimadas em blocos de até MAX_BLOCK pontos, para limitar a memória com órbitas altas.
+ * Sem display nem Serial, para rodar também no ambiente nativo (bench/native).
+ */
+class GroundTrack {
+public:
+    /// Construtor padrão (passo de 10 s, tolerância de 0,25°).
+    GroundTrack();
+
+    /// Passo da amostragem (s).
+    void setStep(unsigned long seconds) { step = seconds > 0 ? seconds : 1; }
+
+    /// Maior distância (graus de latitude/longitude) entre o traço amostrado e o decimado.
+    void setTolerance(double degrees) { tolerance = degrees; }
+
+    /**
+     * @brief Gera o traço a partir de um instante.
+     *
+     * @param model Modelo do satélite (só a posição é propagada, sem az/el).
+     * @param startUnix Início do traço (Unix Time).
+     * @param orbits Número de órbitas (pelo movimento médio dos elementos).
+     * @return Número de vértices em points().
+     */
+    int generate(const Sgp4Model& model, unsigned long startUnix, double orbits);
+
+    /// Vértices de todos os trechos, em ordem de tempo.
+    const std::vector<TrackPoint>& points() const { return vertices; }
+
+    /// Índice em points() do primeiro vértice de cada trecho (o trecho vai até o início do seguinte).
+    const std::vector<uint32_t>& segments() const { return starts; }
+
+    /// Contadores da última geração.
+    const TrackStats& lastStats() const { return stats; }
+
+    /**
+     * @brief Raio da área de visibilidade (ângulo central da Terra) para uma altitude.
+     *
+     * @param altitudeKm Altitude do satélite (km).
+     * @param minElevation Elevação mínima na borda da área (graus).
+     * @return Raio em graus de arco sobre a superfície (multiplique pelo raio da Terra para km).
+     */
+    static double footprintRadius(double altitudeKm, double minElevation = 0.0);
+
+    static constexpr int MAX_BLOCK = 512;   ///< Amostras decimadas de uma vez
+
+private:
+    /// Acrescenta uma amostra ao bloco, decimando quando ele enche.
+    void addSample(float lat, float lon);
+
+    /// Decima o bloco e passa os vértices para vertices; sem last, o último ponto abre o próximo bloco.
+    void flushBlock(bool last);
+
+    /// Encerra o trecho atual (se tiver vértices) e abre outro.
+    void endSegment();
+
+    unsigned long step;                  ///< Passo da amostragem (s)
+    double tolerance;                    ///< Tolerância da decimação (graus)
+    bool newSegment;                     ///< O próximo bloco abre um trecho
+    std::vector<TrackPoint> block;       ///< Amostras do trecho ainda não decimadas
+    std::vector<uint8_t> keep;           ///< Marcas de Douglas–Peucker do bloco
+    std::vector<uint32_t> ranges;        ///< Pilha de Douglas–Peucker (primeiro << 16 | último)
+    std::vector<TrackPoint> vertices;    ///< Resultado
+    std::vector<uint32_t> starts;        ///< Início de cada trecho em vertices
+    TrackStats stats;                    ///< Contadores
+};
+
+#endif // GROUND_TRACK_H
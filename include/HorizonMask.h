@@ -0,0 +1,66 @@
+#ifndef HORIZON_MASK_H
+#define HORIZON_MASK_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <SPIFFS.h>
+#include <Sgp4.h>
+
+/**
+ * @brief Horizonte local (prédios, morros) do observador, lido de um arquivo de texto no SPIFFS.
+ *
+ * O arquivo ("/horizon.txt") tem uma seção por local; cada seção começa com
+ * "site <latitude> <longitude> <raio em km>" e segue com linhas "<azimute> <elevação>" em
+ * graus, em qualquer ordem. Pontos antes da primeira linha "site" valem para qualquer local.
+ * Linhas vazias ou iniciadas por '#' são ignoradas:
+ *
+ *     site -22.90 -47.06 1.0
+ *     0 4.5
+ *     90 12.0
+ *     180 3.0
+ *     270 8.0
+ *
+ * A seção do local mais próximo (dentro do raio) é convertida em uma tabela de 1° por
+ * horizoninit(); a biblioteca consulta a tabela em O(1) em cada avaliação da busca de
+ * AOS/LOS (Sgp4::sethorizon(), PassScheduler::setHorizon()).
+ */
+class HorizonMask {
+public:
+    /// Construtor padrão (horizonte plano).
+    HorizonMask();
+
+    /**
+     * @brief Carrega a máscara do local, relendo o arquivo só se o observador se moveu.
+     *
+     * @param lat Latitude do observador (graus).
+     * @param lon Longitude do observador (graus).
+     * @return true se há uma máscara para o local; false para o horizonte plano.
+     */
+    bool update(double lat, double lon);
+
+    /// Tabela para a biblioteca, ou nullptr para o horizonte plano.
+    const horizonmask* table() const { return valid ? &mask : nullptr; }
+
+    /// Checksum (FNV-1a) da tabela, 0 para o horizonte plano; entra na chave do PassCache.
+    uint32_t checksum() const { return valid ? sum : 0; }
+
+    /// Força a releitura do arquivo na próxima chamada a update().
+    void invalidate() { loaded = false; }
+
+    static constexpr double RELOAD_KM = 1.0;   ///< Deslocamento do observador que relê o arquivo
+
+private:
+    static constexpr int MAX_POINTS = HORIZON_BINS;   ///< Pontos por seção
+
+    /// Lê o arquivo e monta a tabela da seção do local.
+    bool load(double lat, double lon);
+
+    horizonmask mask;   ///< Tabela de 1° em radianos
+    bool valid;         ///< Há máscara para o local carregado
+    bool loaded;        ///< O arquivo já foi lido para loadedLat/loadedLon
+    double loadedLat;   ///< Local da última leitura (graus)
+    double loadedLon;
+    uint32_t sum;       ///< Checksum da tabela
+};
+
+#endif // HORIZON_MASK_H
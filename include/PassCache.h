@@ -0,0 +1,145 @@
+#ifndef PASS_CACHE_H
+#define PASS_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <SPIFFS.h>
+#include <vector>
+#include "PassPredictor.h"   // PassData
+
+struct SatelliteData;
+
+/**
+ * @brief Chave de uma entrada do cache de passagens.
+ *
+ * Guarda o observador exato da busca; a entrada só é descartada quando o observador se
+ * afasta mais de SITE_MOVE_KM (ou ALT_MOVE_M na altitude) desse ponto, para que o ruído do
+ * GPS não a invalide.
+ */
+struct PassKey {
+    uint32_t norad;       ///< Número NORAD
+    uint32_t checksum;    ///< Checksum das duas linhas do TLE (ElementCache::tleChecksum())
+    float lat;            ///< Latitude do observador (graus)
+    float lon;            ///< Longitude do observador (graus)
+    float alt;            ///< Altitude do observador (metros)
+    int16_t minElevation; ///< Elevação mínima em décimos de grau
+    uint32_t horizon;     ///< Checksum da máscara do horizonte local (HorizonMask::checksum()), 0 se plano
+};
+
+/**
+ * @brief Cache persistente (SPIFFS) das passagens previstas por satélite.
+ *
+ * Guarda apenas AOS e LOS de cada passagem e o intervalo de tempo já pesquisado; a
+ * trajetória é recalculada com PassPredictor::samplePath(), sem a busca de passagens.
+ * Cada satélite ocupa uma entrada; a entrada é descartada quando o TLE, o observador
+ * (além de SITE_MOVE_KM), o horizonte local ou a elevação mínima mudam, sem afetar as demais. Com o tempo, as
+ * passagens encerradas são removidas e a entrada é estendida apenas pelo intervalo que falta.
+ *
+ * Todas as entradas ficam na RAM (MAX_ENTRIES registros de poucas centenas de bytes); o
+ * arquivo é regravado inteiro a cada store().
+ */
+class PassCache {
+public:
+    /// Construtor padrão.
+    PassCache();
+
+    /**
+     * @brief Carrega o arquivo de cache (ou começa vazio se não existir ou for de outro formato).
+     *
+     * @param filePath Caminho do arquivo no SPIFFS.
+     * @return true se o arquivo foi lido.
+     */
+    bool begin(const char* filePath = "/passes.pc");
+
+    /**
+     * @brief Monta a chave de um satélite para um observador.
+     *
+     * @param sat Dados do satélite (TLE).
+     * @param lat Latitude do observador (graus).
+     * @param lon Longitude do observador (graus).
+     * @param alt Altitude do observador (metros).
+     * @param minElevation Elevação mínima das passagens (graus).
+     * @param horizon Checksum da máscara do horizonte local (0 = plano).
+     * @return Chave do satélite (observador exato, elevação mínima em décimos de grau).
+     */
+    static PassKey makeKey(const SatelliteData& sat, double lat, double lon, double alt, double minElevation,
+                           uint32_t horizon = 0);
+
+    /**
+     * @brief Consulta as passagens guardadas que ainda não terminaram na janela.
+     *
+     * Remove da entrada as passagens já encerradas e descarta a entrada se a chave mudou.
+     * As passagens retornadas não têm trajetória.
+     *
+     * @param key Chave do satélite.
+     * @param startUnix Início da janela (Unix Time).
+     * @param endUnix Fim da janela (Unix Time).
+     * @param passes Vetor de saída (é limpo antes), em ordem de AOS.
+     * @return Instante a partir do qual a janela ainda precisa ser pesquisada (maior que endUnix se completa).
+     */
+    unsigned long lookup(const PassKey& key, unsigned long startUnix, unsigned long endUnix,
+                         std::vector<PassData>& passes);
+
+    /**
+     * @brief Acrescenta à entrada as passagens pesquisadas em [fromUnix, untilUnix] e grava o arquivo.
+     *
+     * @param key Chave do satélite.
+     * @param fromUnix Início do intervalo pesquisado (retorno de lookup()).
+     * @param untilUnix Fim do intervalo pesquisado.
+     * @param passes Passagens encontradas (PassPredictor::generate()).
+     */
+    void store(const PassKey& key, unsigned long fromUnix, unsigned long untilUnix,
+               const std::vector<PassData>& passes);
+
+    /// Descarta todas as entradas (memória e arquivo).
+    void clear();
+
+    static constexpr double SITE_MOVE_KM = 2.0;     ///< Deslocamento do observador que descarta a entrada
+    static constexpr double ALT_MOVE_M   = 500.0;   ///< Variação da altitude que descarta a entrada
+
+private:
+    static constexpr int MAX_ENTRIES = 16;   ///< Satélites no cache (substitui o menos usado)
+    static constexpr int MAX_PASSES  = 32;   ///< Passagens por satélite
+
+    /// AOS e LOS de uma passagem.
+    struct Window {
+        uint32_t aos;
+        uint32_t los;
+    };
+
+    /// Entrada de um satélite.
+    struct Entry {
+        PassKey key;
+        uint32_t coveredFrom;    ///< Início do intervalo pesquisado (Unix Time)
+        uint32_t coveredUntil;   ///< Fim do intervalo pesquisado (Unix Time)
+        uint32_t lastUse;        ///< Contador de uso, para a substituição
+        uint16_t count;          ///< Passagens guardadas
+        Window passes[MAX_PASSES];
+    };
+
+    /// Cabeçalho do arquivo.
+    struct Header {
+        uint32_t magic;       ///< Identificador do formato
+        uint16_t version;     ///< Versão do formato
+        uint16_t entrySize;   ///< sizeof(Entry)
+        uint32_t count;       ///< Número de entradas
+    };
+
+    static constexpr uint32_t CACHE_MAGIC   = 0x31434350; // "PCC1"
+    static constexpr uint16_t CACHE_VERSION = 3;   // 2: máscara do horizonte na chave; 3: observador exato
+
+    std::vector<Entry> entries;   ///< Entradas em RAM
+    uint32_t useCounter;          ///< Contador de uso corrente
+    char path[32];                ///< Caminho do arquivo
+
+    /// Entrada do satélite (pelo número NORAD), ou nullptr.
+    Entry* find(uint32_t norad);
+
+    /// Grava todas as entradas no arquivo.
+    bool save();
+
+    /// Indica se duas chaves correspondem ao mesmo TLE, horizonte e elevação mínima, com observadores próximos.
+    static bool sameKey(const PassKey& a, const PassKey& b);
+};
+
+#endif // PASS_CACHE_H
@@ -0,0 +1,329 @@
+#ifndef PASS_PREDICTOR_H
+#define PASS_PREDICTOR_H
+
+#include <Sgp4.h>
+#include <sgp4model.h>
+#include <sgp4sites.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Estrutura para representar um ponto na trajetória do satélite.
+ */
+struct SatPosition {
+    unsigned long timestamp; ///< Timestamp do ponto
+    double azimuth;          ///< Azimute em graus
+    double elevation;        ///< Elevação em graus
+    float doppler;           ///< Desvio Doppler na frequência de downlink (Hz), 0 se não calculado
+};
+
+/**
+ * @brief Trajetória compacta de uma passagem.
+ *
+ * Cada ponto ocupa 8 bytes (contra 32 de SatPosition no ESP32): instante em passos inteiros
+ * a partir do início, az/el em centésimos de grau e taxa de variação da distância em
+ * 0,5 m/s, da qual o Doppler é obtido na leitura. A amostragem é adaptativa: add() só
+ * guarda um ponto quando a direção mudou MIN_ANGLE_DEG (ou a taxa MIN_RATE_KMS) desde o
+ * último guardado, e at() interpola entre eles. A leitura por índice devolve SatPosition,
+ * então o desenho da trajetória lê os mesmos dados sem conversão. A iluminação de cada
+ * ponto da grade (dia, satélite na sombra ou iluminado sob céu escuro) é guardada só
+ * nas mudanças, normalmente uma ou duas por passagem.
+ */
+class PassPath {
+public:
+    /// Construtor padrão (trajetória vazia).
+    PassPath();
+
+    /**
+     * @brief Descarta os pontos e define a grade de tempo da trajetória.
+     *
+     * @param startUnix Instante do primeiro ponto (Unix Time).
+     * @param stepSeconds Passo da grade (s); os instantes de add() devem cair nela.
+     * @param downlinkHz Frequência usada para converter a taxa da distância em Doppler (0 = sem Doppler).
+     * @param capacity Número máximo de pontos, reservado de uma vez (0 = cresce conforme add()).
+     */
+    void begin(unsigned long startUnix, unsigned long stepSeconds, double downlinkHz, size_t capacity = 0);
+
+    /**
+     * @brief Oferece um ponto amostrado na grade; é guardado se a direção mudou o bastante.
+     *
+     * @param unixTime Instante do ponto (Unix Time).
+     * @param azimuth Azimute (graus).
+     * @param elevation Elevação (graus).
+     * @param rangeRate Taxa de variação da distância (km/s).
+     */
+    void add(unsigned long unixTime, double azimuth, double elevation, double rangeRate);
+
+    /**
+     * @brief Oferece um ponto com a sua iluminação (Sgp4::timeline() com vis).
+     *
+     * @param light daylight, eclipsed ou lighted no instante do ponto.
+     */
+    void add(unsigned long unixTime, double azimuth, double elevation, double rangeRate, visibletype light);
+
+    /// Guarda o último ponto oferecido (fim da passagem) e libera a reserva não usada.
+    void finish();
+
+    /// Descarta os pontos e a memória.
+    void clear();
+
+    /// Número de pontos guardados.
+    size_t size() const { return points.size(); }
+
+    /// Indica se não há pontos.
+    bool empty() const { return points.empty(); }
+
+    /// Ponto i decodificado.
+    SatPosition operator[](size_t i) const;
+
+    /// Primeiro ponto.
+    SatPosition front() const { return (*this)[0]; }
+
+    /// Último ponto.
+    SatPosition back() const { return (*this)[points.size() - 1]; }
+
+    /**
+     * @brief Posição interpolada em um instante qualquer da trajetória.
+     *
+     * @param unixTime Instante desejado (Unix Time), limitado ao primeiro e ao último ponto.
+     * @return Ponto interpolado (azimute pelo menor arco).
+     */
+    SatPosition at(unsigned long unixTime) const;
+
+    /// Iluminação no instante (daylight se a trajetória não foi classificada, como na rede de estações).
+    visibletype light(unsigned long unixTime) const;
+
+    /// Indica que o satélite passa iluminado sob céu escuro em algum ponto (visível a olho nu).
+    bool visible() const;
+
+    /// Memória ocupada pelos pontos e pelas mudanças de iluminação (bytes).
+    size_t bytes() const { return points.capacity() * sizeof(Point) + lights.capacity() * sizeof(Light); }
+
+    static constexpr double MIN_ANGLE_DEG = 1.0;    ///< Mudança de direção que guarda um ponto
+    static constexpr double MIN_RATE_KMS  = 0.05;   ///< Mudança da taxa da distância que guarda um ponto (~23 Hz em 137 MHz)
+
+private:
+    /// Ponto codificado.
+    struct Point {
+        uint16_t tick;        ///< Instante em passos desde startUnix
+        uint16_t azimuth;     ///< Azimute em centésimos de grau (0 a 35999)
+        int16_t elevation;    ///< Elevação em centésimos de grau
+        int16_t rangeRate;    ///< Taxa da distância em unidades de 0,5 m/s
+    };
+
+    /// Mudança de iluminação: vale do ponto tick até a próxima mudança.
+    struct Light {
+        uint16_t tick;        ///< Instante em passos desde startUnix
+        uint8_t light;        ///< visibletype
+    };
+
+    /// Instante em passos desde startUnix, arredondado.
+    uint16_t tickOf(unsigned long unixTime) const;
+
+    /// Codifica um ponto.
+    Point encode(unsigned long unixTime, double azimuth, double elevation, double rangeRate) const;
+
+    /// Indica se o ponto se afasta o bastante do último guardado.
+    bool changed(const Point& p) const;
+
+    std::vector<Point> points;   ///< Pontos guardados
+    std::vector<Light> lights;   ///< Mudanças de iluminação, em ordem de tick
+    Point pending;               ///< Último ponto oferecido e ainda não guardado
+    bool hasPending;             ///< pending é válido
+    unsigned long startUnix;     ///< Instante do primeiro ponto (Unix Time)
+    uint16_t step;               ///< Passo da grade (s)
+    float downlinkHz;            ///< Frequência do Doppler (Hz)
+};
+
+/**
+ * @brief Estrutura que representa uma passagem completa (com início, fim e trajetória).
+ */
+struct PassData {
+    unsigned long startPassUnix;       ///< Início da passagem (Unix Time)
+    unsigned long endPassUnix;         ///< Fim da passagem (Unix Time)
+    PassPath path;                     ///< Pontos (az, el, Doppler) durante a passagem
+};
+
+/**
+ * @brief Contadores da última geração de passagens.
+ */
+struct PassStats {
+    int passes;             ///< Passagens geradas
+    int rejected;           ///< Passagens descartadas (fim antes do início)
+    long evaluations;       ///< Propagações usadas por nextpass() (ou pela varredura da rede)
+    long edgeEvaluations;   ///< Parte de evaluations usada no refinamento de AOS e LOS das passagens
+    long dssteps;           ///< Passos de integração deep space usados por nextpass()
+    long pathPoints;        ///< Pontos de trajetória calculados (na grade de setPathStep())
+    long pathStored;        ///< Pontos de trajetória guardados (PassPath)
+    int visible;            ///< Passagens com o satélite iluminado sob céu escuro (PassPath::visible())
+    int pruned;             ///< Satélite (ou estações da rede) descartado pelo pré-filtro geométrico, sem busca
+    int steps;              ///< Chamadas a PassGenerator::next() que consumiram o orçamento de tempo
+    long firstPassUs;       ///< Tempo de cálculo até a primeira passagem (µs), -1 se não houver passagem
+};
+
+/**
+ * @brief Gera a lista de passagens de um satélite sobre o observador.
+ *
+ * Contém apenas a parte de cálculo de SatelliteTracker::updateAndGeneratePasses(), sem
+ * display, GPS ou Serial, para que possa ser compilada e medida no ambiente nativo
+ * (ver bench/native).
+ */
+class PassPredictor {
+public:
+    /// Construtor padrão (elevação mínima de 10°, trajetória a cada 10 s).
+    PassPredictor();
+
+    /**
+     * @brief Gera as passagens que começam dentro da janela informada.
+     *
+     * O observador deve ter sido configurado com sat.site() antes da chamada. Com um horizonte
+     * local (sat.sethorizon()), AOS e LOS são os cruzamentos da máscara e a elevação mínima é
+     * medida acima dela.
+     *
+     * @param sat Objeto SGP4 já inicializado.
+     * @param startUnix Início da janela (Unix Time).
+     * @param duration Duração da janela em segundos.
+     * @param passes Vetor de saída (é limpo antes do cálculo).
+     * @return Número de passagens geradas, ou -1 se o ponto de predição não pôde ser inicializado.
+     */
+    int generate(Sgp4& sat, unsigned long startUnix, unsigned long duration, std::vector<PassData>& passes);
+
+    /**
+     * @brief Gera as passagens de um satélite sobre cada estação de uma rede.
+     *
+     * O satélite é propagado uma única vez por instante e o estado é projetado em todas as
+     * estações (Sgp4Sites), em vez de rodar generate() uma vez por estação. Abaixo do
+     * horizonte de todas as estações, o passo é o tempo mínimo para a elevação chegar a 0°
+     * (limitado pela velocidade no perigeu); acima, os passos de setPathStep() formam a
+     * trajetória. AOS e LOS são interpolados no cruzamento da elevação 0° (horizonte plano em
+     * todas as estações).
+     *
+     * @param model Modelo SGP4 já inicializado.
+     * @param sites Estações da rede.
+     * @param startUnix Início da janela (Unix Time).
+     * @param duration Duração da janela em segundos.
+     * @param passes Vetor de saída com uma lista de passagens por estação (mesma ordem de sites).
+     * @return Número total de passagens geradas.
+     */
+    int generate(const Sgp4Model& model, const Sgp4Sites& sites, unsigned long startUnix, unsigned long duration,
+                 std::vector<std::vector<PassData>>& passes);
+
+    /**
+     * @brief Calcula a trajetória de uma passagem a partir do AOS e do LOS já conhecidos.
+     *
+     * Usado para passagens guardadas sem trajetória (PassCache): uma única chamada a
+     * Sgp4::timeline(), sem busca de passagens.
+     *
+     * @param sat Objeto SGP4 já inicializado, com o observador configurado.
+     * @param pass Passagem com startPassUnix e endPassUnix; path é substituído.
+     */
+    void samplePath(Sgp4& sat, PassData& pass);
+
+    /// Elevação mínima (graus) para que uma passagem seja aceita.
+    void setMinElevation(double degrees) { minElevation = degrees; }
+
+    /// Elevação mínima atual (graus).
+    double getMinElevation() const { return minElevation; }
+
+    /// Intervalo (segundos) da grade em que a trajetória é amostrada (PassPath guarda só parte dos pontos).
+    void setPathStep(unsigned long seconds) { pathStep = seconds > 0 ? seconds : 1; }
+
+    /**
+     * @brief Frequência de downlink usada no cálculo do Doppler de cada ponto da trajetória.
+     *
+     * A taxa de variação da distância vem da velocidade da mesma propagação usada para
+     * az/el, sem propagações extras. Com 0 o Doppler não é calculado.
+     *
+     * @param hz Frequência em Hz (ex.: 137.1e6 para o APT do NOAA 19).
+     */
+    void setDownlinkFrequency(double hz) { downlinkHz = hz > 0.0 ? hz : 0.0; }
+
+    /// Frequência de downlink atual (Hz).
+    double getDownlinkFrequency() const { return downlinkHz; }
+
+    /**
+     * @brief Doppler em um instante qualquer da passagem, interpolando os pontos da trajetória.
+     *
+     * Permite atualizar o rádio a cada segundo com a trajetória amostrada de forma adaptativa.
+     *
+     * @param pass Passagem gerada por generate().
+     * @param unixTime Instante desejado (Unix Time).
+     * @return Desvio Doppler em Hz (0 fora da passagem).
+     */
+    static double dopplerAt(const PassData& pass, unsigned long unixTime);
+
+    /**
+     * @brief Maior taxa de subida da elevação (graus/s) enquanto o satélite está abaixo do horizonte.
+     *
+     * Permite saltar, sem perder o AOS, o tempo que a elevação levaria para chegar a 0°.
+     *
+     * @param satrec Elementos do satélite.
+     * @return Taxa em graus/s, ou 0 se não houver limite útil (perigeu abaixo da superfície).
+     */
+    static double maxElevationRate(const elsetrec& satrec);
+
+    /// Contadores da última chamada a generate() (ou da geração incremental em andamento).
+    const PassStats& lastStats() const { return stats; }
+
+private:
+    friend class PassGenerator;
+
+    double minElevation;        ///< Elevação mínima das passagens (graus)
+    unsigned long pathStep;     ///< Intervalo entre pontos da trajetória (s)
+    int iterations;             ///< Iterações máximas de nextpass()
+    double downlinkHz;          ///< Frequência de downlink para o Doppler (Hz)
+    PassStats stats;            ///< Contadores da última geração
+};
+
+/**
+ * @brief Geração incremental de passagens: uma passagem por chamada a next().
+ *
+ * Faz a mesma busca de PassPredictor::generate() (que usa esta classe), mas uma revolução
+ * de nextpass() por vez, para respeitar um orçamento de tempo por chamada. A tarefa de
+ * previsão (PassService) envia cada passagem assim que é encontrada e verifica o
+ * cancelamento entre chamadas. O satélite (e o observador) não pode ser alterado até finished().
+ */
+class PassGenerator {
+public:
+    /// Construtor padrão (nenhuma geração em andamento).
+    PassGenerator();
+
+    /**
+     * @brief Inicia a busca das passagens que começam dentro da janela (ou já em andamento no início).
+     *
+     * Usa a elevação mínima, o passo da trajetória e o Doppler de predictor, e reinicia os
+     * contadores de predictor.lastStats().
+     *
+     * @param predictor Configuração e contadores.
+     * @param sat Objeto SGP4 já inicializado, com o observador configurado.
+     * @param startUnix Início da janela (Unix Time).
+     * @param duration Duração da janela em segundos.
+     * @return false se o ponto de predição não pôde ser inicializado.
+     */
+    bool begin(PassPredictor& predictor, Sgp4& sat, unsigned long startUnix, unsigned long duration);
+
+    /**
+     * @brief Procura a próxima passagem.
+     *
+     * @param pass Passagem encontrada, com trajetória.
+     * @param budgetUs Tempo máximo de cálculo em µs (0 = até encontrar a passagem ou terminar).
+     *                 Uma revolução já iniciada é sempre concluída.
+     * @return true se pass foi preenchida; false se o orçamento acabou ou a busca terminou.
+     */
+    bool next(PassData& pass, unsigned long budgetUs = 0);
+
+    /// Indica que não há mais passagens na janela (ou que begin() não foi chamado).
+    bool finished() const { return done; }
+
+private:
+    PassPredictor* predictor;   ///< Configuração e contadores da geração
+    Sgp4* sat;                  ///< Satélite em busca
+    unsigned long startUnix;    ///< Início da janela (Unix Time)
+    unsigned long endUnix;      ///< Fim da janela (Unix Time)
+    int failures;               ///< Revoluções seguidas sem passagem
+    long startEvaluations;      ///< sat->evaluations no início
+    long elapsedUs;             ///< Tempo de cálculo acumulado (µs)
+    bool done;                  ///< Busca encerrada
+};
+
+#endif // PASS_PREDICTOR_H
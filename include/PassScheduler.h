@@ -0,0 +1,145 @@
+#ifndef PASS_SCHEDULER_H
+#define PASS_SCHEDULER_H
+
+#include <Sgp4.h>
+#include <sgp4model.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Passagem de um satélite do grupo na linha do tempo combinada.
+ *
+ * Não guarda a trajetória (28 bytes por passagem no ESP32), para caber centenas de
+ * satélites na RAM; a trajetória é gerada ao selecionar o satélite.
+ */
+struct ScheduledPass {
+    uint16_t satellite;      ///< Índice do satélite no grupo (mesma ordem de getSatellite())
+    uint8_t sight;           ///< visibletype: lighted se o satélite passa iluminado sob céu escuro
+    unsigned long aos;       ///< Início da passagem (Unix Time)
+    unsigned long tca;       ///< Instante da elevação máxima (Unix Time)
+    unsigned long los;       ///< Fim da passagem (Unix Time)
+    float maxElevation;      ///< Elevação máxima (graus, acima do horizonte astronômico)
+    float aosAzimuth;        ///< Azimute no AOS (graus)
+    float losAzimuth;        ///< Azimute no LOS (graus)
+};
+
+/**
+ * @brief Contadores da última previsão do grupo.
+ */
+struct ScheduleStats {
+    int satellites;         ///< Satélites processados
+    int failed;             ///< Satélites com erro de propagação na janela
+    int pruned;             ///< Satélites descartados pelo pré-filtro geométrico (sem propagação)
+    int always;             ///< Satélites sempre acima da elevação mínima na janela
+    int passes;             ///< Passagens aceitas
+    int visible;            ///< Passagens aceitas com sight == lighted
+    long evaluations;       ///< Propagações SGP4 no total
+};
+
+/**
+ * @brief Previsão de passagens de um grupo inteiro de satélites em uma linha do tempo única.
+ *
+ * Satélites que não podem subir acima da elevação mínima na janela são descartados antes
+ * da varredura (passfilter() da biblioteca). Os demais são varridos com um Sgp4Model: abaixo do horizonte o passo é o tempo mínimo
+ * para a elevação chegar a 0° (PassPredictor::maxElevationRate()), acima dele passos de
+ * cerca de 1/100 do período. AOS e LOS são refinados por bissecção e o TCA por seção áurea,
+ * até 1 s. Com setHorizon(), o horizonte é a máscara do terreno e as elevações da varredura
+ * são medidas acima dela. As amostras acima do horizonte também classificam a iluminação
+ * (sight), com o Sol do cache (sunlook()), sem propagações nem conversões az/el extras.
+ * Sem display nem Serial, para rodar também no ambiente nativo (bench/native).
+ */
+class PassScheduler {
+public:
+    /// Construtor padrão (elevação mínima de 10°, observador em 0°, 0°, 0 m).
+    PassScheduler();
+
+    /// Elevação mínima (graus) para que uma passagem entre na linha do tempo.
+    void setMinElevation(double degrees) { minElevation = degrees; }
+
+    /**
+     * @brief Define o observador.
+     *
+     * @param lat Latitude (graus).
+     * @param lon Longitude (graus).
+     * @param alt Altitude (metros).
+     */
+    void setSite(double lat, double lon, double alt) {
+        model.site(lat, lon, alt);
+        suncacheclear(sun);
+    }
+
+    /**
+     * @brief Horizonte local (terreno e construções) do observador.
+     *
+     * AOS e LOS passam a ser os cruzamentos da máscara, e só entram as passagens que sobem
+     * a elevação mínima acima dela. A máscara não é copiada e deve continuar válida.
+     *
+     * @param mask Máscara (horizoninit()), ou nullptr para o horizonte plano.
+     */
+    void setHorizon(const horizonmask* mask) { horizon = mask; }
+
+    /// Usa o modelo em precisão simples para satélites próximos da Terra (Sgp4Model::setfloat()).
+    void setFloat(bool enable) { model.setfloat(enable); }
+
+    /// Descarta a linha do tempo e os contadores.
+    void clear();
+
+    /**
+     * @brief Prevê as passagens de um satélite e as acrescenta à linha do tempo.
+     *
+     * A linha do tempo só fica ordenada após finish().
+     *
+     * @param index Índice do satélite no grupo.
+     * @param satrec Elementos já inicializados (twoline2rv ou ElementCache).
+     * @param startUnix Início da janela (Unix Time).
+     * @param duration Duração da janela em segundos; entram as passagens com AOS na janela.
+     * @return Número de passagens aceitas para este satélite.
+     */
+    int addSatellite(uint16_t index, const elsetrec& satrec, unsigned long startUnix, unsigned long duration);
+
+    /// Ordena a linha do tempo por AOS (junção das listas de todos os satélites).
+    void finish();
+
+    /// Linha do tempo ordenada por AOS.
+    const std::vector<ScheduledPass>& timeline() const { return passes; }
+
+    /**
+     * @brief Próximas passagens do grupo a partir de um instante.
+     *
+     * Inclui as passagens em andamento (LOS depois de unixTime), em ordem de AOS.
+     *
+     * @param unixTime Instante de referência (Unix Time).
+     * @param maxCount Número máximo de passagens.
+     * @param out Vetor de saída (é limpo antes).
+     * @param visibleOnly Só as passagens visíveis a olho nu (sight == lighted).
+     * @return Número de passagens em out.
+     */
+    int nextPasses(unsigned long unixTime, int maxCount, std::vector<ScheduledPass>& out,
+                   bool visibleOnly = false) const;
+
+    /// Contadores acumulados desde clear().
+    const ScheduleStats& lastStats() const { return stats; }
+
+private:
+    /// Elevação acima do horizonte local (graus) e azimute no instante, contando a propagação.
+    bool look(unsigned long t, double& el, double& az);
+
+    /// Iluminação na última amostra de look() (mesmo estado propagado).
+    visibletype light(unsigned long t);
+
+    /// Elevação da máscara no azimute (graus) acima do seu ponto mais baixo (0 sem máscara).
+    double horizonSlack(double az) const;
+
+    /// Bissecção do cruzamento de 0° entre tAbove (acima) e tBelow (abaixo), até 1 s.
+    unsigned long crossing(unsigned long tAbove, unsigned long tBelow, double& az);
+
+    double minElevation;                 ///< Elevação mínima das passagens (graus)
+    const horizonmask* horizon;          ///< Horizonte local, ou nullptr
+    Sgp4Model model;                     ///< Modelo do satélite em processamento
+    Sgp4Context ctx;                     ///< Estado de propagação do satélite em processamento
+    suncache sun;                        ///< Posição do Sol no observador, compartilhada pelos satélites
+    std::vector<ScheduledPass> passes;   ///< Linha do tempo
+    ScheduleStats stats;                 ///< Contadores
+};
+
+#endif // PASS_SCHEDULER_H
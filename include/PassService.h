@@ -0,0 +1,155 @@
+#ifndef PASS_SERVICE_H
+#define PASS_SERVICE_H
+
+#include <Sgp4.h>
+#include <atomic>
+#include <stdint.h>
+#include "PassPredictor.h"
+
+/**
+ * @brief Pedido de previsão: satélite, observador e janela.
+ *
+ * Contém cópias de tudo o que a busca usa (elementos e máscara do horizonte), para que a
+ * tarefa de previsão não dependa de objetos que a interface altera durante a busca.
+ */
+struct PassRequest {
+    char name[25];               ///< Nome do satélite
+    elsetrec satrec;             ///< Elementos já inicializados (Sgp4::satrec)
+    double lat;                  ///< Latitude do observador (graus)
+    double lon;                  ///< Longitude do observador (graus)
+    double alt;                  ///< Altitude do observador (metros)
+    unsigned long startUnix;     ///< Início da janela (Unix Time)
+    unsigned long duration;      ///< Duração da janela (s)
+    double minElevation;         ///< Elevação mínima das passagens (graus)
+    double downlinkHz;           ///< Frequência do Doppler da trajetória (Hz, 0 = sem Doppler)
+    bool singlePrecision;        ///< SGP4 em float para satélites próximos (Sgp4::setfloat())
+    bool useHorizon;             ///< Usa horizon em vez do horizonte plano
+    horizonmask horizon;         ///< Horizonte local (copiado)
+};
+
+/// Tipo de um resultado da tarefa de previsão.
+enum PassResultType {
+    PASS_RESULT_FOUND,    ///< Uma passagem, em ordem cronológica
+    PASS_RESULT_DONE,     ///< Fim da busca; stats tem os contadores
+    PASS_RESULT_FAILED    ///< O ponto de predição não pôde ser inicializado
+};
+
+/**
+ * @brief Resultado enviado pela tarefa de previsão.
+ */
+struct PassResult {
+    uint32_t request;      ///< Número do pedido (devolvido por PassService::submit())
+    PassResultType type;   ///< Tipo do resultado
+    PassData* pass;        ///< PASS_RESULT_FOUND: passagem com trajetória (quem lê libera com delete)
+    PassStats stats;       ///< PASS_RESULT_DONE: contadores da busca
+};
+
+/**
+ * @brief Previsão de passagens em segundo plano, em uma tarefa FreeRTOS no outro núcleo.
+ *
+ * A tarefa de previsão roda PassGenerator::next() em etapas de tempo limitado e envia cada
+ * passagem por uma fila assim que é encontrada; o loop() só lê a fila com poll(), sem
+ * bloquear os botões, o GPS e as notificações. Um novo pedido (ou cancel()) descarta o
+ * anterior: a tarefa verifica o pedido atual entre etapas e resultados antigos que ainda
+ * estejam na fila são descartados por poll().
+ *
+ * Fora do ESP32 (ambiente nativo) a tarefa é uma std::thread com a mesma lógica, para que
+ * possa ser conferida em bench/native.
+ */
+class PassService {
+public:
+    /// Construtor padrão (tarefa não iniciada).
+    PassService();
+
+    /// Encerra a tarefa (end()).
+    ~PassService();
+
+    /**
+     * @brief Cria a tarefa de previsão.
+     *
+     * @param core Núcleo do ESP32 em que a tarefa é fixada (ignorado no ambiente nativo).
+     * @param stackBytes Pilha da tarefa (bytes).
+     * @param priority Prioridade FreeRTOS da tarefa (ignorada no ambiente nativo).
+     * @return false se a tarefa não pôde ser criada.
+     */
+    bool begin(int core = 0, unsigned long stackBytes = 8192, unsigned priority = 1);
+
+    /// Cancela o pedido em andamento e encerra a tarefa.
+    void end();
+
+    /**
+     * @brief Envia um pedido, cancelando o anterior.
+     *
+     * O pedido é copiado; request pode ser reutilizado logo após a chamada.
+     *
+     * @param request Satélite, observador e janela.
+     * @return Número do pedido (nos resultados), ou 0 se a tarefa não foi iniciada.
+     */
+    uint32_t submit(const PassRequest& request);
+
+    /// Cancela o pedido em andamento; os resultados ainda não lidos são descartados.
+    void cancel();
+
+    /**
+     * @brief Lê o próximo resultado do pedido atual, sem esperar.
+     *
+     * @param result Resultado lido; com PASS_RESULT_FOUND, result.pass deve ser liberado com delete.
+     * @return true se um resultado foi lido.
+     */
+    bool poll(PassResult& result) { return receive(result, 0); }
+
+    /**
+     * @brief Espera o próximo resultado do pedido atual.
+     *
+     * @param result Resultado lido (ver poll()).
+     * @param timeoutMs Tempo máximo de espera (ms).
+     * @return true se um resultado foi lido.
+     */
+    bool wait(PassResult& result, unsigned long timeoutMs) { return receive(result, timeoutMs); }
+
+    /// Indica que o pedido atual ainda não terminou (falta ler PASS_RESULT_DONE ou PASS_RESULT_FAILED).
+    bool busy() const { return active != 0; }
+
+    /// Tempo de cálculo por etapa (µs): entre etapas a tarefa verifica o cancelamento e cede o núcleo.
+    void setStepBudget(unsigned long us) { stepBudgetUs = us > 0 ? us : 1; }
+
+    static constexpr int QUEUE_LENGTH = 8;   ///< Resultados na fila antes de a tarefa esperar o loop()
+
+private:
+    /// Pedido numerado, como trocado entre o loop() e a tarefa.
+    struct Job {
+        uint32_t id;
+        PassRequest request;
+    };
+
+    struct Channels;   ///< Tarefa, mutex e filas (FreeRTOS ou std::thread), ver PassService.cpp
+
+    /// Laço da tarefa de previsão.
+    void run();
+
+    /// Busca as passagens de work e envia os resultados.
+    void process();
+
+    /// Envia um resultado, esperando espaço na fila enquanto o pedido não é cancelado.
+    bool push(const PassResult& result);
+
+    /// Lê a fila descartando resultados de pedidos anteriores.
+    bool receive(PassResult& result, unsigned long timeoutMs);
+
+    /// Libera os resultados que ainda estão na fila.
+    void drain();
+
+    Channels* channels;               ///< nullptr até begin()
+    std::atomic<uint32_t> current;    ///< Pedido atual (0 = nenhum ou cancelado)
+    uint32_t counter;                 ///< Último número de pedido
+    uint32_t active;                  ///< Pedido atual ainda não terminado para quem lê (loop())
+    unsigned long stepBudgetUs;       ///< Tempo de cálculo por etapa (µs)
+    bool hasPending;                  ///< pending tem um pedido ainda não iniciado (protegido pelo mutex)
+    bool stopping;                    ///< end() pediu o fim da tarefa (protegido pelo mutex)
+    Job pending;                      ///< Pedido entregue por submit() (protegido pelo mutex)
+    Job work;                         ///< Pedido em busca (só a tarefa)
+    Sgp4 sat;                         ///< Satélite em busca (só a tarefa)
+    PassPredictor predictor;          ///< Configuração e contadores da busca (só a tarefa)
+};
+
+#endif // PASS_SERVICE_H
@@ -3,6 +3,9 @@
 #define SATELLITE_TRACKER_H
 
 #include <Sgp4.h>
+#include <sgp4batch.h>
+#include <sgp4cheb.h>
+#include <sgp4model.h>
 #include <gps.h>
 #include <vector>      // Para std::vector
 #include <Arduino.h>
@@ -11,6 +14,14 @@
 #include <TFT_eSPI.h>
 #include "Config.h"    // Para definições de pinos, incluindo BUZZER_PIN
 #include "gps.h"
+#include "ElementCache.h"
+#include "PassPredictor.h"   // SatPosition, PassData
+#include "PassScheduler.h"   // ScheduledPass
+#include "ConjunctionScreener.h"   // Conjunction
+#include "GroundTrack.h"
+#include "PassCache.h"
+#include "HorizonMask.h"
+#include "PassService.h"
 
 // Objeto TFT é declarado externamente (por exemplo, na main)
 extern TFT_eSPI tft;
@@ -24,24 +35,6 @@ struct SatelliteData {
     char tle_line2[100]; ///< Linha 2 do TLE (tamanho usual ~69 caracteres)
 };
 
-/**
- * @brief Estrutura para representar um ponto na trajetória do satélite.
- */
-struct SatPosition {
-    unsigned long timestamp; ///< Timestamp do ponto
-    double azimuth;          ///< Azimute em graus
-    double elevation;        ///< Elevação em graus
-};
-
-/**
- * @brief Estrutura que representa uma passagem completa (com início, fim e trajetória).
- */
-struct PassData {
-    unsigned long startPassUnix;       ///< Início da passagem (Unix Time)
-    unsigned long endPassUnix;         ///< Fim da passagem (Unix Time)
-    std::vector<SatPosition> path;     ///< Vetor com pontos (az, el) durante a passagem
-};
-
 /**
  * @brief Estrutura para manter o estado do marcador do satélite na interface.
  */
@@ -65,6 +58,29 @@ class SatelliteTracker {
 private:
     std::vector<SatelliteData> satellites;   ///< Lista dinâmica de satélites
     Sgp4 sat;                                ///< Objeto SGP4 para cálculos orbitais
+    Sgp4Batch batch;                         ///< Propagador em lote para o grupo carregado
+    bool batchValid;                         ///< Indica se o lote corresponde aos TLEs carregados
+    ElementCache elementCache;               ///< Elementos SGP4 pré-inicializados no SPIFFS
+    Sgp4Cheb ephemeris;                      ///< Efemérides Chebyshev do satélite selecionado
+    Sgp4Model model;                         ///< Modelo SGP4 imutável do satélite selecionado (compartilhável)
+    Sgp4Context liveContext;                 ///< Estado de propagação da posição em tempo real
+    PassPredictor passPredictor;             ///< Geração de passagens (sem dependência de display)
+    PassCache passCache;                     ///< AOS/LOS já previstos por satélite, no SPIFFS
+    HorizonMask horizonMask;                 ///< Horizonte local do observador (AOS/LOS na máscara)
+    PassService passService;                 ///< Busca das passagens que faltam no cache, no outro núcleo
+    PassRequest serviceRequest;              ///< Pedido montado aqui (não na pilha do loop()) e copiado por submit()
+    PassKey pendingKey;                      ///< Chave do cache da busca em andamento
+    unsigned long pendingFrom;               ///< Início do intervalo pesquisado (Unix Time)
+    unsigned long pendingUntil;              ///< Fim do intervalo pesquisado (Unix Time)
+    std::vector<PassData> foundPasses;       ///< AOS/LOS encontrados na busca, para o cache
+    PassScheduler scheduler;                 ///< Linha do tempo de passagens do grupo carregado
+    bool scheduleValid;                      ///< Indica se a linha do tempo corresponde aos TLEs carregados
+    unsigned long scheduleStart;             ///< Início da janela da linha do tempo (Unix Time)
+    std::vector<Conjunction> approaches;     ///< Aproximações entre satélites do grupo carregado
+    bool approachesValid;                    ///< Indica se approaches corresponde aos TLEs carregados
+    unsigned long approachesStart;           ///< Início da janela da triagem (Unix Time)
+    double currentAz;                        ///< Azimute atual do satélite (graus)
+    double currentEl;                        ///< Elevação atual do satélite (graus)
 
     unsigned long currentUnixTime;
 
@@ -100,6 +116,16 @@ public:
     void drawCurrentSatMarker(int centerX, int centerY, int radius,
                               double az, double el, SatelliteMarkerState &markerState);
 
+    /**
+     * @brief Desenha o mapa do traço no solo (grade de 30°, traço, satélite e área de visibilidade).
+     *
+     * @param track Traço já gerado (trechos cortados na linha de data).
+     * @param lat Latitude atual do satélite (graus).
+     * @param lon Longitude atual do satélite (graus).
+     * @param footprint Raio da área de visibilidade (graus de arco).
+     */
+    void drawGroundTrackMap(const GroundTrack& track, double lat, double lon, double footprint);
+
     ////////// Métodos de Gerenciamento e Formatação de Tempo //////////
 
     /**
@@ -124,6 +150,9 @@ public:
     /**
      * @brief Inicializa um satélite selecionado com base nos TLEs.
      *
+     * Usa os elementos do cache (ElementCache) quando disponíveis; caso contrário,
+     * interpreta as linhas do TLE.
+     *
      * @param index Índice do satélite na lista.
      */
     void initSatellite(int index);
@@ -135,9 +164,28 @@ public:
      */
     void updateAzElRealTime();
 
+    /**
+     * @brief Carrega o cache de passagens do SPIFFS (depois de montar o SPIFFS em setupGPS()).
+     */
+    void beginPassCache() { passCache.begin(); }
+
+    /**
+     * @brief Cria a tarefa de previsão de passagens (PassService) no núcleo PASS_SERVICE_CORE.
+     */
+    void beginPassService();
+
     /**
      * @brief Atualiza a posição do satélite e gera passagens para um período especificado.
      *
+     * As passagens já previstas para o mesmo TLE, observador e elevação mínima vêm do
+     * PassCache; só o intervalo que falta é pesquisado, e as trajetórias são recalculadas
+     * com PassPredictor::samplePath(). O intervalo que falta é enviado à tarefa de previsão
+     * (PassService) e a função retorna sem esperar; as passagens chegam por collectPasses().
+     * Se a tarefa não pode ser criada, o intervalo é pesquisado aqui mesmo com
+     * PassPredictor::generate().
+     * Também ajusta as efemérides Chebyshev do satélite para o mesmo período, usadas
+     * pelas consultas em tempo real (updateAzElRealTime(), updateSatellitePosition()).
+     *
      * @param lat Latitude do observador.
      * @param lon Longitude do observador.
      * @param alt Altitude do observador.
@@ -145,6 +193,36 @@ public:
      */
     void updateAndGeneratePasses(double lat, double lon, double alt, unsigned long duracao);
 
+    /**
+     * @brief Lê, sem esperar, as passagens já enviadas pela tarefa de previsão.
+     *
+     * Ao terminar a busca, grava as passagens encontradas no PassCache.
+     *
+     * @return true se alguma passagem foi acrescentada a getPasses().
+     */
+    bool collectPasses();
+
+    /// Cancela a busca em andamento (botão BACK); o intervalo não é gravado no PassCache.
+    void cancelPasses();
+
+    /// Indica que ainda há passagens sendo procuradas (getPasses() pode crescer).
+    bool isGeneratingPasses() const { return passService.busy(); }
+
+    /**
+     * @brief Gera passagens do satélite selecionado para uma rede de estações.
+     *
+     * Propaga o satélite uma única vez por instante e projeta o estado em todas as
+     * estações (PassPredictor::generate() com Sgp4Sites). Não altera o observador local
+     * nem as passagens de getPasses().
+     *
+     * @param sites Estações da rede.
+     * @param duracao Duração (em segundos) a partir do tempo atual.
+     * @param sitePasses Saída com uma lista de passagens por estação.
+     * @return Número total de passagens geradas.
+     */
+    int generateNetworkPasses(const Sgp4Sites& sites, unsigned long duracao,
+                              std::vector<std::vector<PassData>>& sitePasses);
+
     /**
      * @brief Atualiza a posição do satélite utilizando os dados do GPS e SGP4.
      *
@@ -152,11 +230,68 @@ public:
      */
     void updateSatellitePosition(unsigned long currentTime);
 
+    /**
+     * @brief Calcula azimute e elevação de todos os satélites carregados em uma única chamada.
+     *
+     * Utiliza o propagador em lote (Sgp4Batch), construído sob demanda a partir dos TLEs
+     * carregados por loadTLEFile(). O vetor de saída tem uma entrada por satélite, na mesma
+     * ordem de getSatellite(); satélites com erro de propagação recebem elevação -90°.
+     *
+     * @param unixTime Tempo em Unix para a propagação.
+     * @param positions Vetor de saída com (az, el) de cada satélite.
+     * @return Número de satélites propagados sem erro.
+     */
+    int propagateAll(unsigned long unixTime, std::vector<SatPosition>& positions);
+
+    /**
+     * @brief Prevê as passagens de todos os satélites carregados em uma linha do tempo única.
+     *
+     * Usa PassScheduler a partir do tempo atual, com a janela e a elevação mínima de
+     * Config.h, e registra no Serial o tempo total e as propagações por satélite. Os satélites
+     * são processados em etapas de GROUP_PASS_STEP_BUDGET_US com barra de progresso, GPS e
+     * notificações atualizados entre elas; o botão BACK cancela e descarta a linha do tempo.
+     *
+     * @param lat Latitude do observador.
+     * @param lon Longitude do observador.
+     * @param alt Altitude do observador.
+     * @return Número de passagens na linha do tempo, ou -1 se a previsão foi cancelada.
+     */
+    int updateGroupSchedule(double lat, double lon, double alt);
+
+    /**
+     * @brief Procura aproximações entre todos os satélites carregados.
+     *
+     * Usa ConjunctionScreener a partir do tempo atual, com a janela, o passo e a distância
+     * limite de Config.h, e registra no Serial o tempo total e os pares podados. A varredura
+     * corre em etapas de CONJUNCTION_STEP_BUDGET_US com barra de progresso, GPS e notificações
+     * atualizados entre elas; o botão BACK cancela a triagem sem alterar as aproximações
+     * anteriores.
+     *
+     * @return Número de aproximações encontradas, ou -1 se a triagem foi cancelada.
+     */
+    int updateConjunctions();
+
+    /**
+     * @brief Retorna as próximas passagens do grupo (linha do tempo de updateGroupSchedule()).
+     *
+     * @param unixTime Instante de referência (Unix Time).
+     * @param maxCount Número máximo de passagens.
+     * @param out Vetor de saída, em ordem de AOS.
+     * @param visibleOnly Só passagens visíveis a olho nu (ScheduledPass::sight == lighted).
+     * @return Número de passagens em out.
+     */
+    int getGroupPasses(unsigned long unixTime, int maxCount, std::vector<ScheduledPass>& out,
+                       bool visibleOnly = false) const {
+        return scheduler.nextPasses(unixTime, maxCount, out, visibleOnly);
+    }
+
     ////////// Métodos para Carregamento/Armazenamento dos TLEs //////////
 
     /**
      * @brief Carrega os TLEs a partir de um arquivo específico do SPIFFS.
      *
+     * Também abre (ou recria) o cache de elementos correspondente ao arquivo.
+     *
      * @param filePath Caminho do arquivo.
      * @return true se os TLEs foram carregados com sucesso; false caso contrário.
      */
@@ -186,18 +321,34 @@ public:
     unsigned long getCurrentUnix() const { return currentUnixTime; }
 
     /**
-     * @brief Retorna o azimute do satélite calculado pelo SGP4.
+     * @brief Retorna o azimute atual do satélite (efemérides ou SGP4).
      *
      * @return Azimute.
      */
-    double getAzimuth() const { return sat.satAz; }
+    double getAzimuth() const { return currentAz; }
 
     /**
-     * @brief Retorna a elevação do satélite calculada pelo SGP4.
+     * @brief Retorna a elevação atual do satélite (efemérides ou SGP4).
      *
      * @return Elevação.
      */
-    double getElevation() const { return sat.satEl; }
+    double getElevation() const { return currentEl; }
+
+    /**
+     * @brief Retorna o modelo SGP4 do satélite selecionado.
+     *
+     * O modelo só possui funções const; cada chamador propaga com o seu próprio Sgp4Context.
+     *
+     * @return Referência constante ao modelo.
+     */
+    const Sgp4Model& getModel() const { return model; }
+
+    /**
+     * @brief Define a frequência de downlink usada no Doppler das próximas passagens geradas.
+     *
+     * @param hz Frequência em Hz (0 desativa o cálculo).
+     */
+    void setDownlinkFrequency(double hz) { passPredictor.setDownlinkFrequency(hz); }
 
     /**
      * @brief Retorna o número de satélites carregados.
@@ -254,6 +405,29 @@ public:
      */
     void showEachPass();
 
+    /**
+     * @brief Exibe as próximas passagens de todo o grupo carregado, em ordem de AOS.
+     *
+     * Recalcula a linha do tempo quando necessário; ao selecionar uma passagem,
+     * inicializa o satélite correspondente e abre showEachPass().
+     */
+    void showGroupPasses();
+
+    /**
+     * @brief Exibe as próximas aproximações entre satélites do grupo, em ordem de TCA.
+     *
+     * Refaz a triagem quando o grupo mudou ou quando a janela já passou da metade.
+     */
+    void showConjunctions();
+
+    /**
+     * @brief Exibe o traço no solo do satélite selecionado em um mapa.
+     *
+     * Gera GROUND_TRACK_ORBITS órbitas a partir de agora e atualiza a posição a cada 5 s;
+     * o traço é refeito a cada órbita, para manter as próximas sempre à frente.
+     */
+    void showGroundTrack();
+
     /**
      * @brief Exibe e permite a seleção de um satélite.
      *
@@ -0,0 +1,101 @@
+/*
+Fits a Chebyshev ephemeris (sgp4cheb.h) for 24 hours and compares it with the full model.
+For every satellite and fit setting it reports:
+  - memory used by the coefficients and the fitting time
+  - maximum position error (km) and az/el error (degrees, only above the horizon)
+  - time per az/el query compared with Sgp4::findsat() and the speedup
+*/
+
+#include <Sgp4.h>
+#include <sgp4cheb.h>
+
+#define SPAN_HOURS 24.0
+#define CHECK_STEP (7.0 / 86400.0)   //7 seconds, not aligned with the segments
+
+const char* tles[][3] = {
+  {"NOAA 18", "1 28654U 05018A   24243.75797502  .00000533  00000-0  30732-3 0  9995", "2 28654  98.8706 320.0940 0013856 208.0464 151.9963 14.13303826993792"},
+  {"NOAA 19", "1 33591U 09005A   24243.86168433  .00000539  00000-0  31282-3 0  9995", "2 33591  99.0410 300.4304 0014805  83.1049 277.1806 14.13096718802172"},
+  {"ISS",     "1 25544U 98067A   24244.61296303  .00007110  00000-0  13764-3 0  9990", "2 25544  51.6414  91.2147 0005455 149.8476 323.9777 15.50045178394477"},
+};
+const int numtles = sizeof(tles) / sizeof(tles[0]);
+
+//segment length [minutes], degree
+const double settings[][2] = { {60.0, 14}, {45.0, 12}, {30.0, 10}, {20.0, 8} };
+const int numsettings = sizeof(settings) / sizeof(settings[0]);
+
+const double siteLat = -23.5505, siteLon = -46.6333, siteAlt = 760.0;  //degrees, degrees, meters
+
+Sgp4 sat;
+Sgp4Cheb cheb;
+
+void compare(int n, double segmin, int degree){
+  double recef[3], rc[3], r[3], v[3];
+  double az, el;
+  double maxpos = 0.0, maxaz = 0.0, maxel = 0.0;
+  int samples = 0;
+
+  sat.init(tles[n][0], tles[n][1], tles[n][2]);
+  double jd0 = sat.satrec.jdsatepoch;
+  double jd1 = jd0 + SPAN_HOURS / 24.0;
+
+  unsigned long start = micros();
+  cheb.fit(sat.satrec, jd0, SPAN_HOURS, segmin, degree);
+  unsigned long fittime = micros() - start;
+
+  //accuracy
+  for (double jd = jd0; jd <= jd1; jd += CHECK_STEP){
+    sgp4(wgs84, sat.satrec, (jd - jd0) * 1440.0, r, v);
+    teme2ecef(r, jd, recef);
+    cheb.position(jd, rc);
+    double dx = recef[0] - rc[0], dy = recef[1] - rc[1], dz = recef[2] - rc[2];
+    maxpos = max(maxpos, sqrt(dx * dx + dy * dy + dz * dz));
+
+    sat.findsat(jd);
+    cheb.azel(jd, az, el);
+    if (sat.satEl > 0.0){
+      double d = fabs(az - sat.satAz);
+      maxaz = max(maxaz, d > 180.0 ? 360.0 - d : d);
+      maxel = max(maxel, fabs(el - sat.satEl));
+    }
+    samples++;
+  }
+
+  //speed
+  start = micros();
+  for (double jd = jd0; jd <= jd1; jd += CHECK_STEP){
+    sat.findsat(jd);
+  }
+  unsigned long timesgp4 = micros() - start;
+  double sum = 0.0;
+  start = micros();
+  for (double jd = jd0; jd <= jd1; jd += CHECK_STEP){
+    cheb.azel(jd, az, el);
+    sum += el;
+  }
+  unsigned long timecheb = micros() - start;
+
+  Serial.printf("%-8s %4.0f min deg %2d: %6u bytes  fit %7.1f ms  pos %.4f km  az %.4f el %.4f deg  "
+                "findsat %.2f us  cheb %.2f us  speedup %.1fx\n",
+                tles[n][0], segmin, degree, (unsigned)cheb.bytes(), fittime / 1000.0, maxpos, maxaz, maxel,
+                (double)timesgp4 / samples, (double)timecheb / samples,
+                (double)timesgp4 / max(timecheb, 1UL) + 0.0 * sum);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println();
+
+  sat.site(siteLat, siteLon, siteAlt);
+  cheb.site(siteLat, siteLon, siteAlt);
+
+  for (int n = 0; n < numtles; n++){
+    for (int s = 0; s < numsettings; s++){
+      compare(n, settings[s][0], (int)settings[s][1]);
+      delay(0);
+    }
+  }
+}
+
+void loop() {
+
+}
@@ -0,0 +1,144 @@
+/*
+Compares the single precision near earth model (sgp4float.h) with the double precision sgp4().
+For every satellite it propagates 24 hours from the TLE epoch and reports:
+  - position error in km (max and rms)
+  - azimuth / elevation error in degrees while the satellite is above the horizon
+    (azimuth weighted by the cosine of the elevation, it turns fast near the zenith)
+  - difference in start / stop time and maximum elevation of the predicted overpasses
+  - time per propagation + az/el calculation and the speedup
+A satellite fails when the position or az/el error is above the limits below, the same
+limits as the native benchmark (bench/native) uses before the float model is enabled.
+*/
+
+#include <Sgp4.h>
+#include <sgp4float.h>
+
+#define SPAN_MIN   1440.0   //24 hours
+#define STEP_MIN   0.5      //30 seconds
+#define MAX_POS_KM    0.050 //position error limit
+#define MAX_AZEL_DEG  0.01  //az/el error limit
+
+const char* tles[][3] = {
+  {"NOAA 18", "1 28654U 05018A   24243.75797502  .00000533  00000-0  30732-3 0  9995", "2 28654  98.8706 320.0940 0013856 208.0464 151.9963 14.13303826993792"},
+  {"NOAA 19", "1 33591U 09005A   24243.86168433  .00000539  00000-0  31282-3 0  9995", "2 33591  99.0410 300.4304 0014805  83.1049 277.1806 14.13096718802172"},
+  {"ISS",     "1 25544U 98067A   24244.61296303  .00007110  00000-0  13764-3 0  9990", "2 25544  51.6414  91.2147 0005455 149.8476 323.9777 15.50045178394477"},
+  {"06251",   "1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985", "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774"},
+  {"28057",   "1 28057U 03049A   06177.78615833  .00000060  00000-0  35940-4 0  1836", "2 28057  98.4283 247.6961 0000884  88.1964 271.9322 14.35478080140550"},
+};
+const int numtles = sizeof(tles) / sizeof(tles[0]);
+
+const double siteLat = -23.5505, siteLon = -46.6333, siteAlt = 760.0;  //degrees, degrees, meters
+
+Sgp4 satd;   //double precision
+Sgp4 satf;   //single precision
+bool allok = true;
+
+double anglediff(double a, double b){   //smallest difference between two angles in degrees
+  double d = fabs(a - b);
+  return d > 180.0 ? 360.0 - d : d;
+}
+
+void compare(int n){
+  char line1[130], line2[130];
+  elsetrec satrec;
+  double r[3], v[3], razel[3];
+  float rf[3], vf[3], razelf[3];
+  double latRad = siteLat * pi / 180.0, lonRad = siteLon * pi / 180.0;
+  double maxpos = 0.0, sumpos = 0.0, maxaz = 0.0, maxel = 0.0;
+  int samples = 0, visible = 0;
+
+  strncpy(line1, tles[n][1], sizeof(line1));
+  strncpy(line2, tles[n][2], sizeof(line2));
+  twoline2rv(line1, line2, 'i', wgs84, satrec);
+  if (satrec.method != 'n'){
+    Serial.printf("%s: deep space, skipped\n", tles[n][0]);
+    return;
+  }
+
+  //accuracy
+  for (double t = 0.0; t <= SPAN_MIN; t += STEP_MIN){
+    double jd = satrec.jdsatepoch + t / 1440.0;
+    sgp4(wgs84, satrec, t, r, v);
+    sgp4f(wgs84, satrec, t, rf, vf);
+    rv2azel(r, latRad, lonRad, siteAlt / 1000.0, jd, razel);
+    rv2azel(rf, (float)latRad, (float)lonRad, (float)(siteAlt / 1000.0), jd, razelf);
+
+    double dx = r[0] - rf[0], dy = r[1] - rf[1], dz = r[2] - rf[2];
+    double dpos = sqrt(dx * dx + dy * dy + dz * dz);
+    maxpos = max(maxpos, dpos);
+    sumpos += dpos * dpos;
+    samples++;
+
+    if (razel[2] > 0.0){
+      maxaz = max(maxaz, anglediff(razel[1] * 180.0 / pi, razelf[1] * 180.0 / pi) * cos(razel[2]));
+      maxel = max(maxel, fabs(razel[2] - razelf[2]) * 180.0 / pi);
+      visible++;
+    }
+  }
+
+  //speed
+  unsigned long start = micros();
+  for (double t = 0.0; t <= SPAN_MIN; t += STEP_MIN){
+    sgp4(wgs84, satrec, t, r, v);
+    rv2azel(r, latRad, lonRad, siteAlt / 1000.0, satrec.jdsatepoch + t / 1440.0, razel);
+  }
+  unsigned long timed = micros() - start;
+  start = micros();
+  for (double t = 0.0; t <= SPAN_MIN; t += STEP_MIN){
+    sgp4f(wgs84, satrec, t, rf, vf);
+    rv2azel(rf, (float)latRad, (float)lonRad, (float)(siteAlt / 1000.0), satrec.jdsatepoch + t / 1440.0, razelf);
+  }
+  unsigned long timef = micros() - start;
+
+  Serial.printf("%s: %d samples, %d above horizon\n", tles[n][0], samples, visible);
+  Serial.printf("  position error  max %.4f km  rms %.4f km\n", maxpos, sqrt(sumpos / samples));
+  Serial.printf("  az/el error     max %.4f deg / %.4f deg\n", maxaz, maxel);
+  bool ok = maxpos <= MAX_POS_KM && maxaz <= MAX_AZEL_DEG && maxel <= MAX_AZEL_DEG;
+  allok = allok && ok;
+  Serial.printf("  accuracy        %s (limits %.3f km, %.3f deg)\n", ok ? "ok" : "FAILED", MAX_POS_KM, MAX_AZEL_DEG);
+  Serial.printf("  time            double %.2f us  float %.2f us  speedup %.2fx\n",
+                (double)timed / samples, (double)timef / samples, (double)timed / max(timef, 1UL));
+
+  //overpasses
+  passinfo pd, pf;
+  double jdend = satrec.jdsatepoch + SPAN_MIN / 1440.0;
+  double maxstart = 0.0, maxstop = 0.0, maxmaxel = 0.0;
+  int passes = 0;
+
+  strncpy(line1, tles[n][1], sizeof(line1));
+  strncpy(line2, tles[n][2], sizeof(line2));
+  satd.init(tles[n][0], line1, line2);
+  strncpy(line1, tles[n][1], sizeof(line1));
+  strncpy(line2, tles[n][2], sizeof(line2));
+  satf.init(tles[n][0], line1, line2);
+  satd.initpredpoint(satd.satrec.jdsatepoch, 0.0);
+  satf.initpredpoint(satf.satrec.jdsatepoch, 0.0);
+
+  while (satd.nextpass(&pd, 20) && satf.nextpass(&pf, 20) && pd.jdstart < jdend){
+    maxstart = max(maxstart, fabs(pd.jdstart - pf.jdstart) * 86400.0);
+    maxstop  = max(maxstop, fabs(pd.jdstop - pf.jdstop) * 86400.0);
+    maxmaxel = max(maxmaxel, fabs(pd.maxelevation - pf.maxelevation));
+    passes++;
+    delay(0);
+  }
+  Serial.printf("  %d passes        start %.2f s  stop %.2f s  max elevation %.4f deg\n",
+                passes, maxstart, maxstop, maxmaxel);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println();
+
+  satd.site(siteLat, siteLon, siteAlt);
+  satf.site(siteLat, siteLon, siteAlt);
+  satf.setfloat(true);
+
+  for (int n = 0; n < numtles; n++){
+    compare(n);
+  }
+  Serial.printf("float model %s\n", allok ? "ok" : "FAILED");
+}
+
+void loop() {
+
+}
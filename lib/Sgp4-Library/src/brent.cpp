@@ -11,7 +11,24 @@
 #define SHFT2(a,b,c) (a)=(b);(b)=(c);
 #define SHFT3(a,b,c,d) (a)=(b);(b)=(c);(c)=(d);
 
-double brentmin(double ax, double bx, double cx, double (Sgp4::*f)(double), double tol, double *xmin, Sgp4* obj)
+//member function of an Sgp4 object, called by the generic brentmin()
+struct sgp4member
+{
+  double (Sgp4::*f)(double);
+  Sgp4* obj;
+};
+
+static double callmember(double x, void* data){
+  sgp4member* m = (sgp4member*)data;
+  return (m->obj->*(m->f))(x);
+}
+
+double brentmin(double ax, double bx, double cx, double (Sgp4::*f)(double), double tol, double *xmin, Sgp4* obj){
+  sgp4member m = {f, obj};
+  return brentmin(ax, bx, cx, callmember, &m, tol, xmin);
+}
+
+double brentmin(double ax, double bx, double cx, double (*f)(double, void*), void* data, double tol, double *xmin)
 //Given a function f, and given a bracketing triplet of abscissas ax, bx, cx (such that bx is
 //between ax and cx, and f(bx) is less than both f(ax) and f(cx)), this routine isolates
 //the minimum to a fractional precision of about tol using Brent’s method. The abscissa of
@@ -26,7 +43,7 @@ double brentmin(double ax, double bx, double cx, double (Sgp4::*f)(double), doub
   a=(ax < cx ? ax : cx); //a and b must be in ascending order,
   b=(ax > cx ? ax : cx); //but input abscissas need not be.
   x=w=v=bx; //Initializations...
-  fw=fv=fx=(obj->*f)(x);
+  fw=fv=fx=(*f)(x, data);
   for (iter = 1; iter <= ITMAX; iter++) { //Main program loop.
       xm = 0.5*(a+b);
       tol2 = 2.0*(tol1=tol+ZEPS);       //2.0*(tol1=tol*fabs(x)+ZEPS);
@@ -57,7 +74,7 @@ double brentmin(double ax, double bx, double cx, double (Sgp4::*f)(double), doub
          d=C*(e=(x >= xm ? a-x : b-x));
       }
       u=(fabs(d) >= tol1 ? x+d : x+copysign(tol1,d));
-      fu=(obj->*f)(u);
+      fu=(*f)(u, data);
       //This is the one function evaluation per iteration.
       if (fu <= fx) { //Now decide what to do with our func
         if (u >= x) a=x; else b=x; //tion evaluation.
@@ -148,3 +165,65 @@ for (iter=1;iter<=ITMAX;iter++) {
 //nrerror("Maximum number of iterations exceeded in zbrent");
 return -1.0; //Never get here.
 }
+
+
+double rtsafe(void (Sgp4::*funcd)(double, double*, double*), double x1, double x2, double x0, const double* f1, double xacc, Sgp4* obj)
+//Using a combination of Newton-Raphson and bisection, find the root of a function bracketed
+//between x1 and x2. The root, returned as rtsafe, will be refined until its accuracy is known
+//within xacc. funcd is a user-supplied routine that returns both the function value and the
+//first derivative of the function.
+//The last call to funcd is always at the returned root, so the caller can read the state of
+//that evaluation (az/el, position) as zbrent allowed.
+{
+int j;
+double df,dx,dxold,f,fh,fl;
+double temp,xh,xl,rts,xe;
+
+if (f1 == NULL) (obj->*funcd)(x1,&fl,&df);
+else fl=*f1;
+(obj->*funcd)(x2,&fh,&df);
+if ((fl > 0.0 && fh > 0.0) || (fl < 0.0 && fh < 0.0))
+return -1.0;
+if (fl == 0.0) {
+  (obj->*funcd)(x1,&fl,&df); //x2 was evaluated last
+  return x1;
+}
+if (fh == 0.0) return x2;
+if (fl < 0.0) { //Orient the search so that f(xl) < 0.
+  xl=x1;
+  xh=x2;
+} else {
+  xh=x1;
+  xl=x2;
+}
+rts=x0; //Initialize the guess for root,
+dxold=fabs(x2-x1); //the "stepsize before last,"
+dx=dxold; //and the last step.
+(obj->*funcd)(rts,&f,&df);
+xe=rts; //Last evaluated point.
+for (j=1;j<=ITMAX;j++) { //Loop over allowed iterations.
+  if ((((rts-xh)*df-f)*((rts-xl)*df-f) > 0.0) //Bisect if Newton out of range,
+    || (fabs(2.0*f) > fabs(dxold*df))) { //or not decreasing fast enough.
+    dxold=dx;
+    dx=0.5*(xh-xl);
+    rts=xl+dx;
+    if (xl == rts) break; //Change in root is negligible.
+  } else { //Newton step acceptable. Take it.
+    dxold=dx;
+    dx=f/df;
+    temp=rts;
+    rts -= dx;
+    if (temp == rts) break;
+  }
+  if (fabs(dx) < xacc) break; //Convergence criterion.
+  (obj->*funcd)(rts,&f,&df); //The one new function evaluation per iteration.
+  xe=rts;
+  if (f < 0.0) //Maintain the bracket on the root.
+    xl=rts;
+  else
+    xh=rts;
+}
+if (j > ITMAX) return -1.0; //nrerror("Maximum number of iterations exceeded in rtsafe");
+if (rts != xe) (obj->*funcd)(rts,&f,&df); //Leave the state of the returned root in obj.
+return rts;
+}
@@ -10,8 +10,19 @@
 //returned function value.
 double brentmin(double ax, double bx, double cx, double (Sgp4::*f)(double), double tol, double *xmin,  Sgp4* obj);
 
+//Same for a plain function f(x, data), data is passed through unchanged (e.g. the distance
+//between two satellites of a group).
+double brentmin(double ax, double bx, double cx, double (*f)(double, void*), void* data, double tol, double *xmin);
+
 //Using Brent’s method, find the root of a function func known to lie between x1 and x2. The
 //root, returned as zbrent, will be refined until its accuracy is tol.
 double zbrent(double (Sgp4::*func)(double), double x1, double x2, double tol, Sgp4* obj);
 
+//Using a combination of Newton-Raphson and bisection, find the root of a function bracketed
+//between x1 and x2. The root, returned as rtsafe, will be refined until its accuracy is known
+//within xacc. funcd returns both the function value and the first derivative of the function.
+//x0 is the first guess, between x1 and x2 (the midpoint in Numerical Recipes). f1 points to the
+//value of the function at x1 when already known (saves one evaluation), NULL otherwise.
+double rtsafe(void (Sgp4::*funcd)(double, double*, double*), double x1, double x2, double x0, const double* f1, double xacc, Sgp4* obj);
+
 #endif
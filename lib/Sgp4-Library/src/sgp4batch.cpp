@@ -0,0 +1,317 @@
+/*
+This file contains a batched propagator for whole groups of satellites.
+The per-satellite constants of the near earth model are stored as contiguous arrays
+(structure of arrays) instead of one elsetrec per satellite, so a full group can be
+propagated to a single epoch in one call.
+Deep space objects are kept as regular elsetrec structures and use the standard sgp4 kernel
+selected for them when they are added.
+
+Based on the sgp4 procedure by David Vallado (sgp4unit.cpp).
+*/
+
+#include "sgp4batch.h"
+#include "sgp4ext.h"
+#include "sgp4io.h"
+#include "sgp4coord.h"
+#include <string.h>
+
+const int16_t Sgp4Batch::invalidslot;
+
+Sgp4Batch::Sgp4Batch(){
+   double tumin, mu, j3, j4, j3oj2;
+
+   opsmode = 'i';  //improved mode
+   whichconst = wgs84;   //newest constants
+   getgravconst( whichconst, tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2 );
+   vkmpersec = radiusearthkm * xke/60.0;
+}
+
+void Sgp4Batch::reserve(int count){
+  slot.reserve(count);   jdepoch.reserve(count);
+  mo.reserve(count);     mdot.reserve(count);    argpo.reserve(count);  argpdot.reserve(count);
+  nodeo.reserve(count);  nodedot.reserve(count); nodecf.reserve(count);
+  cc1.reserve(count);    bcc4.reserve(count);    bcc5.reserve(count);   t2cof.reserve(count);
+  t3cof.reserve(count);  t4cof.reserve(count);   t5cof.reserve(count);
+  omgcof.reserve(count); eta.reserve(count);     xmcof.reserve(count);  delmo.reserve(count);
+  sinmao.reserve(count); d2.reserve(count);      d3.reserve(count);     d4.reserve(count);
+  no.reserve(count);     ecco.reserve(count);    inclo.reserve(count);  am0.reserve(count);
+  sinio.reserve(count);  cosio.reserve(count);   aycof.reserve(count);  xlcof.reserve(count);
+  con41.reserve(count);  x1mth2.reserve(count);  x7thm1.reserve(count); isimp.reserve(count);
+}
+
+void Sgp4Batch::clear(){
+  slot.clear();   jdepoch.clear();
+  mo.clear();     mdot.clear();    argpo.clear();  argpdot.clear();
+  nodeo.clear();  nodedot.clear(); nodecf.clear();
+  cc1.clear();    bcc4.clear();    bcc5.clear();   t2cof.clear();
+  t3cof.clear();  t4cof.clear();   t5cof.clear();
+  omgcof.clear(); eta.clear();     xmcof.clear();  delmo.clear();
+  sinmao.clear(); d2.clear();      d3.clear();     d4.clear();
+  no.clear();     ecco.clear();    inclo.clear();  am0.clear();
+  sinio.clear();  cosio.clear();   aycof.clear();  xlcof.clear();
+  con41.clear();  x1mth2.clear();  x7thm1.clear(); isimp.clear();
+  deep.clear();   deepkernel.clear();
+}
+
+//add an initialised element set
+int Sgp4Batch::add(const elsetrec& satrec){
+
+  if (satrec.method == 'd'){
+    deep.push_back(satrec);
+    deepkernel.push_back(sgp4select(whichconst, satrec));
+    slot.push_back(-(int16_t)deep.size());
+  }else{
+    slot.push_back((int16_t)mo.size());
+
+    mo.push_back(satrec.mo);          mdot.push_back(satrec.mdot);
+    argpo.push_back(satrec.argpo);    argpdot.push_back(satrec.argpdot);
+    nodeo.push_back(satrec.nodeo);    nodedot.push_back(satrec.nodedot);
+    nodecf.push_back(satrec.nodecf);
+    cc1.push_back(satrec.cc1);
+    bcc4.push_back(satrec.bstar * satrec.cc4);
+    bcc5.push_back(satrec.bstar * satrec.cc5);
+    t2cof.push_back(satrec.t2cof);    t3cof.push_back(satrec.t3cof);
+    t4cof.push_back(satrec.t4cof);    t5cof.push_back(satrec.t5cof);
+    omgcof.push_back(satrec.omgcof);  eta.push_back(satrec.eta);
+    xmcof.push_back(satrec.xmcof);    delmo.push_back(satrec.delmo);
+    sinmao.push_back(satrec.sinmao);
+    d2.push_back(satrec.d2);          d3.push_back(satrec.d3);
+    d4.push_back(satrec.d4);
+    no.push_back(satrec.no);          ecco.push_back(satrec.ecco);
+    inclo.push_back(satrec.inclo);
+    am0.push_back(pow((xke / satrec.no), 2.0 / 3.0));  //mean motion is constant for near earth orbits
+    sinio.push_back(sin(satrec.inclo));
+    cosio.push_back(cos(satrec.inclo));
+    aycof.push_back(satrec.aycof);    xlcof.push_back(satrec.xlcof);
+    con41.push_back(satrec.con41);    x1mth2.push_back(satrec.x1mth2);
+    x7thm1.push_back(satrec.x7thm1);
+    isimp.push_back((uint8_t)satrec.isimp);
+  }
+  jdepoch.push_back(satrec.jdsatepoch);
+
+  return (int)slot.size() - 1;
+}
+
+//placeholder for an element set that could not be read, e.g. to keep the order of a satellite list
+int Sgp4Batch::addinvalid(){
+  slot.push_back(invalidslot);
+  jdepoch.push_back(0.0);
+  return (int)slot.size() - 1;
+}
+
+//parse and add 2 line elements, the input strings are not modified
+int Sgp4Batch::add(const char longstr1[], const char longstr2[]){
+  char line1[130];
+  char line2[130];
+  elsetrec satrec;
+
+  strncpy(line1, longstr1, sizeof(line1) - 1);
+  line1[sizeof(line1) - 1] = '\0';
+  strncpy(line2, longstr2, sizeof(line2) - 1);
+  line2[sizeof(line2) - 1] = '\0';
+  if (strlen(line1) < 69 || strlen(line2) < 69){
+    return -1;
+  }
+
+  twoline2rv(line1, line2, opsmode, whichconst, satrec);
+  if (satrec.error != 0){
+    return -1;
+  }
+  return add(satrec);
+}
+
+//near earth part of sgp4() working on the arrays, see sgp4unit.cpp for the description of the variables
+int Sgp4Batch::propagatenear(int k, double tsince, double r[3], double v[3]) const {
+
+  const double twopi = 2.0 * pi;
+  double am, axnl, aynl, betal, cos2u, coseo1, cossu, cosu, cnod, cosi,
+         delm, delomg, em, ecose, el2, eo1, esine, argpm, argpdf, pl, mrt,
+         mvt, rdotl, rl, rvdot, rvdotl, sin2u, sineo1, sinsu, sinu, snod, sini, su,
+         t2, t3, t4, tem5, temp, temp1, temp2, tempa, tempe, templ,
+         u, ux, uy, uz, vx, vy, vz, mm, nm, nodem, xinc, xl, xlm,
+         xmdf, xmx, xmy, nodedf, xnode, delmtemp;
+  int ktr;
+
+  /* ------- update for secular gravity and atmospheric drag ----- */
+  xmdf    = mo[k] + mdot[k] * tsince;
+  argpdf  = argpo[k] + argpdot[k] * tsince;
+  nodedf  = nodeo[k] + nodedot[k] * tsince;
+  argpm   = argpdf;
+  mm      = xmdf;
+  t2      = tsince * tsince;
+  nodem   = nodedf + nodecf[k] * t2;
+  tempa   = 1.0 - cc1[k] * tsince;
+  tempe   = bcc4[k] * tsince;
+  templ   = t2cof[k] * t2;
+
+  if (isimp[k] != 1)
+    {
+      delomg = omgcof[k] * tsince;
+      delmtemp =  1.0 + eta[k] * cos(xmdf);
+      delm   = xmcof[k] * (delmtemp * delmtemp * delmtemp - delmo[k]);
+      temp   = delomg + delm;
+      mm     = xmdf + temp;
+      argpm  = argpdf - temp;
+      t3     = t2 * tsince;
+      t4     = t3 * tsince;
+      tempa  = tempa - d2[k] * t2 - d3[k] * t3 - d4[k] * t4;
+      tempe  = tempe + bcc5[k] * (sin(mm) - sinmao[k]);
+      templ  = templ + t3cof[k] * t3 + t4 * (t4cof[k] + tsince * t5cof[k]);
+    }
+
+  if (no[k] <= 0.0)
+    {
+      return 2;
+    }
+  am = am0[k] * tempa * tempa;
+  nm = xke / (am * sqrt(am));
+  em = ecco[k] - tempe;
+
+  if ((em >= 1.0) || (em < -0.001))
+    {
+      return 1;
+    }
+  if (em < 1.0e-6)
+      em  = 1.0e-6;
+  mm     = mm + no[k] * templ;
+  xlm    = mm + argpm + nodem;
+
+  nodem  = floatmod(nodem, twopi);
+  argpm  = floatmod(argpm, twopi);
+  xlm    = floatmod(xlm, twopi);
+  mm     = floatmod(xlm - argpm - nodem, twopi);
+
+  /* -------------------- long period periodics ------------------ */
+  axnl = em * cos(argpm);
+  temp = 1.0 / (am * (1.0 - em * em));
+  aynl = em * sin(argpm) + temp * aycof[k];
+  xl   = mm + argpm + nodem + temp * xlcof[k] * axnl;
+
+  /* --------------------- solve kepler's equation --------------- */
+  u    = floatmod(xl - nodem, twopi);
+  eo1  = u;
+  tem5 = 9999.9;
+  ktr = 1;
+  while (( fabs(tem5) >= 1.0e-12) && (ktr <= 10) )
+    {
+      sineo1 = sin(eo1);
+      coseo1 = cos(eo1);
+      tem5   = 1.0 - coseo1 * axnl - sineo1 * aynl;
+      tem5   = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+      if(fabs(tem5) >= 0.95)
+          tem5 = tem5 > 0.0 ? 0.95 : -0.95;
+      eo1    = eo1 + tem5;
+      ktr = ktr + 1;
+    }
+
+  /* ------------- short period preliminary quantities ----------- */
+  ecose = axnl*coseo1 + aynl*sineo1;
+  esine = axnl*sineo1 - aynl*coseo1;
+  el2   = axnl*axnl + aynl*aynl;
+  pl    = am*(1.0-el2);
+  if (pl < 0.0)
+    {
+      return 4;
+    }
+
+  rl     = am * (1.0 - ecose);
+  rdotl  = sqrt(am) * esine/rl;
+  rvdotl = sqrt(pl) / rl;
+  betal  = sqrt(1.0 - el2);
+  temp   = esine / (1.0 + betal);
+  sinu   = am / rl * (sineo1 - aynl - axnl * temp);
+  cosu   = am / rl * (coseo1 - axnl + aynl * temp);
+  su     = atan2(sinu, cosu);
+  sin2u  = (cosu + cosu) * sinu;
+  cos2u  = 1.0 - 2.0 * sinu * sinu;
+  temp   = 1.0 / pl;
+  temp1  = 0.5 * j2 * temp;
+  temp2  = temp1 * temp;
+
+  /* -------------- update for short period periodics ------------ */
+  mrt   = rl * (1.0 - 1.5 * temp2 * betal * con41[k]) +
+          0.5 * temp1 * x1mth2[k] * cos2u;
+  su    = su - 0.25 * temp2 * x7thm1[k] * sin2u;
+  xnode = nodem + 1.5 * temp2 * cosio[k] * sin2u;
+  xinc  = inclo[k] + 1.5 * temp2 * cosio[k] * sinio[k] * cos2u;
+  mvt   = rdotl - nm * temp1 * x1mth2[k] * sin2u / xke;
+  rvdot = rvdotl + nm * temp1 * (x1mth2[k] * cos2u + 1.5 * con41[k]) / xke;
+
+  /* --------------------- orientation vectors ------------------- */
+  sinsu =  sin(su);
+  cossu =  cos(su);
+  snod  =  sin(xnode);
+  cnod  =  cos(xnode);
+  sini  =  sin(xinc);
+  cosi  =  cos(xinc);
+  xmx   = -snod * cosi;
+  xmy   =  cnod * cosi;
+  ux    =  xmx * sinsu + cnod * cossu;
+  uy    =  xmy * sinsu + snod * cossu;
+  uz    =  sini * sinsu;
+  vx    =  xmx * cossu - cnod * sinsu;
+  vy    =  xmy * cossu - snod * sinsu;
+  vz    =  sini * cossu;
+
+  /* --------- position and velocity (in km and km/sec) ---------- */
+  r[0] = (mrt * ux)* radiusearthkm;
+  r[1] = (mrt * uy)* radiusearthkm;
+  r[2] = (mrt * uz)* radiusearthkm;
+  v[0] = (mvt * ux + rvdot * vx) * vkmpersec;
+  v[1] = (mvt * uy + rvdot * vy) * vkmpersec;
+  v[2] = (mvt * uz + rvdot * vz) * vkmpersec;
+
+  // decaying satellite
+  if (mrt < 1.0)
+    {
+      return 6;
+    }
+  return 0;
+}
+
+//propagate every satellite to julian date jd
+int Sgp4Batch::propagate(double jd, double r[][3], double v[][3], int8_t error[]){
+  int count = (int)slot.size();
+  int ok = 0;
+  int8_t err;
+
+  for (int i = 0; i < count; i++){
+    double tsince = (jd - jdepoch[i]) * 24.0 * 60.0;
+    int k = slot[i];
+    if (k >= 0){
+      err = (int8_t)propagatenear(k, tsince, r[i], v[i]);
+    }else if (k == invalidslot){
+      r[i][0] = r[i][1] = r[i][2] = 0.0;
+      v[i][0] = v[i][1] = v[i][2] = 0.0;
+      err = 1;
+    }else{
+      elsetrec& satrec = deep[-k - 1];
+      sgp4(deepkernel[-k - 1], satrec, tsince, r[i], v[i]);
+      err = (int8_t)satrec.error;
+    }
+    if (error) error[i] = err;
+    if (err == 0) ok++;
+  }
+  return ok;
+}
+
+int Sgp4Batch::propagate(unsigned long unixtime, double r[][3], double v[][3], int8_t error[]){
+  return propagate(getJulianFromUnix(unixtime), r, v, error);
+}
+
+//propagate one satellite to julian date jd
+int Sgp4Batch::state(int index, double jd, double r[3], double v[3]){
+  double tsince = (jd - jdepoch[index]) * 24.0 * 60.0;
+  int k = slot[index];
+  if (k >= 0){
+    return propagatenear(k, tsince, r, v);
+  }
+  if (k == invalidslot){
+    r[0] = r[1] = r[2] = 0.0;
+    v[0] = v[1] = v[2] = 0.0;
+    return 1;
+  }
+  elsetrec& satrec = deep[-k - 1];
+  sgp4(deepkernel[-k - 1], satrec, tsince, r, v);
+  return satrec.error;
+}
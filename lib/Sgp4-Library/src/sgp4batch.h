@@ -0,0 +1,67 @@
+/*
+This file contains a batched propagator for whole groups of satellites.
+The per-satellite constants of the near earth model are stored as contiguous arrays
+(structure of arrays) instead of one elsetrec per satellite, so a full group can be
+propagated to a single epoch in one call.
+Deep space objects are kept as regular elsetrec structures and use the standard sgp4 kernel
+selected for them when they are added.
+
+Based on the sgp4 procedure by David Vallado (sgp4unit.cpp).
+*/
+
+#ifndef _sgp4batch_
+#define _sgp4batch_
+
+#include "sgp4unit.h"
+#include <stdint.h>
+#include <vector>
+
+class Sgp4Batch {
+    gravconsttype whichconst;
+    char opsmode;
+    double xke, j2, radiusearthkm, vkmpersec;   // gravity constants, looked up once
+
+    // one entry per satellite, in the order they were added
+    std::vector<int16_t> slot;        // >= 0 index in the near earth arrays, < 0 -(index+1) in deep, or invalidslot
+    std::vector<double>  jdepoch;     // julian date of the element set epoch
+
+    // near earth constants (structure of arrays)
+    std::vector<double> mo, mdot, argpo, argpdot, nodeo, nodedot, nodecf;
+    std::vector<double> cc1, bcc4, bcc5, t2cof, t3cof, t4cof, t5cof;
+    std::vector<double> omgcof, eta, xmcof, delmo, sinmao, d2, d3, d4;
+    std::vector<double> no, ecco, inclo, am0, sinio, cosio;
+    std::vector<double> aycof, xlcof, con41, x1mth2, x7thm1;
+    std::vector<uint8_t> isimp;
+
+    // deep space objects and their kernels, chosen once by add()
+    std::vector<elsetrec> deep;
+    std::vector<sgp4kernel> deepkernel;
+
+    static const int16_t invalidslot = -32768;   // placeholder of addinvalid() (below any deep index of a real group)
+
+    int propagatenear(int k, double tsince, double r[3], double v[3]) const;  //returns the sgp4 error code
+
+  public:
+    Sgp4Batch();
+
+    void reserve(int count);
+    void clear();
+    int size() const { return (int)slot.size(); }
+    int deepcount() const { return (int)deep.size(); }
+
+    int add(const elsetrec& satrec);                                  // add an initialised element set, returns its index
+    int add(const char longstr1[], const char longstr2[]);            // parse and add 2 line elements, returns its index or -1
+    int addinvalid();                                                 // placeholder that keeps the indices of a group aligned,
+                                                                      // always propagates with error 1 and zero r, v
+
+    // propagate every satellite to julian date jd
+    // r, v [km, km/s] and error (optional) must hold size() entries, returns the number of satellites without error
+    int propagate(double jd, double r[][3], double v[][3], int8_t error[]);
+    int propagate(unsigned long unixtime, double r[][3], double v[][3], int8_t error[]);
+
+    // propagate one satellite (index returned by add()) to julian date jd, r, v [km, km/s]
+    // returns the sgp4 error code, 0 when ok
+    int state(int index, double jd, double r[3], double v[3]);
+};
+
+#endif
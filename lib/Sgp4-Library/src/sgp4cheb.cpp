@@ -0,0 +1,155 @@
+/*
+This file contains a compact ephemeris for one satellite made of piecewise Chebyshev polynomials.
+
+Written for the ORBITSCOUT tracker.
+*/
+
+#include "sgp4cheb.h"
+#include "sgp4ext.h"
+#include "sgp4coord.h"
+#include <math.h>
+
+Sgp4Cheb::Sgp4Cheb(){
+  degree = 0;
+  segments = 0;
+  jdstart = 0.0;
+  seglen = 0.0;
+  sitelat = sitelon = sitealt = 0.0;
+  observerframe(0.0, 0.0, 0.0, jdstart, frame);
+}
+
+void Sgp4Cheb::clear(){
+  coef.clear();
+  segments = 0;
+}
+
+//sample every segment at the chebyshev nodes and take the discrete cosine transform
+bool Sgp4Cheb::fit(elsetrec& satrec, double jd, double hours, double segmentminutes, int deg){
+
+  double r[3], v[3], recef[3];
+  sgp4kernel kernel = sgp4select(wgs84, satrec);
+  std::vector<double> nodes(deg * deg);   //cos(pi * j * (k + 0.5) / deg)
+  std::vector<double> samples(deg * 3);
+
+  clear();
+  if (deg < 2 || hours <= 0.0 || segmentminutes <= 0.0){
+    return false;
+  }
+
+  degree   = deg;
+  jdstart  = jd;
+  seglen   = segmentminutes / 1440.0;
+  segments = (int)ceil(hours * 60.0 / segmentminutes);
+  coef.resize((size_t)segments * 3 * degree);
+
+  for (int j = 0; j < degree; j++){
+    for (int k = 0; k < degree; k++){
+      nodes[j * degree + k] = cos(pi * j * (k + 0.5) / degree);
+    }
+  }
+
+  for (int s = 0; s < segments; s++){
+    double jdseg = jdstart + s * seglen;
+
+    for (int k = 0; k < degree; k++){
+      double jdk = jdseg + 0.5 * seglen * (nodes[degree + k] + 1.0);   //row 1 holds the nodes themselves
+      sgp4(kernel, satrec, (jdk - satrec.jdsatepoch) * 1440.0, r, v);
+      if (satrec.error != 0){
+        clear();
+        return false;
+      }
+      teme2ecef(r, jdk, recef);
+      samples[k * 3 + 0] = recef[0];
+      samples[k * 3 + 1] = recef[1];
+      samples[k * 3 + 2] = recef[2];
+    }
+
+    float* c = &coef[(size_t)s * 3 * degree];
+    for (int i = 0; i < 3; i++){
+      for (int j = 0; j < degree; j++){
+        double sum = 0.0;
+        for (int k = 0; k < degree; k++){
+          sum += samples[k * 3 + i] * nodes[j * degree + k];
+        }
+        sum *= 2.0 / degree;
+        if (j == 0) sum *= 0.5;
+        c[i * degree + j] = (float)sum;
+      }
+    }
+  }
+  return true;
+}
+
+bool Sgp4Cheb::fit(elsetrec& satrec, unsigned long unixtime, double hours, double segmentminutes, int deg){
+  return fit(satrec, getJulianFromUnix(unixtime), hours, segmentminutes, deg);
+}
+
+bool Sgp4Cheb::covers(double jd) const {
+  return segments > 0 && jd >= jdstart && jd <= jdstart + segments * seglen;
+}
+
+bool Sgp4Cheb::covers(unsigned long unixtime) const {
+  return covers(getJulianFromUnix(unixtime));
+}
+
+void Sgp4Cheb::site(double lat, double lon, double alt){
+  if (lat == sitelat && lon == sitelon && alt == sitealt){
+    return;
+  }
+  sitelat = lat;
+  sitelon = lon;
+  sitealt = alt;
+
+  observerframe(lat * pi / 180.0, lon * pi / 180.0, alt / 1000.0, jdstart, frame);
+}
+
+//clenshaw recurrence on the segment containing jd
+bool Sgp4Cheb::position(double jd, double recef[3]) const {
+
+  if (!covers(jd)){
+    return false;
+  }
+
+  double x = (jd - jdstart) / seglen;
+  int s = (int)x;
+  if (s >= segments) s = segments - 1;   //end of the window
+  float tau  = (float)(2.0 * (x - s) - 1.0);
+  float tau2 = tau + tau;
+  const float* c = &coef[(size_t)s * 3 * degree];
+
+  for (int i = 0; i < 3; i++, c += degree){
+    float b0, b1 = 0.0f, b2 = 0.0f;
+    for (int j = degree - 1; j > 0; j--){
+      b0 = tau2 * b1 - b2 + c[j];
+      b2 = b1;
+      b1 = b0;
+    }
+    recef[i] = tau * b1 - b2 + c[0];
+  }
+  return true;
+}
+
+bool Sgp4Cheb::azel(double jd, double& az, double& el, double* range) const {
+
+  double recef[3], rho[3];
+
+  if (!position(jd, recef)){
+    return false;
+  }
+
+  //topocentric horizon system (sez)
+  for (int i = 0; i < 3; i++){
+    rho[i] = frame.sez[i][0] * recef[0] + frame.sez[i][1] * recef[1] + frame.sez[i][2] * recef[2] - frame.rssez[i];
+  }
+
+  az = floatmod(atan2(rho[1], -rho[0]) * 180 / pi + 360.0, 360.0);
+  el = atan2(rho[2], sqrt(rho[0] * rho[0] + rho[1] * rho[1])) * 180 / pi;
+  if (range){
+    *range = mag(rho);
+  }
+  return true;
+}
+
+bool Sgp4Cheb::azel(unsigned long unixtime, double& az, double& el, double* range) const {
+  return azel(getJulianFromUnix(unixtime), az, el, range);
+}
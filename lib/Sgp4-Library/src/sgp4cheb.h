@@ -0,0 +1,56 @@
+/*
+This file contains a compact ephemeris for one satellite made of piecewise Chebyshev polynomials.
+The earth fixed (ECEF) position is sampled with sgp4() over a time window, split into segments of
+equal length and fitted per coordinate. Evaluating the polynomials is much cheaper than a full
+propagation, which makes it suitable for live displays that need the position many times per second.
+
+Coefficients are stored as floats: segments * 3 * degree values (e.g. 24 hours, 45 minute segments,
+degree 12 => 1152 floats, 4.5 kB). With float coefficients the fit error for a LEO satellite is about 1 m.
+
+Written for the ORBITSCOUT tracker, see examples/Sgp4ChebBench for the fit error and query speed.
+*/
+
+#ifndef _sgp4cheb_
+#define _sgp4cheb_
+
+#include "sgp4unit.h"
+#include "sgp4coord.h"
+#include <stddef.h>
+#include <vector>
+
+class Sgp4Cheb {
+    int degree;        //coefficients per coordinate and segment
+    int segments;      //number of segments
+    double jdstart;    //start of the window (julian date)
+    double seglen;     //segment length (days)
+    std::vector<float> coef;  //[segment][coordinate][degree]
+
+    ObserverFrame frame;   //site position and ECEF => SEZ rotation, the fit is already earth fixed
+    double sitelat, sitelon, sitealt;   //site of the frame [degrees, degrees, meters]
+
+  public:
+    Sgp4Cheb();
+
+    // fit the window [jd, jd + hours] with segments of segmentminutes and degree coefficients per coordinate
+    // satrec is propagated with sgp4() (wgs84), returns false on a propagation error
+    bool fit(elsetrec& satrec, double jd, double hours, double segmentminutes = 45.0, int degree = 12);
+    bool fit(elsetrec& satrec, unsigned long unixtime, double hours, double segmentminutes = 45.0, int degree = 12);
+    void clear();
+
+    bool covers(double jd) const;     //true if jd is inside the fitted window
+    bool covers(unsigned long unixtime) const;
+
+    // site latitude[degrees], longitude[degrees] and altitude[meters], can be called with every gps fix:
+    // the fit is earth fixed and stays valid, only the frame is rebuilt when the site moved
+    void site(double lat, double lon, double alt);
+
+    bool position(double jd, double recef[3]) const;  //earth fixed position [km]
+    bool azel(double jd, double& az, double& el, double* range = NULL) const;  //azimuth, elevation [degrees], range [km]
+    bool azel(unsigned long unixtime, double& az, double& el, double* range = NULL) const;
+
+    int size() const { return segments; }
+    size_t bytes() const { return coef.size() * sizeof(float); }   //memory used by the coefficients
+    const float* data() const { return coef.data(); }
+};
+
+#endif
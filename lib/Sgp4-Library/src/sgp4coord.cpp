@@ -29,7 +29,60 @@ recef           Position vector (ECEF)          km
 vecef           Velocity vector (ECEF)          km/s
 */
 
-//void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3])
+void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3])
+{
+    double gmst;
+    double st[3][3];
+    double rpef[3];
+    double vpef[3];
+    double pm[3][3];
+    double omegaearth[3];
+    
+    //Get Greenwich mean sidereal time
+    gmst = gstime(jdut1);
+    
+    //st is the pef - tod matrix
+    st[0][0] = cos(gmst);
+    st[0][1] = -sin(gmst);
+    st[0][2] = 0.0;
+    st[1][0] = sin(gmst);
+    st[1][1] = cos(gmst);
+    st[1][2] = 0.0;
+    st[2][0] = 0.0;
+    st[2][1] = 0.0;
+    st[2][2] = 1.0;
+    
+    //Get pseudo earth fixed position vector by multiplying the inverse pef-tod matrix by rteme
+    rpef[0] = st[0][0] * rteme[0] + st[1][0] * rteme[1] + st[2][0] * rteme[2];
+    rpef[1] = st[0][1] * rteme[0] + st[1][1] * rteme[1] + st[2][1] * rteme[2];
+    rpef[2] = st[0][2] * rteme[0] + st[1][2] * rteme[1] + st[2][2] * rteme[2];
+    
+    //Get polar motion vector
+    polarm(jdut1, pm);
+    
+    //ECEF postion vector is the inverse of the polar motion vector multiplied by rpef
+    recef[0] = pm[0][0] * rpef[0] + pm[1][0] * rpef[1] + pm[2][0] * rpef[2];
+    recef[1] = pm[0][1] * rpef[0] + pm[1][1] * rpef[1] + pm[2][1] * rpef[2];
+    recef[2] = pm[0][2] * rpef[0] + pm[1][2] * rpef[1] + pm[2][2] * rpef[2];
+    
+    //Earth's angular rotation vector (omega)
+    //Note: I don't have a good source for LOD. Historically it has been on the order of 2 ms so I'm just using that as a constant. The effect is very small.
+    omegaearth[0] = 0.0;
+    omegaearth[1] = 0.0;
+    omegaearth[2] = 7.29211514670698e-05 * (1.0  - 0.0015563/86400.0);
+    
+    //Pseudo Earth Fixed velocity vector is st'*vteme - omegaearth X rpef
+    vpef[0] = st[0][0] * vteme[0] + st[1][0] * vteme[1] + st[2][0] * vteme[2] - (omegaearth[1]*rpef[2] - omegaearth[2]*rpef[1]);
+    vpef[1] = st[0][1] * vteme[0] + st[1][1] * vteme[1] + st[2][1] * vteme[2] - (omegaearth[2]*rpef[0] - omegaearth[0]*rpef[2]);
+    vpef[2] = st[0][2] * vteme[0] + st[1][2] * vteme[1] + st[2][2] * vteme[2] - (omegaearth[0]*rpef[1] - omegaearth[1]*rpef[0]);
+    
+    //ECEF velocty vector is the inverse of the polar motion vector multiplied by vpef
+    vecef[0] = pm[0][0] * vpef[0] + pm[1][0] * vpef[1] + pm[2][0] * vpef[2];
+    vecef[1] = pm[0][1] * vpef[0] + pm[1][1] * vpef[1] + pm[2][1] * vpef[2];
+    vecef[2] = pm[0][2] * vpef[0] + pm[1][2] * vpef[1] + pm[2][2] * vpef[2];
+}
+
+//position only, see above
 void teme2ecef(double rteme[3], double jdut1, double recef[3])
 {
     double gmst;
@@ -136,6 +189,12 @@ given the ECEF position matrix.
 Author: David Vallado, 2007
 Ported to C++ by Grady Hillhouse with some modifications, July 2015.
 
+The iteration on the geodetic latitude (up to 10 sin/sqrt/atan steps) is
+replaced by the closed form of H. Vermeille, "An analytical method to transform
+geocentric into geodetic coordinates", J. Geodesy 85 (2011). It is exact up to
+rounding (below 1e-9 km for positions from the surface to GEO) for every point
+further than about 43 km from the center of the earth.
+
 INPUTS          DESCRIPTION                     RANGE/UNITS
 r               Position matrix (ECEF)          km
 
@@ -145,62 +204,37 @@ latlongh        Latitude, longitude, and altitude (rad, rad, and km)
 
 void ijk2ll(double r[3], double latlongh[3])
 {
-    double twopi = 2.0*pi;
     double small = 0.00000001;          //small value for tolerances
     double re = 6378.137;               //radius of earth in km
     double eesqrd = 0.006694385000;     //eccentricity of earth sqrd
-    double magr, temp, rtasc;
+    double e4 = eesqrd * eesqrd;
+    double temp, p, q, rr, s, t, u, v, w, k, d, dz;
     
-    magr = mag(r);
     temp = sqrt(r[0]*r[0] + r[1]*r[1]);
- 
+    
     if(fabs(temp) < small)
     {
-        rtasc = sgn(r[2]) * pi * 0.5;
+        latlongh[1] = sgn(r[2]) * pi * 0.5;
     }
     else
     {
-        rtasc = atan2(r[1], r[0]);
-    }
-    
-    latlongh[1] = rtasc;
-    
-    if (fabs(latlongh[1]) >= pi)
-    {
-        if (latlongh[1] < 0.0)
-        {
-            latlongh[1] += twopi;
-        }
-        else
-        {
-            latlongh[1] -= twopi;
-        }
-    }
-    
-    latlongh[0] = asin(r[2] / magr);
-    
-    //Iterate to find geodetic latitude
-    int i = 1;
-    double olddelta = latlongh[0] + 10.0;
-    double sintemp, c = 0;
-    
-    while ( (fabs(olddelta - latlongh[0]) >= small) && (i < 10) )
-    {
-        olddelta = latlongh[0];
-        sintemp = sin(latlongh[0]);
-        c = re / sqrt(1.0 - eesqrd*sintemp*sintemp);
-        latlongh[0] = atan( (r[2] + c*eesqrd*sintemp) / temp );
-        i++;
+        latlongh[1] = atan2(r[1], r[0]);    //-pi to pi
     }
     
-    if (0.5*pi - fabs(latlongh[0]) > pi/180.0)
-    {
-        latlongh[2] = (temp/cos(latlongh[0])) - c;
-    }
-    else
-    {
-        latlongh[2] = r[2]/sin(latlongh[0]) - c*(1.0 - eesqrd);
-    }
+    p = temp * temp / (re * re);
+    q = (1.0 - eesqrd) * r[2] * r[2] / (re * re);
+    rr = (p + q - e4) / 6.0;
+    s = e4 * p * q / (4.0 * rr * rr * rr);
+    t = cbrt(1.0 + s + sqrt(s * (2.0 + s)));
+    u = rr * (1.0 + t + 1.0 / t);
+    v = sqrt(u * u + e4 * q);
+    w = eesqrd * (u + v - q) / (2.0 * v);
+    k = sqrt(u + v + w * w) - w;
+    d = k * temp / (k + eesqrd);
+    dz = sqrt(d * d + r[2] * r[2]);
+    
+    latlongh[0] = 2.0 * atan2(r[2], d + dz);
+    latlongh[2] = (k + eesqrd - 1.0) / k * dz;
 }
 
 /*
@@ -270,7 +304,91 @@ razel           Range, azimuth, and elevation matrix
 razelrates      Range rate, azimuth rate, and elevation rate matrix
 */
 
-//void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3])
+void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3])
+{
+    //Locals
+    double halfpi = pi * 0.5;
+    double small  = 0.00000001;
+    double temp;
+    double rs[3];
+    double recef[3];
+    double vecef[3];
+    double rhoecef[3];
+    double drhoecef[3];
+    double tempvec[3];
+    double rhosez[3];
+    double drhosez[3];
+    double magrhosez;
+    double rho, az, el;
+    double drho, daz, del;
+    
+    //Get site vector in ECEF coordinate system, the site velocity is zero in this frame
+    site(latgd, lon, alt, rs);
+    
+    //Convert TEME vectors to ECEF coordinate system
+    teme2ecef(ro, vo, jdut1, recef, vecef);
+    
+    //Find ECEF range vectors
+    for (int i = 0; i < 3; i++)
+    {
+        rhoecef[i] = recef[i] - rs[i];
+        drhoecef[i] = vecef[i];
+    }
+    rho = mag(rhoecef); //Range in km
+    
+    //Convert to SEZ (topocentric horizon coordinate system)
+    rot3(rhoecef, lon, tempvec);
+    rot2(tempvec, (halfpi-latgd), rhosez);
+    
+    rot3(drhoecef, lon, tempvec);
+    rot2(tempvec, (halfpi-latgd), drhosez);
+    
+    //Calculate azimuth, and elevation
+    temp = sqrt(rhosez[0]*rhosez[0] + rhosez[1]*rhosez[1]);
+    if (temp < small)
+    {
+        el = sgn(rhosez[2]) * halfpi;
+        az = atan2(drhosez[1], -drhosez[0]);
+    }
+    else
+    {
+        magrhosez = mag(rhosez);
+        el = asin(rhosez[2]/magrhosez);
+        az = atan2(rhosez[1], -rhosez[0]);
+    }
+    
+    //Calculate rates for range, azimuth, and elevation
+    drho = dot(rhosez,drhosez) / rho;
+    
+    if(fabs(temp*temp) > small)
+    {
+        daz = (drhosez[0]*rhosez[1] - drhosez[1]*rhosez[0]) / (temp * temp);
+    }
+    else
+    {
+        daz = 0.0;
+    }
+    
+    if(fabs(temp) > small)
+    {
+        del = (drhosez[2] - drho*sin(el)) / temp;
+    }
+    else
+    {
+        del = 0.0;
+    }
+
+    //Move values to output vectors
+    razel[0] = rho;             //Range (km)
+    razel[1] = az;              //Azimuth (radians)
+    razel[2] = el;              //Elevation (radians)
+    
+    razelrates[0] = drho;       //Range rate (km/s)
+    razelrates[1] = daz;        //Azimuth rate (rad/s)
+    razelrates[2] = del;        //Elevation rate (rad/s)
+}
+
+//position only, see above
 void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, double razel[3])
 {
     //Locals
@@ -360,6 +478,273 @@ void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, d
     //razelrates[2] = del;        //Elevation rate (rad/s)
 }
 
+/*
+observerframe
+
+This function builds the site data used by the rv2azel versions with an
+ObserverFrame: the site vector and the ECEF => SEZ rotation (rot3(lon) followed
+by rot2(pi/2 - lat)) are computed once instead of on every call. The polar
+motion matrix of jdut1 is combined with the SEZ rotation, see observerpolar().
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+latgd           Site geodetic latitude          -pi/2 to pi/2 in radians
+lon             Site longitude                  -2pi to 2pi in radians
+alt             Site altitude                   km
+jdut1           Julian date for polar motion    days
+
+OUTPUTS         DESCRIPTION
+frame           Site vector and rotation matrices
+*/
+
+void observerframe(double latgd, double lon, double alt, double jdut1, ObserverFrame& frame)
+{
+    double sinlat = sin(latgd);
+    double coslat = cos(latgd);
+    double sinlon = sin(lon);
+    double coslon = cos(lon);
+    
+    frame.latgd = latgd;
+    frame.lon = lon;
+    frame.alt = alt;
+    site(latgd, lon, alt, frame.rs);
+    
+    frame.sez[0][0] =  sinlat * coslon;
+    frame.sez[0][1] =  sinlat * sinlon;
+    frame.sez[0][2] = -coslat;
+    frame.sez[1][0] = -sinlon;
+    frame.sez[1][1] =  coslon;
+    frame.sez[1][2] =  0.0;
+    frame.sez[2][0] =  coslat * coslon;
+    frame.sez[2][1] =  coslat * sinlon;
+    frame.sez[2][2] =  sinlat;
+    
+    for (int i = 0; i < 3; i++)
+    {
+        frame.rssez[i] = frame.sez[i][0] * frame.rs[0] + frame.sez[i][1] * frame.rs[1] + frame.sez[i][2] * frame.rs[2];
+    }
+    
+    observerpolar(frame, jdut1);
+}
+
+/*
+observerpolar
+
+Updates the polar motion part of an ObserverFrame. Polar motion changes less
+than a milliarcsecond per day (a few cm at LEO distance), so updating it once
+a day is enough.
+*/
+
+void observerpolar(ObserverFrame& frame, double jdut1)
+{
+    double pm[3][3];
+    
+    polarm(jdut1, pm);
+    frame.pmjd = jdut1;
+    
+    //ecef = pm' * pef, so pez = sez * pm'
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            frame.pez[i][j] = frame.sez[i][0] * pm[j][0] + frame.sez[i][1] * pm[j][1] + frame.sez[i][2] * pm[j][2];
+        }
+    }
+}
+
+/*
+gmstsweep, gmstnext
+
+Greenwich sidereal time for samples at a fixed step. gmstsweep() evaluates
+gstime() once and the rotation per step from the derivative of the gstime
+polynomial, gmstnext() advances cos/sin of gmst with the angle addition
+formulas. The magnitude is re-normalised every gmstrenorm steps, the rounding
+of the phase grows by about 1e-16 rad per step (1e-12 rad after a day of 10 s
+steps). The change of the sidereal rate over a day is below 1e-10 rad.
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+jdstart         Julian date of the first sample days
+jdstep          Step between the samples        days
+
+OUTPUTS         DESCRIPTION
+sweep           jd, cos and sin of gmst of the current sample
+*/
+
+#define gmstrenorm 16
+
+void gmstsweep(double jdstart, double jdstep, GmstSweep& sweep)
+{
+    const double deg2rad = pi / 180.0;
+    double tut1, rate, gmst, step;
+    
+    //d(gstime)/d(tut1) in seconds per julian century, see gstime
+    tut1 = (jdstart - 2451545.0) / 36525.0;
+    rate = -3.0 * 6.2e-6 * tut1 * tut1 + 2.0 * 0.093104 * tut1 + (876600.0*3600 + 8640184.812866);
+    step = rate * (jdstep / 36525.0) * deg2rad / 240.0;
+    
+    gmst = gstime(jdstart);
+    sweep.jdstart = jdstart;
+    sweep.jdstep = jdstep;
+    sweep.jd = jdstart;
+    sweep.steps = 0;
+    sweep.ct = cos(gmst);
+    sweep.st = sin(gmst);
+    sweep.cstep = cos(step);
+    sweep.sstep = sin(step);
+}
+
+void gmstnext(GmstSweep& sweep)
+{
+    double ct = sweep.ct * sweep.cstep - sweep.st * sweep.sstep;
+    double st = sweep.st * sweep.cstep + sweep.ct * sweep.sstep;
+    
+    sweep.steps++;
+    if (sweep.steps % gmstrenorm == 0)
+    {
+        double norm = 1.0 / sqrt(ct * ct + st * st);
+        ct *= norm;
+        st *= norm;
+    }
+    sweep.ct = ct;
+    sweep.st = st;
+    sweep.jd = sweep.jdstart + sweep.steps * sweep.jdstep;
+}
+
+/*
+rv2azel (ObserverFrame)
+
+Same as rv2azel, with the site data taken from an ObserverFrame. Per call only
+the sidereal time is evaluated (or taken from a GmstSweep), the rest are
+multiply-adds. The rates are only calculated if vo is not NULL.
+*/
+
+static void sezlook(const double ro[3], const double vo[3], const ObserverFrame& frame, double ct, double st, double razel[3], double razelrates[3])
+{
+    const double omegaearth = 7.29211514670698e-05 * (1.0  - 0.0015563/86400.0);  //see teme2ecef
+    double temp;
+    double rpef[3], vpef[3], rhosez[3], drhosez[3];
+    
+    //teme => pef
+    rpef[0] =  ct * ro[0] + st * ro[1];
+    rpef[1] = -st * ro[0] + ct * ro[1];
+    rpef[2] =  ro[2];
+    
+    //pef => sez, relative to the site
+    for (int i = 0; i < 3; i++)
+    {
+        rhosez[i] = frame.pez[i][0] * rpef[0] + frame.pez[i][1] * rpef[1] + frame.pez[i][2] * rpef[2] - frame.rssez[i];
+    }
+    
+    razel[0] = mag(rhosez);
+    temp = sqrt(rhosez[0]*rhosez[0] + rhosez[1]*rhosez[1]);
+    
+    if (vo == NULL)
+    {
+        if (temp < 0.00000001)
+        {
+            razel[1] = NAN;
+            razel[2] = sgn(rhosez[2]) * pi * 0.5;
+        }
+        else
+        {
+            razel[1] = atan2(rhosez[1], -rhosez[0]);
+            razel[2] = asin(rhosez[2] / razel[0]);
+        }
+        return;
+    }
+    
+    //the velocity includes the rotation of the earth
+    vpef[0] =  ct * vo[0] + st * vo[1] + omegaearth * rpef[1];
+    vpef[1] = -st * vo[0] + ct * vo[1] - omegaearth * rpef[0];
+    vpef[2] =  vo[2];
+    for (int i = 0; i < 3; i++)
+    {
+        drhosez[i] = frame.pez[i][0] * vpef[0] + frame.pez[i][1] * vpef[1] + frame.pez[i][2] * vpef[2];
+    }
+    
+    if (temp < 0.00000001)
+    {
+        razel[1] = atan2(drhosez[1], -drhosez[0]);
+        razel[2] = sgn(rhosez[2]) * pi * 0.5;
+    }
+    else
+    {
+        razel[1] = atan2(rhosez[1], -rhosez[0]);
+        razel[2] = asin(rhosez[2] / razel[0]);
+    }
+    
+    //rates, see rv2azel
+    razelrates[0] = (rhosez[0]*drhosez[0] + rhosez[1]*drhosez[1] + rhosez[2]*drhosez[2]) / razel[0];
+    if (temp*temp > 0.00000001)
+    {
+        razelrates[1] = (drhosez[0]*rhosez[1] - drhosez[1]*rhosez[0]) / (temp * temp);
+    }
+    else
+    {
+        razelrates[1] = 0.0;
+    }
+    if (temp > 0.00000001)
+    {
+        razelrates[2] = (drhosez[2] - razelrates[0]*sin(razel[2])) / temp;
+    }
+    else
+    {
+        razelrates[2] = 0.0;
+    }
+}
+
+void rv2azel(const double ro[3], const ObserverFrame& frame, double jdut1, double razel[3])
+{
+    double gmst = gstime(jdut1);
+    sezlook(ro, NULL, frame, cos(gmst), sin(gmst), razel, NULL);
+}
+
+void rv2azel(const double ro[3], const double vo[3], const ObserverFrame& frame, double jdut1, double razel[3], double razelrates[3])
+{
+    double gmst = gstime(jdut1);
+    sezlook(ro, vo, frame, cos(gmst), sin(gmst), razel, razelrates);
+}
+
+void rv2azel(const double ro[3], const ObserverFrame& frame, const GmstSweep& sweep, double razel[3])
+{
+    sezlook(ro, NULL, frame, sweep.ct, sweep.st, razel, NULL);
+}
+
+void rv2azel(const double ro[3], const double vo[3], const ObserverFrame& frame, const GmstSweep& sweep, double razel[3], double razelrates[3])
+{
+    sezlook(ro, vo, frame, sweep.ct, sweep.st, razel, razelrates);
+}
+
+/*
+rangerate
+
+Range rate from the ECEF vectors, the projection of the relative velocity on the
+line of sight. Positive when the satellite moves away from the site.
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+recef           Sat. position vector (ECEF)     km
+vecef           Sat. velocity vector (ECEF)     km/s
+rs              Site position vector (ECEF)     km
+
+OUTPUTS         DESCRIPTION
+rangerate       Range rate                      km/s
+*/
+
+double rangerate(const double recef[3], const double vecef[3], const double rs[3])
+{
+    double rho[3];
+    double magrho;
+
+    rho[0] = recef[0] - rs[0];
+    rho[1] = recef[1] - rs[1];
+    rho[2] = recef[2] - rs[2];
+    magrho = sqrt(rho[0]*rho[0] + rho[1]*rho[1] + rho[2]*rho[2]);
+    if (magrho <= 0.0)
+    {
+        return 0.0;
+    }
+    return (rho[0]*vecef[0] + rho[1]*vecef[1] + rho[2]*vecef[2]) / magrho;
+}
+
 void rot3(double invec[3], double xval, double outvec[3])
 {
     double temp = invec[1];
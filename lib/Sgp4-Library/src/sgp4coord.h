@@ -14,7 +14,7 @@ Ported to C++ by Grady Hillhouse with some modifications, July 2015.
 #include <math.h>
 #include <string.h>
 
-//void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3]);
+void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3]);
 void teme2ecef(double rteme[3], double jdut1, double recef[3]);
 
 void polarm(double jdut1, double pm[3][3]);
@@ -24,9 +24,49 @@ void ijk2ll(double r[3], double latlongh[3]);
 //void site(double latgd, double lon, double alt, double rs[3], double vs[3]);
 void site(double latgd, double lon, double alt, double rs[3]);
 
-//void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3]);
+void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3]);
 void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, double razel[3]);
 
+//range rate [km/s] from the ECEF position and velocity of the satellite and the ECEF site position
+double rangerate(const double recef[3], const double vecef[3], const double rs[3]);
+
+//site data for repeated az/el conversions, built once by observerframe() when the site changes
+struct ObserverFrame
+{
+    double latgd, lon, alt;     //geodetic latitude, longitude [radians], altitude [km]
+    double rs[3];               //site position vector (ECEF) [km]
+    double sez[3][3];           //rotation ECEF => topocentric horizon (south, east, zenith)
+    double rssez[3];            //site position in the sez axes [km]
+    double pmjd;                //julian date used for the polar motion
+    double pez[3][3];           //rotation PEF => SEZ (polar motion followed by sez)
+};
+
+void observerframe(double latgd, double lon, double alt, double jdut1, ObserverFrame& frame);
+
+void observerpolar(ObserverFrame& frame, double jdut1);
+
+void rv2azel(const double ro[3], const ObserverFrame& frame, double jdut1, double razel[3]);
+
+void rv2azel(const double ro[3], const double vo[3], const ObserverFrame& frame, double jdut1, double razel[3], double razelrates[3]);
+
+//sidereal time of samples at a fixed step, advanced with a rotation recurrence instead of gstime() per sample
+struct GmstSweep
+{
+    double jdstart, jdstep;     //first sample and step [days]
+    double jd;                  //julian date of the current sample
+    double ct, st;              //cos and sin of gmst at jd
+    double cstep, sstep;        //rotation of one step
+    int steps;                  //samples since jdstart
+};
+
+void gmstsweep(double jdstart, double jdstep, GmstSweep& sweep);
+
+void gmstnext(GmstSweep& sweep);
+
+void rv2azel(const double ro[3], const ObserverFrame& frame, const GmstSweep& sweep, double razel[3]);
+
+void rv2azel(const double ro[3], const double vo[3], const ObserverFrame& frame, const GmstSweep& sweep, double razel[3], double razelrates[3]);
+
 void rot3(double invec[3], double xval, double outvec[3]);
 
 void rot2(double invec[3], double xval, double outvec[3]);
@@ -0,0 +1,327 @@
+/*
+This file contains a single precision version of the near earth sgp4 propagation and of the
+coordinate transformations used for overpass prediction.
+
+Based on the sgp4 procedure by David Vallado (sgp4unit.cpp) and the coordinate
+transformations ported by Grady Hillhouse (sgp4coord.cpp).
+*/
+
+#include "sgp4float.h"
+#include "sgp4ext.h"
+#include <math.h>
+
+/*
+sgp4f
+
+Near earth part of sgp4() in single precision, see sgp4unit.cpp for the description of the
+variables. The element set is not modified, the error code is returned instead.
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+whichconst      Gravity constants               wgs72old, wgs72, wgs84
+satrec          Initialised element set         method 'n'
+tsince          Time since epoch                minutes
+
+OUTPUTS         DESCRIPTION                     RANGE/UNITS
+r               Position vector (TEME)          km
+v               Velocity vector (TEME)          km/s
+*/
+
+int sgp4f(gravconsttype whichconst, const elsetrec& satrec, double tsince, float r[3], float v[3])
+{
+  const double twopi = 2.0 * pi;
+  double tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2;
+
+  //angles with a secular drift, kept in double precision
+  double xmdf, argpdf, nodedf, argpm, mm, nodem, xlm, t2d;
+
+  float am, axnl, aynl, betal, cos2u, coseo1, cossu, cosu, cnod, cosi,
+        delm, delomg, em, ecose, el2, eo1, esine, pl, mrt,
+        mvt, rdotl, rl, rvdot, rvdotl, sin2u, sineo1, sinsu, sinu, snod, sini, su,
+        t, t2, t3, t4, tem5, temp, temp1, temp2, tempa, tempe, templ,
+        u, ux, uy, uz, vx, vy, vz, nm, xinc, xl, xnode, xmx, xmy, delmtemp,
+        argpmf, nodemf, mmf, xkef, j2f, cosio, sinio;
+  int ktr;
+
+  getgravconst( whichconst, tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2 );
+  xkef = (float)xke;
+  j2f  = (float)j2;
+
+  if (satrec.no <= 0.0)
+    {
+      return 2;
+    }
+
+  /* ------- update for secular gravity and atmospheric drag ----- */
+  t2d     = tsince * tsince;
+  xmdf    = satrec.mo + satrec.mdot * tsince;
+  argpdf  = satrec.argpo + satrec.argpdot * tsince;
+  nodedf  = satrec.nodeo + satrec.nodedot * tsince;
+  argpm   = argpdf;
+  mm      = xmdf;
+  nodem   = nodedf + satrec.nodecf * t2d;
+
+  t       = (float)tsince;
+  t2      = (float)t2d;
+  tempa   = 1.0f - (float)satrec.cc1 * t;
+  tempe   = (float)(satrec.bstar * satrec.cc4) * t;
+  templ   = (float)satrec.t2cof * t2;
+
+  if (satrec.isimp != 1)
+    {
+      delomg   = (float)satrec.omgcof * t;
+      delmtemp = 1.0f + (float)satrec.eta * cosf((float)floatmod(xmdf, twopi));
+      delm     = (float)satrec.xmcof * (delmtemp * delmtemp * delmtemp - (float)satrec.delmo);
+      temp     = delomg + delm;
+      mm       = xmdf + temp;
+      argpm    = argpdf - temp;
+      t3       = t2 * t;
+      t4       = t3 * t;
+      tempa    = tempa - (float)satrec.d2 * t2 - (float)satrec.d3 * t3 - (float)satrec.d4 * t4;
+      tempe    = tempe + (float)(satrec.bstar * satrec.cc5) *
+                 (sinf((float)floatmod(mm, twopi)) - (float)satrec.sinmao);
+      templ    = templ + (float)satrec.t3cof * t3 + t4 * ((float)satrec.t4cof + t * (float)satrec.t5cof);
+    }
+
+  //mean motion is constant for near earth orbits, am = (xke/no)^(2/3) * tempa^2
+  temp = xkef / (float)satrec.no;
+  am   = cbrtf(temp * temp) * tempa * tempa;
+  nm   = xkef / (am * sqrtf(am));
+  em   = (float)satrec.ecco - tempe;
+
+  if ((em >= 1.0f) || (em < -0.001f))
+    {
+      return 1;
+    }
+  if (em < 1.0e-6f)
+      em  = 1.0e-6f;
+  mm     = mm + satrec.no * templ;
+  xlm    = mm + argpm + nodem;
+
+  nodem  = floatmod(nodem, twopi);
+  argpm  = floatmod(argpm, twopi);
+  xlm    = floatmod(xlm, twopi);
+  mm     = floatmod(xlm - argpm - nodem, twopi);
+
+  //from here on all angles are in [0, 2pi[
+  nodemf = (float)nodem;
+  argpmf = (float)argpm;
+  mmf    = (float)mm;
+  cosio  = cosf((float)satrec.inclo);
+  sinio  = sinf((float)satrec.inclo);
+
+  /* -------------------- long period periodics ------------------ */
+  axnl = em * cosf(argpmf);
+  temp = 1.0f / (am * (1.0f - em * em));
+  aynl = em * sinf(argpmf) + temp * (float)satrec.aycof;
+  xl   = mmf + argpmf + nodemf + temp * (float)satrec.xlcof * axnl;
+
+  /* --------------------- solve kepler's equation --------------- */
+  u    = (float)floatmod(xl - nodemf, (float)twopi);
+  eo1  = u;
+  tem5 = 9999.9f;
+  ktr = 1;
+  sineo1 = 0.0f;
+  coseo1 = 1.0f;
+  //   tolerance is limited by the resolution of a float around 2pi
+  while (( fabsf(tem5) >= 1.0e-6f) && (ktr <= 10) )
+    {
+      sineo1 = sinf(eo1);
+      coseo1 = cosf(eo1);
+      tem5   = 1.0f - coseo1 * axnl - sineo1 * aynl;
+      tem5   = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+      if(fabsf(tem5) >= 0.95f)
+          tem5 = tem5 > 0.0f ? 0.95f : -0.95f;
+      eo1    = eo1 + tem5;
+      ktr = ktr + 1;
+    }
+
+  /* ------------- short period preliminary quantities ----------- */
+  ecose = axnl*coseo1 + aynl*sineo1;
+  esine = axnl*sineo1 - aynl*coseo1;
+  el2   = axnl*axnl + aynl*aynl;
+  pl    = am*(1.0f-el2);
+  if (pl < 0.0f)
+    {
+      return 4;
+    }
+
+  rl     = am * (1.0f - ecose);
+  rdotl  = sqrtf(am) * esine/rl;
+  rvdotl = sqrtf(pl) / rl;
+  betal  = sqrtf(1.0f - el2);
+  temp   = esine / (1.0f + betal);
+  sinu   = am / rl * (sineo1 - aynl - axnl * temp);
+  cosu   = am / rl * (coseo1 - axnl + aynl * temp);
+  su     = atan2f(sinu, cosu);
+  sin2u  = (cosu + cosu) * sinu;
+  cos2u  = 1.0f - 2.0f * sinu * sinu;
+  temp   = 1.0f / pl;
+  temp1  = 0.5f * j2f * temp;
+  temp2  = temp1 * temp;
+
+  /* -------------- update for short period periodics ------------ */
+  mrt   = rl * (1.0f - 1.5f * temp2 * betal * (float)satrec.con41) +
+          0.5f * temp1 * (float)satrec.x1mth2 * cos2u;
+  su    = su - 0.25f * temp2 * (float)satrec.x7thm1 * sin2u;
+  xnode = nodemf + 1.5f * temp2 * cosio * sin2u;
+  xinc  = (float)satrec.inclo + 1.5f * temp2 * cosio * sinio * cos2u;
+  mvt   = rdotl - nm * temp1 * (float)satrec.x1mth2 * sin2u / xkef;
+  rvdot = rvdotl + nm * temp1 * ((float)satrec.x1mth2 * cos2u + 1.5f * (float)satrec.con41) / xkef;
+
+  /* --------------------- orientation vectors ------------------- */
+  sinsu =  sinf(su);
+  cossu =  cosf(su);
+  snod  =  sinf(xnode);
+  cnod  =  cosf(xnode);
+  sini  =  sinf(xinc);
+  cosi  =  cosf(xinc);
+  xmx   = -snod * cosi;
+  xmy   =  cnod * cosi;
+  ux    =  xmx * sinsu + cnod * cossu;
+  uy    =  xmy * sinsu + snod * cossu;
+  uz    =  sini * sinsu;
+  vx    =  xmx * cossu - cnod * sinsu;
+  vy    =  xmy * cossu - snod * sinsu;
+  vz    =  sini * cossu;
+
+  /* --------- position and velocity (in km and km/sec) ---------- */
+  temp  = (float)radiusearthkm;
+  temp1 = (float)(radiusearthkm * xke / 60.0);
+  r[0] = (mrt * ux)* temp;
+  r[1] = (mrt * uy)* temp;
+  r[2] = (mrt * uz)* temp;
+  v[0] = (mvt * ux + rvdot * vx) * temp1;
+  v[1] = (mvt * uy + rvdot * vy) * temp1;
+  v[2] = (mvt * uz + rvdot * vz) * temp1;
+
+  // decaying satellite
+  if (mrt < 1.0f)
+    {
+      return 6;
+    }
+  return 0;
+}
+
+/*
+teme2ecef (single precision)
+
+Rotation from TEME to ECEF. The sidereal time is computed in double precision and reduced
+before the rotation. Polar motion (below 0.5 arcsec, ~15 m at LEO distance) is neglected.
+*/
+
+void teme2ecef(const float rteme[3], double jdut1, float recef[3])
+{
+    float gmst = (float)gstime(jdut1);
+    float c = cosf(gmst);
+    float s = sinf(gmst);
+
+    recef[0] =  c * rteme[0] + s * rteme[1];
+    recef[1] = -s * rteme[0] + c * rteme[1];
+    recef[2] =  rteme[2];
+}
+
+/*
+rv2azel (single precision)
+
+Range, azimuth and elevation from a TEME position, see rv2azel in sgp4coord.cpp.
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+ro              Sat. position vector (TEME)     km
+latgd           Site geodetic latitude          -pi/2 to pi/2 in radians
+lon             Site longitude                  -2pi to 2pi in radians
+alt             Site altitude                   km
+jdut1           Julian date                     days
+
+OUTPUTS         DESCRIPTION
+razel           Range [km], azimuth and elevation [radians]
+*/
+
+void rv2azel(const float ro[3], float latgd, float lon, float alt, double jdut1, float razel[3])
+{
+    const float re     = 6378.137f;        //radius of earth in km
+    const float eesqrd = 0.006694385000f;  //eccentricity of earth sqrd
+    float recef[3], rho[3];
+    float sinlat, coslat, sinlon, coslon, cearth, rdel;
+    float south, east, zenith, temp, az, el, range;
+
+    sinlat = sinf(latgd);
+    coslat = cosf(latgd);
+    sinlon = sinf(lon);
+    coslon = cosf(lon);
+
+    //site position vector (ECEF)
+    cearth = re / sqrtf(1.0f - eesqrd * sinlat * sinlat);
+    rdel   = (cearth + alt) * coslat;
+
+    teme2ecef(ro, jdut1, recef);
+
+    rho[0] = recef[0] - rdel * coslon;
+    rho[1] = recef[1] - rdel * sinlon;
+    rho[2] = recef[2] - ((1.0f - eesqrd) * cearth + alt) * sinlat;
+    range  = sqrtf(rho[0]*rho[0] + rho[1]*rho[1] + rho[2]*rho[2]);
+
+    //rot3(lon) followed by rot2(pi/2 - lat) => topocentric horizon (SEZ)
+    temp   =  coslon * rho[0] + sinlon * rho[1];
+    east   = -sinlon * rho[0] + coslon * rho[1];
+    south  =  sinlat * temp - coslat * rho[2];
+    zenith =  coslat * temp + sinlat * rho[2];
+
+    temp = sqrtf(south*south + east*east);
+    if (temp < 0.00000001f)
+    {
+        el = zenith < 0.0f ? -(float)pi * 0.5f : (float)pi * 0.5f;
+        az = NAN;
+    }
+    else
+    {
+        el = asinf(zenith / range);
+        az = atan2f(east, -south);
+    }
+
+    razel[0] = range;
+    razel[1] = az;
+    razel[2] = el;
+}
+
+/*
+rv2azel (single precision, ObserverFrame)
+
+Range, azimuth and elevation with the site vector and rotation of an ObserverFrame,
+see rv2azel in sgp4coord.cpp. Unlike the version above the polar motion is included,
+it is part of the cached rotation.
+*/
+
+void rv2azel(const float ro[3], const ObserverFrame& frame, double jdut1, float razel[3])
+{
+    float rpef[3], rho[3];
+    float horiz, range;
+
+    float gmst = (float)gstime(jdut1);
+    float c = cosf(gmst);
+    float s = sinf(gmst);
+
+    rpef[0] =  c * ro[0] + s * ro[1];
+    rpef[1] = -s * ro[0] + c * ro[1];
+    rpef[2] =  ro[2];
+
+    for (int i = 0; i < 3; i++)
+    {
+        rho[i] = (float)frame.pez[i][0] * rpef[0] + (float)frame.pez[i][1] * rpef[1] +
+                 (float)frame.pez[i][2] * rpef[2] - (float)frame.rssez[i];
+    }
+
+    range = sqrtf(rho[0]*rho[0] + rho[1]*rho[1] + rho[2]*rho[2]);
+    horiz = sqrtf(rho[0]*rho[0] + rho[1]*rho[1]);
+
+    razel[0] = range;
+    if (horiz < 0.00000001f)
+    {
+        razel[1] = NAN;
+        razel[2] = rho[2] < 0.0f ? -(float)pi * 0.5f : (float)pi * 0.5f;
+    }
+    else
+    {
+        razel[1] = atan2f(rho[1], -rho[0]);
+        razel[2] = asinf(rho[2] / range);
+    }
+}
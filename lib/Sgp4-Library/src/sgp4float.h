@@ -0,0 +1,33 @@
+/*
+This file contains a single precision version of the near earth sgp4 propagation and of the
+coordinate transformations used for overpass prediction.
+Processors like the ESP32 only have a single precision fpu, every double operation is emulated
+in software. These functions trade some accuracy (tens of meters in position for a LEO
+satellite, see examples/Sgp4FloatBench) for a faster evaluation.
+
+The secular update of the angles and the sidereal time stay in double precision: they grow
+with time and are reduced modulo 2pi before they are converted to float.
+Deep space objects (method 'd') are not supported, use the standard sgp4() for them.
+
+Based on the sgp4 procedure by David Vallado (sgp4unit.cpp) and the coordinate
+transformations ported by Grady Hillhouse (sgp4coord.cpp).
+*/
+
+#ifndef _sgp4float_
+#define _sgp4float_
+
+#include "sgp4unit.h"
+#include "sgp4coord.h"
+
+// near earth propagation in single precision, returns the sgp4 error code (0 = no error)
+// r [km], v [km/s] in the TEME frame
+int  sgp4f(gravconsttype whichconst, const elsetrec& satrec, double tsince, float r[3], float v[3]);
+
+void teme2ecef(const float rteme[3], double jdut1, float recef[3]);
+
+void rv2azel(const float ro[3], float latgd, float lon, float alt, double jdut1, float razel[3]);
+
+// same with the site data of an ObserverFrame (sgp4coord.h)
+void rv2azel(const float ro[3], const ObserverFrame& frame, double jdut1, float razel[3]);
+
+#endif
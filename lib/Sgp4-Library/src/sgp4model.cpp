@@ -0,0 +1,213 @@
+/*
+This file contains a reentrant alternative to the Sgp4 class, see sgp4model.h.
+
+Written for the ORBITSCOUT tracker.
+*/
+
+#include "sgp4model.h"
+#include "sgp4ext.h"
+#include "sgp4io.h"
+#include "sgp4coord.h"
+#include "sgp4float.h"
+#include <string.h>
+#include <math.h>
+
+Sgp4Model::Sgp4Model(){
+  opsmode = 'i';  //improved mode
+  whichconst = wgs84;   //newest constants
+  singleprec = false;
+  satName[0] = '\0';
+  revpday = 0.0;
+  memset(&satrec, 0, sizeof(satrec));
+  kernel = sgp4select(whichconst, satrec);
+  siteLatRad = siteLonRad = siteAlt = 0.0;
+  ::observerframe(0.0, 0.0, 0.0, 0.0, frame);
+}
+
+bool Sgp4Model::init(const char naam[], const char longstr1[130], const char longstr2[130]){
+
+  char tle1[130];
+  char tle2[130];
+  elsetrec rec;
+
+  //twoline2rv rewrites the strings, parse a copy
+  strncpy(tle1, longstr1, sizeof(tle1) - 1);
+  tle1[sizeof(tle1) - 1] = '\0';
+  strncpy(tle2, longstr2, sizeof(tle2) - 1);
+  tle2[sizeof(tle2) - 1] = '\0';
+  twoline2rv(tle1, tle2, opsmode, whichconst, rec);
+
+  return init(naam, rec);
+}
+
+bool Sgp4Model::init(const char naam[], const elsetrec& rec){
+
+  strncpy(satName, naam, sizeof(satName) - 1);
+  satName[sizeof(satName) - 1] = '\0';
+  satrec = rec;
+  kernel = sgp4select(whichconst, satrec);
+  revpday = 1440.0 / (2.0 * pi) * satrec.no;
+  polar(satrec.jdsatepoch);
+  return satrec.error == 0;
+}
+
+void Sgp4Model::site(double lat, double lon, double alt){
+  double latRad = lat * pi / 180.0;
+  double lonRad = lon * pi / 180.0;
+
+  //called with every gps fix, only rebuild the frame when the site moved
+  if (latRad == siteLatRad && lonRad == siteLonRad && alt / 1000 == siteAlt){
+    return;
+  }
+  siteLatRad = latRad;
+  siteLonRad = lonRad;
+  siteAlt = alt / 1000; //meters to kilometers
+
+  ::observerframe(siteLatRad, siteLonRad, siteAlt, satrec.jdsatepoch, frame);
+}
+
+//changes less than a milliarcsecond per day, a refresh every few days is enough
+void Sgp4Model::polar(double jd){
+  observerpolar(frame, jd);
+}
+
+void Sgp4Model::setfloat(bool enable){
+  singleprec = enable;
+}
+
+bool Sgp4Model::usesfloat() const {
+  return singleprec && satrec.method == 'n';
+}
+
+void Sgp4Model::initcontext(Sgp4Context& ctx) const {
+  memset(&ctx, 0, sizeof(ctx));
+  sgp4initstate(satrec, ctx.state);
+}
+
+bool Sgp4Model::state(Sgp4Context& ctx, double jd) const {
+
+  double tsince = (jd - satrec.jdsatepoch) * 24.0 * 60.0;
+
+  if (usesfloat()){
+    float rf[3], vf[3];
+    ctx.state.t = tsince;
+    ctx.state.error = sgp4f(whichconst, satrec, tsince, rf, vf);
+    for (int i = 0; i < 3; i++){
+      ctx.ro[i] = rf[i];
+      ctx.vo[i] = vf[i];
+    }
+  }else{
+    kernel(satrec, ctx.state, tsince, ctx.ro, ctx.vo);
+  }
+  return ctx.state.error == 0;
+}
+
+bool Sgp4Model::propagate(Sgp4Context& ctx, double jd) const {
+
+  bool ok = state(ctx, jd);
+  rv2azel(ctx.ro, ctx.vo, frame, jd, ctx.razel, ctx.razelrates);
+  return ok;
+}
+
+bool Sgp4Model::findsat(Sgp4Context& ctx, double jd) const {
+  return findsat(ctx, jd, findall);
+}
+
+bool Sgp4Model::findsat(Sgp4Context& ctx, unsigned long unixtime) const {
+  return findsat(ctx, getJulianFromUnix(unixtime), findall);
+}
+
+bool Sgp4Model::findsat(Sgp4Context& ctx, double jd, int outputs) const {
+
+  bool ok = propagate(ctx, jd);
+
+  ctx.satAz = floatmod( ctx.razel[1]*180/pi+360.0, 360.0);  //Azemith sattelite (degrees)
+  ctx.satEl = ctx.razel[2]*180/pi; //elevation sattelite (degrees)
+  ctx.satDist = ctx.razel[0];  //Distance to sattelite (km)
+  ctx.satJd = jd;  //time (julian day)
+
+  if (outputs & findgeodetic){
+    subpoint(ctx);
+  }
+  return ok;
+}
+
+bool Sgp4Model::findsat(Sgp4Context& ctx, unsigned long unixtime, int outputs) const {
+  return findsat(ctx, getJulianFromUnix(unixtime), outputs);
+}
+
+void Sgp4Model::subpoint(Sgp4Context& ctx) const {
+
+  double recef[3];
+  double latlongh[3];
+
+  teme2ecef(ctx.ro, ctx.satJd, recef);
+  ijk2ll(recef, latlongh);
+
+  ctx.satLat = latlongh[0]*180/pi;  //Latidude sattelite (degrees)
+  ctx.satLon = latlongh[1]*180/pi;  //longitude sattelite (degrees)
+  ctx.satAlt = latlongh[2];   //Altitude sattelite (degrees)
+}
+
+passclass Sgp4Model::passfilter(double jdstart, double jdstop, double minelevation) const {
+  return ::passfilter(whichconst, satrec, frame, minelevation, jdstart, jdstop);
+}
+
+passclass Sgp4Model::passfilter(const ObserverFrame& site, double jdstart, double jdstop, double minelevation) const {
+  return ::passfilter(whichconst, satrec, site, minelevation, jdstart, jdstop);
+}
+
+//the site and polar motion come from the frame (see polar()), the earth rotation from a gmstsweep
+int Sgp4Model::timeline(Sgp4Context& ctx, double jdstart, double jdstep, int count, double az[], double el[], double range[]) const {
+  return timeline(ctx, jdstart, jdstep, count, az, el, range, NULL);
+}
+
+int Sgp4Model::timeline(Sgp4Context& ctx, double jdstart, double jdstep, int count, double az[], double el[], double range[], double rangerate[]) const {
+
+  float rf[3], vf[3];
+  double razel[3], razelrates[3];
+  bool single = usesfloat();
+  int ok = 0;
+  GmstSweep sweep;
+
+  gmstsweep(jdstart, jdstep, sweep);
+  for (int i = 0; i < count; i++, gmstnext(sweep)){
+    double tsince = (sweep.jd - satrec.jdsatepoch) * 24.0 * 60.0;
+
+    if (single){
+      ctx.state.t = tsince;
+      ctx.state.error = sgp4f(whichconst, satrec, tsince, rf, vf);
+      ctx.ro[0] = rf[0]; ctx.ro[1] = rf[1]; ctx.ro[2] = rf[2];
+      ctx.vo[0] = vf[0]; ctx.vo[1] = vf[1]; ctx.vo[2] = vf[2];
+    }else{
+      kernel(satrec, ctx.state, tsince, ctx.ro, ctx.vo);
+    }
+    if (ctx.state.error != 0){
+      if (az) az[i] = 0.0;
+      if (el) el[i] = -90.0;
+      if (range) range[i] = 0.0;
+      if (rangerate) rangerate[i] = 0.0;
+      continue;
+    }
+    ok++;
+
+    if (rangerate){
+      rv2azel(ctx.ro, ctx.vo, frame, sweep, razel, razelrates);
+    }else{
+      rv2azel(ctx.ro, frame, sweep, razel);
+    }
+    if (az) az[i] = floatmod(razel[1] * 180 / pi + 360.0, 360.0);
+    if (el) el[i] = razel[2] * 180 / pi;
+    if (range) range[i] = razel[0];
+    if (rangerate) rangerate[i] = razelrates[0];
+  }
+  return ok;
+}
+
+int Sgp4Model::timeline(Sgp4Context& ctx, unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[]) const {
+  return timeline(ctx, getJulianFromUnix(unixstart), step / 86400.0, count, az, el, range);
+}
+
+int Sgp4Model::timeline(Sgp4Context& ctx, unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[], double rangerate[]) const {
+  return timeline(ctx, getJulianFromUnix(unixstart), step / 86400.0, count, az, el, range, rangerate);
+}
@@ -0,0 +1,78 @@
+/*
+This file contains a reentrant alternative to the Sgp4 class.
+Sgp4Model holds everything that does not change while propagating (element set, site, constants)
+and only has const functions. The results and the mutable propagation state are kept in a small
+Sgp4Context owned by the caller, so one model can be shared by several tasks that propagate
+the same satellite at different times, without locks and without copying the element set.
+
+Overpass prediction (nextpass) and visibility stay in the Sgp4 class.
+
+Written for the ORBITSCOUT tracker.
+*/
+
+#ifndef _sgp4model_
+#define _sgp4model_
+
+#include "sgp4unit.h"
+#include "sgp4coord.h"
+#include "sgp4pred.h"   //findsatoutput, passfilter()
+#include <stddef.h>
+
+struct Sgp4Context
+{
+  sgp4state state;   //deep space integrator state, error code
+  double ro[3];      //position TEME [km]
+  double vo[3];      //velocity TEME [km/s]
+  double razel[3];   //range [km], azimuth, elevation [radians]
+  double razelrates[3];  //range rate [km/s], azimuth rate, elevation rate [radians/s]
+
+  double satLat, satLon, satAlt, satAz, satEl, satDist, satJd;  //same units as the Sgp4 class
+};
+
+class Sgp4Model {
+    gravconsttype whichconst;
+    char opsmode;
+    bool singleprec;
+    elsetrec satrec;
+    sgp4kernel kernel;    //propagation kernel for satrec, chosen by init()
+
+    double siteLatRad, siteLonRad, siteAlt;    //site [radians, radians, km]
+    ObserverFrame frame;                        //site vector and rotation to the horizon system
+
+  public:
+    char satName[25];
+    double revpday;   //revolutions per day
+
+    Sgp4Model();
+    bool init(const char naam[], const char longstr1[130], const char longstr2[130]);  //initialize from 2 line elements
+    bool init(const char naam[], const elsetrec& rec);  //initialize from an element set already initialized by twoline2rv
+    void site(double lat, double lon, double alt);  //site latitude[degrees], longitude[degrees] and altitude[meters]
+    void polar(double jd);   //polar motion used by the az/el conversion, init() and site() use the epoch of the elements
+    void setfloat(bool enable);   //use single precision for near earth satellites
+    bool usesfloat() const;
+
+    const elsetrec& elements() const { return satrec; }
+    const ObserverFrame& observerframe() const { return frame; }
+
+    void initcontext(Sgp4Context& ctx) const;   //reset a context to the epoch of the element set
+
+    bool state(Sgp4Context& ctx, double jd) const;       //only ro and vo (TEME), returns false on a propagation error
+    bool propagate(Sgp4Context& ctx, double jd) const;   //ro, vo, razel and razelrates, returns false on a propagation error
+    bool findsat(Sgp4Context& ctx, double jd) const;     //also fills satLat ... satJd
+    bool findsat(Sgp4Context& ctx, unsigned long unixtime) const;
+    bool findsat(Sgp4Context& ctx, double jd, int outputs) const;   //findazel and findgeodetic of the findsatoutput mask
+    bool findsat(Sgp4Context& ctx, unsigned long unixtime, int outputs) const;
+    void subpoint(Sgp4Context& ctx) const;   //satLat, satLon and satAlt from ro at satJd, before propagating the context again
+
+    // passfilter() for the site of the model or another site (e.g. of Sgp4Sites), minelevation in degrees
+    passclass passfilter(double jdstart, double jdstop, double minelevation) const;
+    passclass passfilter(const ObserverFrame& site, double jdstart, double jdstop, double minelevation) const;
+
+    // same as Sgp4::timeline, az [degrees], el [degrees] and range [km] can be NULL
+    int timeline(Sgp4Context& ctx, double jdstart, double jdstep, int count, double az[], double el[], double range[]) const;
+    int timeline(Sgp4Context& ctx, unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[]) const;
+    int timeline(Sgp4Context& ctx, double jdstart, double jdstep, int count, double az[], double el[], double range[], double rangerate[]) const;
+    int timeline(Sgp4Context& ctx, unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[], double rangerate[]) const;
+};
+
+#endif
@@ -5,11 +5,15 @@ Most functions are based on the columns written by Dr. T.S. Kelso on the celestr
 Written by Hopperpop
 */
 
-#include <Arduino.h>
+#ifdef ESP8266
+#include <Arduino.h>  //yield()
+#endif
+#include <string.h>
 #include "sgp4ext.h"
 #include "sgp4unit.h"
 #include "sgp4io.h"
 #include "sgp4coord.h"
+#include "sgp4float.h"
 #include "brent.h"
 #include "sgp4pred.h"
 #include "visible.h"
@@ -17,6 +21,156 @@ Written by Hopperpop
 
 #define MAX_itter 30
 #define tol 0.000005  //tol = +-0,432 sec
+#define earthradius 6378.137   //km, for the pass width estimate
+
+//passfilter() margins
+#define pfangle   0.0174532925199433  //1 degree: geodetic/geocentric latitude, short periodic inclination
+#define pfradius  50.0                //km: short periodic radius variation
+#define pfdrift   0.0174532925199433  //1 degree per year after the epoch: lunisolar inclination drift (deep space)
+#define pfsync    0.5                 //max longitude drift [rad] over the window to use the longitude test
+#define earthrot  0.00437526908801129966  //earth rotation [rad/min]
+
+
+///////////Pass filter///////////
+
+//radius of the visibility cone [rad], earth central angle between the site and the sub-satellite
+//point where the satellite is at elevation el, for a satellite at radius r [km]
+static double conehalfangle(double r, double re, double el){
+  double c = re * cos(el) / r;
+  if (c >= 1.0) return 0.0;
+  return acos(c) - el;
+}
+
+//earth central angle between the site and the equator point at longitude difference dlon
+static double equatorangle(double latsite, double dlon){
+  return acos(cos(latsite) * cos(dlon));
+}
+
+//sub-satellite longitude [rad] from the position at jd (mean equator, polar motion ignored)
+static bool meanlongitude(gravconsttype whichconst, const elsetrec& satrec, double jd, double& lon){
+  sgp4state state;
+  double r[3], v[3];
+  sgp4initstate(satrec, state);
+  if (!sgp4(whichconst, satrec, state, (jd - satrec.jdsatepoch) * 1440.0, r, v)) return false;
+  lon = atan2(r[1], r[0]) - gstime(jd);
+  return true;
+}
+
+//wrap an angle to [-pi, pi]
+static double wrappi(double a){
+  a = fmod(a, 2.0 * pi);
+  if (a > pi) a -= 2.0 * pi;
+  if (a < -pi) a += 2.0 * pi;
+  return a;
+}
+
+passclass passfilter(gravconsttype whichconst, const elsetrec& satrec, const ObserverFrame& frame,
+                     double minelevation, double jdstart, double jdstop){
+  double tumin, mu, re, xke, j2, j3, j4, j3oj2;
+  double el, imax, rmin, rmax, conemax, conemin, margin, years, latsite;
+  double lon1, lon2, span, dlon1, dlon2, near, far, libration;
+
+  if (satrec.error != 0 || satrec.no <= 0.0) return passcandidate;
+  if (jdstop < jdstart) { double t = jdstart; jdstart = jdstop; jdstop = t; }
+
+  getgravconst(whichconst, tumin, mu, re, xke, j2, j3, j4, j3oj2);
+  el = minelevation * pi / 180.0;
+  latsite = fabs(frame.latgd);
+
+  //highest latitude of the sub-satellite point
+  imax = satrec.inclo <= pi / 2.0 ? satrec.inclo : pi - satrec.inclo;
+  margin = pfangle;
+  if (satrec.method == 'd'){
+    years = fmax(fabs(jdstart - satrec.jdsatepoch), fabs(jdstop - satrec.jdsatepoch)) / 365.25;
+    margin += pfdrift * years;
+  }
+
+  //visibility cone at apogee (largest) and perigee (smallest), satrec.alta/altp in earth radii
+  rmax = (1.0 + satrec.alta) * re + pfradius;
+  rmin = (1.0 + satrec.altp) * re - pfradius;
+  conemax = conehalfangle(rmax, re, el);
+  conemin = conehalfangle(rmin, re, el);
+
+  //latitude test: the sub-satellite point never comes close enough to the site latitude
+  if (latsite > imax + conemax + margin) return passnever;
+
+  //longitude test only for near synchronous orbits (the sub-satellite longitude drifts slowly)
+  if (satrec.ecco > 0.25 || satrec.inclo > pi / 2.0) return passcandidate;
+  if (fabs(satrec.no - earthrot) * (jdstop - jdstart) * 1440.0 > pfsync) return passcandidate;
+  if (!meanlongitude(whichconst, satrec, jdstart, lon1) || !meanlongitude(whichconst, satrec, jdstop, lon2)) return passcandidate;
+
+  //longitudes [lon1, lon1 + span] relative to the site, widened by the eccentricity (2e) and inclination (i^2/4) libration
+  span = wrappi(lon2 - lon1);
+  if (span < 0.0) { lon1 += span; span = -span; }
+  libration = 2.0 * satrec.ecco + satrec.inclo * satrec.inclo / 4.0 + margin;
+  dlon1 = wrappi(lon1 - libration - frame.lon);
+  span += 2.0 * libration;
+  if (span >= pi) return passcandidate;
+  dlon2 = dlon1 + span;
+
+  //closest and farthest equator point of the longitude interval
+  if (dlon1 <= 0.0 && dlon2 >= 0.0) near = 0.0;
+  else near = fmin(fabs(wrappi(dlon1)), fabs(wrappi(dlon2)));
+  if (dlon1 <= pi && dlon2 >= pi) far = pi;
+  else far = fmax(fabs(wrappi(dlon1)), fabs(wrappi(dlon2)));
+
+  //the sub-satellite point is within imax of the equator point
+  if (equatorangle(latsite, near) - imax > conemax + margin) return passnever;
+  if (equatorangle(latsite, far) + imax < conemin - margin) return passalways;
+  return passcandidate;
+}
+
+
+
+
+void horizoninit(horizonmask& mask, const double az[], const double el[], int count){
+  int i, k, prev, next;
+  double a, da, f;
+
+  mask.minel = mask.maxel = 0.0f;
+  for (k = 0; k < HORIZON_BINS; k++) mask.el[k] = 0.0f;
+  if (count <= 0) return;
+
+  for (k = 0; k < HORIZON_BINS; k++){
+    //closest point at or before the bin and closest point after it, around the circle
+    prev = next = 0;
+    double dprev = 1e9, dnext = 1e9;
+    for (i = 0; i < count; i++){
+      a = floatmod(az[i] + 360.0, 360.0);
+      da = floatmod(k - a + 360.0, 360.0);
+      if (da < dprev) { dprev = da; prev = i; }
+      da = floatmod(a - k + 360.0, 360.0);
+      if (da > 0.0 && da < dnext) { dnext = da; next = i; }
+    }
+    if (dprev == 0.0 || count == 1) f = 0.0;
+    else f = dprev / (dprev + dnext);
+    mask.el[k] = (float)((el[prev] + f * (el[next] - el[prev])) * pi / 180.0);
+  }
+
+  mask.minel = mask.maxel = mask.el[0];
+  for (k = 1; k < HORIZON_BINS; k++){
+    if (mask.el[k] < mask.minel) mask.minel = mask.el[k];
+    if (mask.el[k] > mask.maxel) mask.maxel = mask.el[k];
+  }
+}
+
+double horizonelevation(const horizonmask& mask, double az){
+  if (!isfinite(az)) return mask.maxel;  //zenith: sezlook gives no azimuth, the satellite is above any bin
+  double x = floatmod(az * 180.0 / pi + 360.0, 360.0);
+  int k = (int)x;
+  if (k >= HORIZON_BINS) k = 0;  //rounding of floatmod just below 360
+  double f = x - k;
+  return mask.el[k] + f * (mask.el[k + 1 < HORIZON_BINS ? k + 1 : 0] - mask.el[k]);
+}
+
+//slope of the mask at an azimuth [rad], d(elevation)/d(azimuth)
+static double horizonslope(const horizonmask& mask, double az){
+  if (!isfinite(az)) return 0.0;
+  double x = floatmod(az * 180.0 / pi + 360.0, 360.0);
+  int k = (int)x;
+  if (k >= HORIZON_BINS) k = 0;
+  return (mask.el[k + 1 < HORIZON_BINS ? k + 1 : 0] - mask.el[k]) * 180.0 / pi;
+}
 
 
 ///////////Classs///////////
@@ -24,22 +178,58 @@ Written by Hopperpop
 Sgp4::Sgp4(){
    opsmode = 'i';  //improved mode
    whichconst = wgs84;   //newest constants
-   sunoffset = -0.10471975511966; //sun aboven -6°  => not dark enough
+   sunoffset = SUN_DARK_ELEVATION * pi / 180.0; //sun aboven -6°  => not dark enough
+   suncacheclear(suncached);
    offset = 0.0;
+   horizon = NULL;
+   singleprec = false;
+   line1[0] = '\0';
+   line2[0] = '\0';
+   evaluations = 0;
+   jdP = jdGeo = satJd = 0.0;
+   memset(&satrec, 0, sizeof(satrec));
+   kernel = sgp4select(whichconst, satrec);
+   site(0.0, 0.0, 0.0);
+}
+
+//strlcpy is not available on every host libc
+static void copystr(char* dest, const char* src, size_t size){
+  strncpy(dest, src, size - 1);
+  dest[size - 1] = '\0';
 }
 
 ///Init functions/////
-bool Sgp4::init(const char naam[24], char longstr1[130], char longstr2[130]){
+bool Sgp4::init(const char naam[24], const char longstr1[130], const char longstr2[130]){
+
+  char tle1[130];
+  char tle2[130];
 
   if (strcmp(longstr1, line1) == 0) {
 	  return false;
   }
 
-  strlcpy(satName, naam, sizeof(satName));
-  strlcpy(line1, longstr1, sizeof(line1));
-  strlcpy(line2, longstr2, sizeof(line2));
+  copystr(satName, naam, sizeof(satName));
+  copystr(line1, longstr1, sizeof(line1));
+  copystr(line2, longstr2, sizeof(line2));
 
-  twoline2rv(longstr1, longstr2, opsmode, whichconst, satrec );
+  //twoline2rv rewrites the strings, parse a copy
+  copystr(tle1, longstr1, sizeof(tle1));
+  copystr(tle2, longstr2, sizeof(tle2));
+  twoline2rv(tle1, tle2, opsmode, whichconst, satrec );
+  kernel = sgp4select(whichconst, satrec);
+
+  revpday   =  1440.0 / (2.0 * pi) * satrec.no;
+  return true;
+}
+
+bool Sgp4::init(const char naam[24], const elsetrec& rec){
+
+  copystr(satName, naam, sizeof(satName));
+  line1[0] = '\0';
+  line2[0] = '\0';
+
+  satrec = rec;
+  kernel = sgp4select(whichconst, satrec);
 
   revpday   =  1440.0 / (2.0 * pi) * satrec.no;
   return true;
@@ -53,6 +243,18 @@ void Sgp4::site(double lat, double lon, double alt){
   siteAlt = alt / 1000; //meters to kilometers
   siteLatRad = siteLat * pi / 180.0;
   siteLonRad = siteLon * pi / 180.0;
+
+  //polar motion of jd 0 is replaced at the first propagation, see observer()
+  ::observerframe(siteLatRad, siteLonRad, siteAlt, 0.0, frame);
+  suncacheclear(suncached);
+}
+
+//the polar motion changes less than a milliarcsecond per day
+const ObserverFrame& Sgp4::observer(double jdCe){
+  if (fabs(jdCe - frame.pmjd) > 1.0){
+    observerpolar(frame, jdCe);
+  }
+  return frame;
 }
 
 ///set sunoffset
@@ -60,56 +262,233 @@ void Sgp4::setsunrise(double degrees){
   sunoffset = degrees * pi / 180.0;
 }
 
+///set the local horizon
+void Sgp4::sethorizon(const horizonmask* mask){
+  horizon = mask;
+}
+
+///select single or double precision
+void Sgp4::setfloat(bool enable){
+  singleprec = enable;
+}
+
+bool Sgp4::usesfloat(){
+  return singleprec && satrec.method == 'n';
+}
+
 ////Location functions/////
+
+//propagate to jdCe and calculate range, azimuth and elevation from the site
+void Sgp4::propagate(double jdCe, bool rates){
+
+  double tsince = (jdCe - satrec.jdsatepoch) * 24.0 * 60.0;
+
+  if (usesfloat()){
+    float rf[3], vf[3], razelf[3];
+    satrec.error = sgp4f(whichconst, satrec, tsince, rf, vf);
+    if (!rates) rv2azel(rf, observer(jdCe), jdCe, razelf);
+    for (int i = 0; i < 3; i++){
+      ro[i] = rf[i];
+      vo[i] = vf[i];
+      if (!rates) razel[i] = razelf[i];
+    }
+    if (rates) rv2azel(ro, vo, observer(jdCe), jdCe, razel, razelrates);
+  }else{
+    sgp4(kernel, satrec, tsince, ro, vo);
+    if (rates) rv2azel(ro, vo, observer(jdCe), jdCe, razel, razelrates);
+    else rv2azel(ro, observer(jdCe), jdCe, razel);
+  }
+  jdP = jdCe;
+}
+
 void Sgp4::findsat(double jdI){
+  findsat(jdI, findall);
+}
 
-  double latlongh[3];
-  double recef[3];
-  double vecef[3];
-  double razelrates[3];
+void Sgp4::findsat(unsigned long unixtime){
+  findsat(getJulianFromUnix(unixtime), findall);
+}
+
+void Sgp4::findsat(double jdI, int outputs){
 
   jdC = jdI;
 
-  double tsince = (jdC - satrec.jdsatepoch) * 24.0 * 60.0;
-  sgp4(whichconst, satrec, tsince, ro, vo);
-  rv2azel(ro, siteLatRad, siteLonRad, siteAlt, jdC, razel);
-  teme2ecef(ro, jdC, recef);
-  ijk2ll(recef, latlongh);
+  propagate(jdC);
 
-  satLat = latlongh[0]*180/pi;  //Latidude sattelite (degrees)
-  satLon = latlongh[1]*180/pi;  //longitude sattelite (degrees)
-  satAlt = latlongh[2];   //Altitude sattelite (degrees)
   satAz = floatmod( razel[1]*180/pi+360.0, 360.0);  //Azemith sattelite (degrees)
   satEl = razel[2]*180/pi; //elevation sattelite (degrees)
   satDist = razel[0];  //Distance to sattelite (km)
   satJd = jdI;  //time (julian day)
+  jdGeo = 0.0;  //satLat, satLon and satAlt are outdated
+
+  if (outputs & findgeodetic){
+    subpoint();
+  }
+
+  if (outputs & findvisible){
+    satVis = visible();
+    if (satEl < 0.0) {
+        satVis = -2; //under horizon
+    }
+  }
+}
+
+void Sgp4::findsat(unsigned long unixtime, int outputs){
+  findsat(getJulianFromUnix(unixtime), outputs);
+}
+
+//sub-satellite point, only calculated once per findsat()
+void Sgp4::subpoint(){
+
+  double latlongh[3];
+  double recef[3];
+
+  if (jdGeo == satJd){
+    return;
+  }
+  if (jdP != satJd){
+    propagate(satJd);   //ro was changed by the overpass prediction
+  }
+  teme2ecef(ro, satJd, recef);
+  ijk2ll(recef, latlongh);
+
+  satLat = latlongh[0]*180/pi;  //Latidude sattelite (degrees)
+  satLon = latlongh[1]*180/pi;  //longitude sattelite (degrees)
+  satAlt = latlongh[2];   //Altitude sattelite (degrees)
+  jdGeo = satJd;
+}
+
+//propagate a series of points, the site and polar motion are only calculated once
+//and the earth rotation advances by a fixed angle per step (gmstsweep)
+int Sgp4::timeline(double jdstart, double jdstep, int count, double az[], double el[], double range[]){
+  return timeline(jdstart, jdstep, count, az, el, range, NULL);
+}
+
+int Sgp4::timeline(double jdstart, double jdstep, int count, double az[], double el[], double range[], double rangerate[]){
+  return timeline(jdstart, jdstep, count, az, el, range, rangerate, NULL);
+}
+
+int Sgp4::timeline(double jdstart, double jdstep, int count, double az[], double el[], double range[], double rangerate[], visibletype vis[]){
+
+  double r[3], v[3], rz[3], rzrates[3], rsun[3], sunel;
+  float rf[3], vf[3];
+  bool single = usesfloat();
+  int err, ok = 0;
+  const ObserverFrame& obs = observer(jdstart);
+  GmstSweep sweep;
+
+  gmstsweep(jdstart, jdstep, sweep);
+  for (int i = 0; i < count; i++, gmstnext(sweep)){
+    double jd = sweep.jd;
+    double tsince = (jd - satrec.jdsatepoch) * 24.0 * 60.0;
+
+    if (single){
+      err = sgp4f(whichconst, satrec, tsince, rf, vf);
+      satrec.error = err;
+      r[0] = rf[0]; r[1] = rf[1]; r[2] = rf[2];
+      v[0] = vf[0]; v[1] = vf[1]; v[2] = vf[2];
+    }else{
+      sgp4(kernel, satrec, tsince, r, v);
+      err = satrec.error;
+    }
+    if (err != 0){
+      if (az) az[i] = 0.0;
+      if (el) el[i] = -90.0;
+      if (range) range[i] = 0.0;
+      if (rangerate) rangerate[i] = 0.0;
+      if (vis) vis[i] = sgp4daylight;
+      continue;
+    }
+    ok++;
 
-  satVis = visible();
-  if (satEl < 0.0) {
-      satVis = -2; //under horizon
+    if (vis){
+      sunlook(suncached, obs, jd, rsun, NULL, &sunel);
+      vis[i] = illumination(r, rsun, sunel, sunoffset);
+    }
+
+    if (rangerate){
+      rv2azel(r, v, obs, sweep, rz, rzrates);
+      rangerate[i] = rzrates[0];
+    }else{
+      rv2azel(r, obs, sweep, rz);
+    }
+    if (az) az[i] = floatmod(rz[1] * 180 / pi + 360.0, 360.0);
+    if (el) el[i] = rz[2] * 180 / pi;
+    if (range) range[i] = rz[0];
   }
+  return ok;
+}
 
+int Sgp4::timeline(unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[]){
+  return timeline(getJulianFromUnix(unixstart), step / 86400.0, count, az, el, range);
 }
 
-void Sgp4::findsat(unsigned long unix){
-  findsat(getJulianFromUnix(unix));
+int Sgp4::timeline(unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[], double rangerate[]){
+  return timeline(getJulianFromUnix(unixstart), step / 86400.0, count, az, el, range, rangerate);
+}
+
+int Sgp4::timeline(unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[], double rangerate[], visibletype vis[]){
+  return timeline(getJulianFromUnix(unixstart), step / 86400.0, count, az, el, range, rangerate, vis);
 }
 
 
 //////Predict functions/////////
 
-//returns the elevation for a given julian date
+//returns the elevation for a given julian date (above the local horizon when a mask is set)
 double Sgp4::sgp4wrap( double jdCe){
 
-    double tsince = (jdCe - satrec.jdsatepoch) * 24.0 * 60.0;
-
-    sgp4(whichconst, satrec, tsince, ro, vo);
-    rv2azel(ro, siteLatRad, siteLonRad, siteAlt, jdCe, razel);
+    evaluations++;
+    propagate(jdCe);
+    if (horizon) return -razel[2]+offset+horizonelevation(*horizon, razel[1]);
     return -razel[2]+offset;
 
 }
 
 
+//sgp4wrap() and its time derivative [rad/day] from the elevation and azimuth rates of the same propagation
+void Sgp4::sgp4wrapd(double jdCe, double* f, double* df){
+
+    evaluations++;
+    propagate(jdCe, true);
+    *f = -razel[2]+offset;
+    *df = -razelrates[2];
+    if (horizon) {
+      *f += horizonelevation(*horizon, razel[1]);
+      *df += horizonslope(*horizon, razel[1]) * razelrates[1];
+    }
+    *df *= 86400.0;  //rad/s => rad/day
+
+}
+
+//time from the maximum elevation to the horizon (offset) along a circular orbit of the current radius,
+//the central angle between the site and the satellite is acos(re/r*cos(el)) - el
+double Sgp4::halfpass(double maxelevation){
+
+    double r = mag(ro);
+    if (r <= earthradius) return 0.0;
+    double l0 = acos(earthradius / r * cos(offset)) - offset;
+    double lmax = acos(earthradius / r * cos(maxelevation)) - maxelevation;
+    double c = cos(l0) / cos(lmax);
+    if (c > 1.0) c = 1.0;
+    return acos(c) / (satrec.no * 1440.0);
+
+}
+
+//horizon crossing between the maximum (elevation function fmax < 0) and jdmax + range,
+//seeded at jdmax + half and bracketed within 1.5 half when possible
+double Sgp4::passedge(double jdmax, double fmax, double half, double range){
+
+    double jd;
+    if (half != 0.0 && fabs(1.5 * half) < fabs(range)){
+      jd = rtsafe(&Sgp4::sgp4wrapd, jdmax, jdmax + 1.5 * half, jdmax + half, &fmax, tol, this);
+      if (jd >= 0.0) return jd;
+    }
+    //pass longer than estimated (eccentric orbit, horizon mask): full half revolution
+    return rtsafe(&Sgp4::sgp4wrapd, jdmax, jdmax + range, jdmax + 0.5 * range, &fmax, tol, this);
+
+}
+
+
 // returns next overpass maximum, starting from a maximum called startpoint
 bool Sgp4::nextpass(passinfo* passdata, int itterations) {
 	return (Sgp4::nextpass( passdata, itterations, false, 0.0));
@@ -132,6 +511,8 @@ bool Sgp4::nextpass( passinfo* passdata, int itterations, bool direc, double min
 	int16_t vissum,vis;
 	bool isdaylight;
 	double startphi, stopphi,phi;
+	long int steps = satrec.dssteps;
+	long int evals = evaluations;
 
     range = 0.25/revpday;
 
@@ -142,6 +523,13 @@ bool Sgp4::nextpass( passinfo* passdata, int itterations, bool direc, double min
 		jump = 1.0 / revpday;
 	}
 
+	//no brent search when the satellite cannot rise in the searched interval
+	if (passfilter(jdCp, jdCp + jump * itterations, minimumElevation + offset * 180 / pi) == passnever) {
+		jdCp += jump * itterations;
+		jdC = jdCp;
+		return 0;
+	}
+
     for (i = 0; i < itterations && max_elevation <= (minimumElevation * pi / 180); i++){ //search for elevation above minimumElevation
        jdCp+= jump;
        max_elevation = - brentmin(jdCp - range , jdCp, jdCp + range, &Sgp4::sgp4wrap , tol, &jdCp, this);
@@ -150,49 +538,54 @@ bool Sgp4::nextpass( passinfo* passdata, int itterations, bool direc, double min
 		#endif
     }
     jdC = jdCp;
-    if (i>=itterations) return 0;
+    if (max_elevation <= (minimumElevation * pi / 180)) return 0;  //a pass found in the last itteration is kept
 
 	///max elevation
 
     (*passdata).maxelevation = (max_elevation+offset)*180/pi;
+    if (horizon) (*passdata).maxelevation += horizonelevation(*horizon, razel[1])*180/pi;  //max_elevation is above the mask
     (*passdata).jdmax = jdC;
 	  (*passdata).azmax = floatmod(razel[1] * 180 / pi + 360.0, 360.0);
     vis = visible(isdaylight,phi);
 
-    if (isdaylight)	{(*passdata).vismax = daylight;}
+    if (isdaylight)	{(*passdata).vismax = sgp4daylight;}
     else if (vis < 1000){(*passdata).vismax = eclipsed;}
     else {(*passdata).vismax = lighted;}
 
 	//start point
 
+    long int edgeevals = evaluations;
+    //Newton on the elevation rate, seeded with the pass width; the elevation at the maximum is known
+    double half = halfpass((*passdata).maxelevation * pi / 180);
     range = 0.5/revpday;
-    jdC = zbrent(&Sgp4::sgp4wrap, jdCp, jdCp - range, tol, this);
+    jdC = passedge(jdCp, -max_elevation, -half, -range);
     if (jdC < 0.0) return 0;
     (*passdata).jdstart = jdC;
     (*passdata).azstart = floatmod(razel[1] * 180 / pi + 360.0, 360.0);
     vis = visible(isdaylight,startphi);
 
-    if (isdaylight)	{(*passdata).visstart = daylight;}
+    if (isdaylight)	{(*passdata).visstart = sgp4daylight;}
     else if (vis < 1000){(*passdata).visstart = eclipsed;}
     else {(*passdata).visstart = lighted;}
     vissum = vis;
 
 	//stop point
 
-    jdC = zbrent(&Sgp4::sgp4wrap, jdCp, jdCp + range, tol, this);
+    jdC = passedge(jdCp, -max_elevation, half, range);
     if (jdC < 0.0) return 0;
     (*passdata).jdstop = jdC;
     (*passdata).azstop = floatmod(razel[1] * 180 / pi + 360.0, 360.0);
+    (*passdata).edgeevaluations = evaluations - edgeevals;
     vis = visible(isdaylight,stopphi);
 
-    if (isdaylight)	{(*passdata).visstop = daylight;}
+    if (isdaylight)	{(*passdata).visstop = sgp4daylight;}
     else if (vis < 1000){(*passdata).visstop = eclipsed;}
     else {(*passdata).visstop = lighted;}
     vissum += vis;
 
 	//global visibility
 
-    if ((*passdata).visstop == daylight && (*passdata).visstart == daylight)	{(*passdata).sight = daylight;}
+    if ((*passdata).visstop == sgp4daylight && (*passdata).visstart == sgp4daylight)	{(*passdata).sight = sgp4daylight;}
     else if (vissum < 1000){(*passdata).sight = eclipsed;}
 	  else {(*passdata).sight = lighted;}
 
@@ -203,7 +596,7 @@ bool Sgp4::nextpass( passinfo* passdata, int itterations, bool direc, double min
 		(*passdata).jdtransit = NAN;
 		(*passdata).aztransit = NAN;
 		(*passdata).transitelevation = NAN;
-    (*passdata).vistransit = daylight;
+    (*passdata).vistransit = sgp4daylight;
 	}
 	else {
 		if (sgn(startphi)>sgn(stopphi)) {
@@ -220,13 +613,15 @@ bool Sgp4::nextpass( passinfo* passdata, int itterations, bool direc, double min
 		(*passdata).transitelevation = razel[2] * 180 / pi;
     vis = visible(isdaylight,phi);
 
-    if (isdaylight)	{(*passdata).vistransit = daylight;}
+    if (isdaylight)	{(*passdata).vistransit = sgp4daylight;}
     else {(*passdata).vistransit = eclipsed;}
     //else {(*passdata).visstop = lighted;}
 	}
 
 
     (*passdata).minelevation = offset*180/pi;
+    (*passdata).dssteps = satrec.dssteps - steps;
+    (*passdata).evaluations = evaluations - evals;
 
     return 1;
 }
@@ -267,8 +662,13 @@ bool Sgp4::initpredpoint( double startpoint, double startelevation){
     return 1;
 }
 
-bool Sgp4::initpredpoint( unsigned long unix, double startelevation){
-  return initpredpoint( getJulianFromUnix(unix), startelevation);
+bool Sgp4::initpredpoint( unsigned long unixtime, double startelevation){
+  return initpredpoint( getJulianFromUnix(unixtime), startelevation);
+}
+
+passclass Sgp4::passfilter(double jdstart, double jdstop, double minimumElevation){
+  if (horizon) minimumElevation += horizon->minel * 180 / pi;
+  return ::passfilter(whichconst, satrec, frame, minimumElevation, jdstart, jdstop);
 }
 
 double Sgp4::getpredpoint() {
@@ -14,12 +14,41 @@ Written by Hopperpop
 #include "sgp4coord.h"
 #include <stdint.h>
 
+//time.h on posix systems declares 'int daylight', which clashes with an enumerator of that name.
+//Arduino sketches keep writing daylight; host builds only have sgp4daylight, which works on both.
+#if defined(ARDUINO)
 enum visibletype
 {
   daylight,
   eclipsed,
   lighted
 };
+static const visibletype sgp4daylight = daylight;
+#else
+enum visibletype
+{
+  sgp4daylight,
+  eclipsed,
+  lighted
+};
+#endif
+
+//outputs of findsat(), combine with |
+enum findsatoutput
+{
+  findazel = 1,       //satAz, satEl, satDist (always calculated)
+  findgeodetic = 2,   //satLat, satLon, satAlt
+  findvisible = 4,    //satVis, sunAz, sunEl
+  findall = 7
+};
+
+//result of passfilter()
+enum passclass
+{
+  passnever,       //the satellite cannot rise above the minimum elevation in the window
+  passcandidate,   //the overpass search is needed
+  passalways       //the satellite stays above the minimum elevation during the whole window
+};
 
 enum shadowtransit
 {
@@ -52,9 +81,65 @@ struct passinfo
   visibletype sight;
   shadowtransit transit;
 
+  long int dssteps;  //deep space resonance integration steps used to predict this pass (0 for near earth)
+  long int evaluations;  //propagations used to predict this pass
+  long int edgeevaluations;  //part of evaluations used to find jdstart and jdstop
+
+};
+
+
+
+// geometric classification of a satellite for a site before searching overpasses, no brent search
+// uses the inclination, perigee and apogee of satrec and the visibility cone radius versus the site latitude,
+// near synchronous orbits are also checked on longitude (two propagations, at jdstart and jdstop)
+// minelevation in degrees, passcandidate when unsure
+passclass passfilter(gravconsttype whichconst, const elsetrec& satrec, const ObserverFrame& frame,
+                     double minelevation, double jdstart, double jdstop);
+
+// local horizon (terrain, buildings): elevation of the horizon per degree of azimuth,
+// linear between the bins so the root finding sees a continuous function
+#define HORIZON_BINS 360
+struct horizonmask
+{
+  float el[HORIZON_BINS];  //horizon elevation [rad] at azimuth k degrees
+  float minel;             //lowest and highest bin [rad]
+  float maxel;
+};
+
+// fill a mask from count points (azimuth [degrees], elevation [degrees]), in any order,
+// linear between neighbouring points around the circle, count = 0 gives a flat horizon
+void horizoninit(horizonmask& mask, const double az[], const double el[], int count);
+
+// horizon elevation [rad] at an azimuth [rad], O(1); the highest bin when az is NaN (zenith)
+double horizonelevation(const horizonmask& mask, double az);
+
+// sun position cache: sun() and the sun azimuth/elevation from one site at the edges of a bucket of
+// SUN_BUCKET minutes, linear in between. The sun moves about 1 degree per day in the inertial frame and
+// 0.25 degree per minute on the sky, the interpolated azimuth/elevation stays within 0.005 degree, below
+// the 0.01 degree accuracy of sun()
+#define SUN_BUCKET 10.0
+#define SUN_DARK_ELEVATION -6.0   //degrees, default of setsunrise(): below it a sunlit satellite can be seen
+struct suncache
+{
+  double jd0;               //start of the cached bucket, 0 when empty
+  double rsun0[3], rsun1[3];  //sun vector [km] at jd0 and jd0 + SUN_BUCKET
+  double sez0[3], sez1[3];    //sun direction in the horizon system of the site (south, east, zenith) at the edges
 };
 
+// empty the cache, needed when the site changes
+void suncacheclear(suncache& cache);
+
+// sun vector [km] at jd and its azimuth, elevation [radians] from the site of frame, az and el can be NULL
+// two sun() and rv2azel() calls per bucket instead of one per call
+void sunlook(suncache& cache, const ObserverFrame& frame, double jd, double rsun[3], double* az, double* el);
 
+// fraction of the sun disk seen from a satellite at rsat [km]: 1000 = sunlit, 0 = umbra, partial in between
+// deltaphi (can be NULL) = angle between the sun and earth edges [radians], negative in the shadow
+int16_t sunlit(const double rsat[3], const double rsun[3], double* deltaphi);
+
+// daylight when the sun elevation at the site is above sunoffset [radians], else eclipsed when the satellite
+// is (partly) in the earth shadow, else lighted (visible with the naked eye when high enough)
+visibletype illumination(const double rsat[3], const double rsun[3], double sunel, double sunoffset);
 
 class Sgp4 {
     char opsmode;
@@ -62,12 +147,27 @@ class Sgp4 {
     double ro[3];
     double vo[3];
     double razel[3];
+    double razelrates[3];  //range, azimuth and elevation rates of jdP, only after propagate(jdCe, true)
     double offset; //Min elevation for overpass prediction in radials
     double sunoffset;  //Min elevation sun for daylight in radials
     double jdC;    //Current used julian date
     double jdCp;    //Current used julian date for prediction
+    double jdP;     //julian date of ro, vo and razel
+    double jdGeo;   //julian date of satLat, satLon and satAlt
+    bool singleprec;  //use the single precision near earth model (sgp4float.h)
+    sgp4kernel kernel;  //propagation kernel for satrec, chosen by init()
+    ObserverFrame frame;  //site vector and rotation to the horizon system, rebuilt by site()
+    const horizonmask* horizon;  //local horizon of the site, NULL for a flat horizon
+    suncache suncached;  //sun position for visible() and the illumination timeline, cleared by site()
+
+    const ObserverFrame& observer(double jdCe);  //frame with the polar motion of jdCe (refreshed once per day)
+
+    void propagate(double jdCe, bool rates = false);  //calculates ro, vo and razel (and razelrates) for a given julian date
 
     double sgp4wrap( double jdCe);  //returns the elevation for a given julian date
+    void sgp4wrapd(double jdCe, double* f, double* df);  //sgp4wrap() and its derivative [per day] from the elevation rate, for rtsafe()
+    double halfpass(double maxelevation);  //estimated time [days] from the maximum to the horizon, from the geometry of a circular orbit
+    double passedge(double jdmax, double fmax, double half, double range);  //jdstart (half, range < 0) or jdstop with rtsafe()
 	double visiblewrap(double jdCe);  //returns angle between sun surface and earth surface
 
   public:
@@ -76,25 +176,48 @@ class Sgp4 {
 	char line2[80];     //tle line 2
 
     double revpday;  ///revolutions per day
-    elsetrec satrec;
+    elsetrec satrec;    //call init() again after changing it
     double siteLat, siteLon, siteAlt, siteLatRad, siteLonRad;
     double satLat, satLon, satAlt, satAz, satEl, satDist,satJd;
     double sunAz, sunEl;
+    long int evaluations;  //total number of propagations done by the overpass prediction
 	int16_t satVis;
 
     Sgp4();
-    bool init(const char naam[], char longstr1[130], char longstr2[130]);  //initialize parameters from 2 line elements
+    bool init(const char naam[], const char longstr1[130], const char longstr2[130]);  //initialize parameters from 2 line elements, the strings are not modified
+    bool init(const char naam[], const elsetrec& rec);  //initialize from an element set already initialized by twoline2rv
     void site(double lat, double lon, double alt);  //initialize site latitude[degrees],longitude[degrees],altitude[meters]
+    const ObserverFrame& observerframe() const { return frame; }
     void setsunrise(double degrees);   //change the elevation that the sun needs to make it daylight
+    void sethorizon(const horizonmask* mask);  //passes start and end at the mask (not copied, keep it valid), NULL = flat
+    void setfloat(bool enable);   //use single precision for near earth satellites, deep space always uses double
+    bool usesfloat();  //true if the single precision model is used for this satellite
 
     void findsat(double jdI);     //find satellite position from julian date
     void findsat(unsigned long);  //find satellite position from unix time
+    void findsat(double jdI, int outputs);   //only the outputs in the findsatoutput mask
+    void findsat(unsigned long unixtime, int outputs);
+    void subpoint();   //calculate satLat, satLon and satAlt for satJd if findsat() skipped them
+
+    // azimuth [degrees], elevation [degrees] and range [km] for count points starting at jdstart with a step of jdstep days
+    // az, el and range can be NULL if not needed, points with a propagation error get elevation -90
+    // returns the number of points without error, satellite variables (satAz, satEl,...) are not updated
+    int timeline(double jdstart, double jdstep, int count, double az[], double el[], double range[]);
+    int timeline(unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[]);  //step in seconds
+    // same with the range rate [km/s] from the velocity of the same propagation (positive when receding), can be NULL
+    int timeline(double jdstart, double jdstep, int count, double az[], double el[], double range[], double rangerate[]);
+    int timeline(unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[], double rangerate[]);
+    // same with the illumination of every point (daylight, eclipsed or lighted, see illumination()), can be NULL
+    // the sun comes from the cache, so the sweep does no extra sun() or rv2azel() per point
+    int timeline(double jdstart, double jdstep, int count, double az[], double el[], double range[], double rangerate[], visibletype vis[]);
+    int timeline(unsigned long unixstart, unsigned long step, int count, double az[], double el[], double range[], double rangerate[], visibletype vis[]);
 
     bool nextpass( passinfo* passdata, int itterations); // calculate next overpass data, returns true if succesfull
 	bool nextpass(passinfo* passdata, int itterations, bool direc); //direc = false for forward search, true for backwards search
     bool nextpass(passinfo* passdata, int itterations, bool direc, double minimumElevation); //minimumElevation = minimum elevation above the horizon (in degrees)
     bool initpredpoint( double juliandate , double startelevation); //initialize prediction algorithm, starting from a juliandate and predict passes aboven startelevation
-    bool initpredpoint( unsigned long unix, double startelevation); // from unix time
+    bool initpredpoint( unsigned long unixtime, double startelevation); // from unix time
+    passclass passfilter(double jdstart, double jdstop, double minimumElevation);  //see passfilter() above, for the current site and the lowest point of its horizon
 
     int16_t visible();  //check if satellite is visible
 	int16_t visible(bool& notdark, double& deltaphi);
@@ -0,0 +1,91 @@
+/*
+This file contains a network of ground sites that share one propagation, see sgp4sites.h.
+
+Written for the ORBITSCOUT tracker.
+*/
+
+#include "sgp4sites.h"
+#include "sgp4ext.h"
+
+Sgp4Sites::Sgp4Sites(){
+}
+
+void Sgp4Sites::reserve(int count){
+  frames.reserve(count);
+}
+
+void Sgp4Sites::clear(){
+  frames.clear();
+}
+
+int Sgp4Sites::add(double lat, double lon, double alt){
+
+  ObserverFrame frame;
+  double jd = frames.empty() ? 0.0 : frames[0].pmjd;   //same polar motion as the other sites
+
+  observerframe(lat * pi / 180.0, lon * pi / 180.0, alt / 1000.0, jd, frame);
+  frames.push_back(frame);
+  return (int)frames.size() - 1;
+}
+
+//changes less than a milliarcsecond per day
+void Sgp4Sites::polar(double jd){
+  for (size_t i = 0; i < frames.size(); i++){
+    observerpolar(frames[i], jd);
+  }
+}
+
+void Sgp4Sites::look(const double ro[3], const double vo[3], const GmstSweep& sweep, double razel[][3], double razelrates[][3]) const {
+  for (size_t i = 0; i < frames.size(); i++){
+    if (vo != NULL && razelrates != NULL){
+      rv2azel(ro, vo, frames[i], sweep, razel[i], razelrates[i]);
+    }else{
+      rv2azel(ro, frames[i], sweep, razel[i]);
+    }
+  }
+}
+
+//gstime and its sine and cosine once for all sites
+void Sgp4Sites::look(const double ro[3], const double vo[3], double jd, double razel[][3], double razelrates[][3]) const {
+  GmstSweep sweep;
+  gmstsweep(jd, 0.0, sweep);
+  look(ro, vo, sweep, razel, razelrates);
+}
+
+bool Sgp4Sites::look(const Sgp4Model& model, Sgp4Context& ctx, double jd, double razel[][3], double razelrates[][3]) const {
+  bool ok = model.state(ctx, jd);
+  look(ctx.ro, ctx.vo, jd, razel, razelrates);
+  return ok;
+}
+
+int Sgp4Sites::timeline(const Sgp4Model& model, Sgp4Context& ctx, double jdstart, double jdstep, int count, double az[], double el[]) const {
+
+  std::vector<double> razel(frames.size() * 3);
+  double (*rz)[3] = (double (*)[3])&razel[0];
+  int n = (int)frames.size();
+  int ok = 0;
+  GmstSweep sweep;
+
+  if (n == 0){
+    return 0;
+  }
+
+  gmstsweep(jdstart, jdstep, sweep);
+  for (int i = 0; i < count; i++, gmstnext(sweep)){
+    if (!model.state(ctx, sweep.jd)){
+      for (int k = 0; k < n; k++){
+        if (az) az[k * count + i] = 0.0;
+        el[k * count + i] = -90.0;
+      }
+      continue;
+    }
+    ok++;
+
+    look(ctx.ro, NULL, sweep, rz, NULL);
+    for (int k = 0; k < n; k++){
+      if (az) az[k * count + i] = floatmod(rz[k][1] * 180 / pi + 360.0, 360.0);
+      el[k * count + i] = rz[k][2] * 180 / pi;
+    }
+  }
+  return ok;
+}
@@ -0,0 +1,45 @@
+/*
+This file contains a network of ground sites (observers) that share one propagation.
+The satellite is propagated once per epoch and the TEME state is projected into the
+topocentric horizon system of every site with its ObserverFrame, so N sites cost one
+sgp4() call and one sidereal time plus N small matrix products, instead of N propagations.
+
+Written for the ORBITSCOUT tracker.
+*/
+
+#ifndef _sgp4sites_
+#define _sgp4sites_
+
+#include "sgp4coord.h"
+#include "sgp4model.h"
+#include <stddef.h>
+#include <vector>
+
+class Sgp4Sites {
+    std::vector<ObserverFrame> frames;   //one per site, in the order they were added
+
+  public:
+    Sgp4Sites();
+
+    void reserve(int count);
+    void clear();
+    int size() const { return (int)frames.size(); }
+
+    int add(double lat, double lon, double alt);  //site latitude[degrees], longitude[degrees] and altitude[meters], returns its index
+    void polar(double jd);   //polar motion of every site, add() uses jd 0 until this is called
+    const ObserverFrame& frame(int i) const { return frames[i]; }
+
+    // range [km], azimuth, elevation [radians] of a TEME state for every site, razel must hold size() entries
+    // vo and razelrates can be NULL, otherwise the rates [km/s, radians/s] are calculated too
+    void look(const double ro[3], const double vo[3], const GmstSweep& sweep, double razel[][3], double razelrates[][3]) const;
+    void look(const double ro[3], const double vo[3], double jd, double razel[][3], double razelrates[][3]) const;
+
+    // propagate the model once to jd and look from every site, returns false on a propagation error
+    bool look(const Sgp4Model& model, Sgp4Context& ctx, double jd, double razel[][3], double razelrates[][3]) const;
+
+    // azimuth and elevation [degrees] for count points from every site, one propagation per point
+    // az[site * count + i] and el[site * count + i], az can be NULL, returns the number of points without error
+    int timeline(const Sgp4Model& model, Sgp4Context& ctx, double jdstart, double jdstep, int count, double az[], double el[]) const;
+};
+
+#endif
@@ -51,6 +51,7 @@
 
 #include "sgp4unit.h"
 #include "sgp4ext.h"
+#include <string.h>
 
 const char help = 'n';
 FILE *dbgfile;
@@ -125,7 +126,8 @@ static void dspace
        double t,      double tc,     double gsto,    double xfact,  double xlamo,
        double no,
        double& atime, double& em,    double& argpm,  double& inclm, double& xli,
-       double& mm,    double& xni,   double& nodem,  double& dndt,  double& nm
+       double& mm,    double& xni,   double& nodem,  double& dndt,  double& nm,
+       double ckatime[], double ckxli[], double ckxni[], int& cknext, long int& dssteps
      );
 
 static void initl
@@ -956,6 +958,11 @@ static void dsinit
 *    nodem       - right ascension of ascending node
 *    dndt        -
 *    nm          - mean motion
+*    ckatime     - resonance integrator checkpoints (atime, xli, xni)
+*    ckxli       -
+*    ckxni       -
+*    cknext      - next checkpoint to be replaced
+*    dssteps     - integration step counter
 *
 *  locals        :
 *    delt        -
@@ -989,7 +996,8 @@ static void dspace
        double t,      double tc,     double gsto,    double xfact,  double xlamo,
        double no,
        double& atime, double& em,    double& argpm,  double& inclm, double& xli,
-       double& mm,    double& xni,   double& nodem,  double& dndt,  double& nm
+       double& mm,    double& xni,   double& nodem,  double& dndt,  double& nm,
+       double ckatime[], double ckxli[], double ckxni[], int& cknext, long int& dssteps
      )
 {
      const double twopi = 2.0 * pi;
@@ -1045,6 +1053,19 @@ static void dspace
              atime  = 0.0;
              xni    = no;
              xli    = xlamo;
+
+             // restart from the closest checkpoint between epoch and t instead of epoch.
+             // checkpoints are states on the same 720 min grid, the result is identical
+             for (int k = 0; k < DSCHECKPOINTS; k++)
+               {
+                 if ((ckatime[k] * t > 0.0) && (fabs(ckatime[k]) <= fabs(t)) &&
+                     (fabs(ckatime[k]) > fabs(atime)))
+                   {
+                     atime = ckatime[k];
+                     xli   = ckxli[k];
+                     xni   = ckxni[k];
+                   }
+               }
            }
            // sgp4fix move check outside loop
            if (t > 0.0)
@@ -1107,9 +1128,24 @@ static void dspace
                  xli   = xli + xldot * delt + xndt * step2;
                  xni   = xni + xndt * delt + xnddt * step2;
                  atime = atime + delt;
+                 dssteps++;
                }
            }  // while iretn = 381
 
+         // keep the final state as a checkpoint, oldest one is replaced
+         if (atime != 0.0)
+           {
+             int k;
+             for (k = 0; k < DSCHECKPOINTS && ckatime[k] != atime; k++);
+             if (k == DSCHECKPOINTS)
+               {
+                 ckatime[cknext] = atime;
+                 ckxli[cknext]   = xli;
+                 ckxni[cknext]   = xni;
+                 cknext = (cknext + 1) % DSCHECKPOINTS;
+               }
+           }
+
          nm = xni + xndt * ft + xnddt * ft * ft * 0.5;
          xl = xli + xldot * ft + xndt * ft * ft * 0.5;
          if (irez != 1)
@@ -1398,6 +1434,11 @@ bool sgp4init
      satrec.xl3   = 0.0; satrec.xl4   = 0.0; satrec.xlamo = 0.0;
      satrec.zmol  = 0.0; satrec.zmos  = 0.0; satrec.atime = 0.0;
      satrec.xli   = 0.0; satrec.xni   = 0.0;
+     for (int k = 0; k < DSCHECKPOINTS; k++)
+       {
+         satrec.ckatime[k] = 0.0; satrec.ckxli[k] = 0.0; satrec.ckxni[k] = 0.0;
+       }
+     satrec.cknext = 0;      satrec.dssteps = 0;
 
      // sgp4fix - note the following variables are also passed directly via satrec.
      // it is possible to streamline the sgp4init call by deleting the "x"
@@ -1612,6 +1653,49 @@ bool sgp4init
        return true;
 }  // end sgp4init
 
+/* -----------------------------------------------------------------------------
+*
+*                    gravity constants and kernel types for sgp4
+*
+*  the same values as getgravconst(), but as compile time parameters of the
+*    propagation kernels so they are not looked up on every call. xke is
+*    written as the literal that getgravconst() computes,
+*    60 / sqrt(radiusearthkm^3 / mu), to the last bit.
+*
+*  kernel types   :
+*    nearsimple  - near earth, perigee below 220 km (isimp = 1)
+*    nearfull    - near earth with the drag terms d2 .. d4 (isimp = 0)
+*    deepspace   - period of 225 min or more (method = 'd', isimp = 1)
+  ----------------------------------------------------------------------------*/
+
+enum sgp4kind { nearsimple, nearfull, deepspace };
+
+template <gravconsttype whichconst> struct gravconst;
+
+template <> struct gravconst<wgs72old>
+{
+  static constexpr double radiusearthkm = 6378.135;
+  static constexpr double xke           = 0.0743669161;
+  static constexpr double j2            = 0.001082616;
+  static constexpr double j3oj2         = -0.00000253881 / 0.001082616;
+};
+
+template <> struct gravconst<wgs72>
+{
+  static constexpr double radiusearthkm = 6378.135;
+  static constexpr double xke           = 0.074366916133173422;   // mu = 398600.8
+  static constexpr double j2            = 0.001082616;
+  static constexpr double j3oj2         = -0.00000253881 / 0.001082616;
+};
+
+template <> struct gravconst<wgs84>
+{
+  static constexpr double radiusearthkm = 6378.137;
+  static constexpr double xke           = 0.074366853168713845;   // mu = 398600.5
+  static constexpr double j2            = 0.00108262998905;
+  static constexpr double j3oj2         = -0.00000253215306 / 0.00108262998905;
+};
+
 /*-----------------------------------------------------------------------------
 *
 *                             procedure sgp4
@@ -1699,10 +1783,11 @@ bool sgp4init
 *    vallado, crawford, hujsak, kelso  2006
   ----------------------------------------------------------------------------*/
 
-bool sgp4
+template <gravconsttype whichconst, int kind>
+static bool sgp4kernelt
      (
-       gravconsttype whichconst, elsetrec& satrec,  double tsince,
-       double r[3],  double v[3]
+       const elsetrec& satrec, sgp4state& state,
+       double tsince, double r[3],  double v[3]
      )
 {
      double am   , axnl  , aynl , betal ,  cosim , cnod  ,
@@ -1716,10 +1801,13 @@ bool sgp4
          uy   , uz    , vx   , vy    ,  vz    , inclm , mm  ,
          nm   , nodem, xinc , xincp ,  xl    , xlm   , mp  ,
          xmdf , xmx   , xmy  , nodedf, xnode , nodep, tc  , dndt,
-         twopi, x2o3  , j2   , j3    , tumin, j4 , xke   , j3oj2, radiusearthkm,
-         mu, vkmpersec, delmtemp;
+         twopi, x2o3  , vkmpersec, delmtemp;
      int ktr;
 
+     // recomputed for deep space objects on every call
+     double aycof  = satrec.aycof,  xlcof  = satrec.xlcof,  con41 = satrec.con41,
+            x1mth2 = satrec.x1mth2, x7thm1 = satrec.x7thm1;
+
      /* ------------------ set mathematical constants --------------- */
      // sgp4fix divisor for divide by zero check on inclination
      // the old check used 1.0 + cos(pi-1.0e-9), but then compared it to
@@ -1727,29 +1815,32 @@ bool sgp4
      const double temp4 =   1.5e-12;
      twopi = 2.0 * pi;
      x2o3  = 2.0 / 3.0;
-     // sgp4fix identify constants and allow alternate values
-     getgravconst( whichconst, tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2 );
+     // constants of the gravity model chosen at compile time
+     const double radiusearthkm = gravconst<whichconst>::radiusearthkm;
+     const double xke           = gravconst<whichconst>::xke;
+     const double j2            = gravconst<whichconst>::j2;
+     const double j3oj2         = gravconst<whichconst>::j3oj2;
      vkmpersec     = radiusearthkm * xke/60.0;
 
      /* --------------------- clear sgp4 error flag ----------------- */
-     satrec.t     = tsince;
-     satrec.error = 0;
+     state.t     = tsince;
+     state.error = 0;
 
      /* ------- update for secular gravity and atmospheric drag ----- */
-     xmdf    = satrec.mo + satrec.mdot * satrec.t;
-     argpdf  = satrec.argpo + satrec.argpdot * satrec.t;
-     nodedf  = satrec.nodeo + satrec.nodedot * satrec.t;
+     xmdf    = satrec.mo + satrec.mdot * state.t;
+     argpdf  = satrec.argpo + satrec.argpdot * state.t;
+     nodedf  = satrec.nodeo + satrec.nodedot * state.t;
      argpm   = argpdf;
      mm      = xmdf;
-     t2      = satrec.t * satrec.t;
+     t2      = state.t * state.t;
      nodem   = nodedf + satrec.nodecf * t2;
-     tempa   = 1.0 - satrec.cc1 * satrec.t;
-     tempe   = satrec.bstar * satrec.cc4 * satrec.t;
+     tempa   = 1.0 - satrec.cc1 * state.t;
+     tempe   = satrec.bstar * satrec.cc4 * state.t;
      templ   = satrec.t2cof * t2;
 
-     if (satrec.isimp != 1)
+     if (kind == nearfull)
        {
-         delomg = satrec.omgcof * satrec.t;
+         delomg = satrec.omgcof * state.t;
          // sgp4fix use mutliply for speed instead of pow
          delmtemp =  1.0 + satrec.eta * cos(xmdf);
          delm   = satrec.xmcof *
@@ -1758,22 +1849,22 @@ bool sgp4
          temp   = delomg + delm;
          mm     = xmdf + temp;
          argpm  = argpdf - temp;
-         t3     = t2 * satrec.t;
-         t4     = t3 * satrec.t;
+         t3     = t2 * state.t;
+         t4     = t3 * state.t;
          tempa  = tempa - satrec.d2 * t2 - satrec.d3 * t3 -
                           satrec.d4 * t4;
          tempe  = tempe + satrec.bstar * satrec.cc5 * (sin(mm) -
                           satrec.sinmao);
          templ  = templ + satrec.t3cof * t3 + t4 * (satrec.t4cof +
-                          satrec.t * satrec.t5cof);
+                          state.t * satrec.t5cof);
        }
 
      nm    = satrec.no;
      em    = satrec.ecco;
      inclm = satrec.inclo;
-     if (satrec.method == 'd')
+     if (kind == deepspace)
        {
-         tc = satrec.t;
+         tc = state.t;
          dspace
              (
                satrec.irez,
@@ -1783,18 +1874,20 @@ bool sgp4
                satrec.d5433, satrec.dedt,  satrec.del1,
                satrec.del2,  satrec.del3,  satrec.didt,
                satrec.dmdt,  satrec.dnodt, satrec.domdt,
-               satrec.argpo, satrec.argpdot, satrec.t, tc,
+               satrec.argpo, satrec.argpdot, state.t, tc,
                satrec.gsto, satrec.xfact, satrec.xlamo,
-               satrec.no, satrec.atime,
-               em, argpm, inclm, satrec.xli, mm, satrec.xni,
-               nodem, dndt, nm
+               satrec.no, state.atime,
+               em, argpm, inclm, state.xli, mm, state.xni,
+               nodem, dndt, nm,
+               state.ckatime, state.ckxli, state.ckxni,
+               state.cknext, state.dssteps
              );
        } // if method = d
 
      if (nm <= 0.0)
        {
 //         printf("# error nm %f\n", nm);
-         satrec.error = 2;
+         state.error = 2;
          // sgp4fix add return
          return false;
        }
@@ -1807,7 +1900,7 @@ bool sgp4
      if ((em >= 1.0) || (em < -0.001)/* || (am < 0.95)*/ )
        {
 //         printf("# error em %f\n", em);
-         satrec.error = 1;
+         state.error = 1;
          // sgp4fix to return if there is an error in eccentricity
          return false;
        }
@@ -1836,7 +1929,7 @@ bool sgp4
      mp     = mm;
      sinip  = sinim;
      cosip  = cosim;
-     if (satrec.method == 'd')
+     if (kind == deepspace)
        {
          dpper
              (
@@ -1846,7 +1939,7 @@ bool sgp4
                satrec.sgh2, satrec.sgh3, satrec.sgh4,
                satrec.sh2,  satrec.sh3,  satrec.si2,
                satrec.si3,  satrec.sl2,  satrec.sl3,
-               satrec.sl4,  satrec.t,    satrec.xgh2,
+               satrec.sl4,  state.t,    satrec.xgh2,
                satrec.xgh3, satrec.xgh4, satrec.xh2,
                satrec.xh3,  satrec.xi2,  satrec.xi3,
                satrec.xl2,  satrec.xl3,  satrec.xl4,
@@ -1862,28 +1955,28 @@ bool sgp4
          if ((ep < 0.0 ) || ( ep > 1.0))
            {
 //            printf("# error ep %f\n", ep);
-             satrec.error = 3;
+             state.error = 3;
              // sgp4fix add return
              return false;
            }
        } // if method = d
 
      /* -------------------- long period periodics ------------------ */
-     if (satrec.method == 'd')
+     if (kind == deepspace)
        {
          sinip =  sin(xincp);
          cosip =  cos(xincp);
-         satrec.aycof = -0.5*j3oj2*sinip;
+         aycof = -0.5*j3oj2*sinip;
          // sgp4fix for divide by zero for xincp = 180 deg
          if (fabs(cosip+1.0) > 1.5e-12)
-             satrec.xlcof = -0.25 * j3oj2 * sinip * (3.0 + 5.0 * cosip) / (1.0 + cosip);
+             xlcof = -0.25 * j3oj2 * sinip * (3.0 + 5.0 * cosip) / (1.0 + cosip);
            else
-             satrec.xlcof = -0.25 * j3oj2 * sinip * (3.0 + 5.0 * cosip) / temp4;
+             xlcof = -0.25 * j3oj2 * sinip * (3.0 + 5.0 * cosip) / temp4;
        }
      axnl = ep * cos(argpp);
      temp = 1.0 / (am * (1.0 - ep * ep));
-     aynl = ep* sin(argpp) + temp * satrec.aycof;
-     xl   = mp + argpp + nodep + temp * satrec.xlcof * axnl;
+     aynl = ep* sin(argpp) + temp * aycof;
+     xl   = mp + argpp + nodep + temp * xlcof * axnl;
 
      /* --------------------- solve kepler's equation --------------- */
      u    = floatmod(xl - nodep, twopi);
@@ -1912,7 +2005,7 @@ bool sgp4
      if (pl < 0.0)
        {
 //         printf("# error pl %f\n", pl);
-         satrec.error = 4;
+         state.error = 4;
          // sgp4fix add return
          return false;
        }
@@ -1933,21 +2026,21 @@ bool sgp4
          temp2  = temp1 * temp;
 
          /* -------------- update for short period periodics ------------ */
-         if (satrec.method == 'd')
+         if (kind == deepspace)
            {
              cosisq                 = cosip * cosip;
-             satrec.con41  = 3.0*cosisq - 1.0;
-             satrec.x1mth2 = 1.0 - cosisq;
-             satrec.x7thm1 = 7.0*cosisq - 1.0;
+             con41  = 3.0*cosisq - 1.0;
+             x1mth2 = 1.0 - cosisq;
+             x7thm1 = 7.0*cosisq - 1.0;
            }
-         mrt   = rl * (1.0 - 1.5 * temp2 * betal * satrec.con41) +
-                 0.5 * temp1 * satrec.x1mth2 * cos2u;
-         su    = su - 0.25 * temp2 * satrec.x7thm1 * sin2u;
+         mrt   = rl * (1.0 - 1.5 * temp2 * betal * con41) +
+                 0.5 * temp1 * x1mth2 * cos2u;
+         su    = su - 0.25 * temp2 * x7thm1 * sin2u;
          xnode = nodep + 1.5 * temp2 * cosip * sin2u;
          xinc  = xincp + 1.5 * temp2 * cosip * sinip * cos2u;
-         mvt   = rdotl - nm * temp1 * satrec.x1mth2 * sin2u / xke;
-         rvdot = rvdotl + nm * temp1 * (satrec.x1mth2 * cos2u +
-                 1.5 * satrec.con41) / xke;
+         mvt   = rdotl - nm * temp1 * x1mth2 * sin2u / xke;
+         rvdot = rvdotl + nm * temp1 * (x1mth2 * cos2u +
+                 1.5 * con41) / xke;
 
          /* --------------------- orientation vectors ------------------- */
          sinsu =  sin(su);
@@ -1978,15 +2071,154 @@ bool sgp4
      if (mrt < 1.0)
        {
 //         printf("# decay condition %11.6f \n",mrt);
-         satrec.error = 6;
+         state.error = 6;
          return false;
        }
 
 //#include "debug7.cpp"
      return true;
+}  // end sgp4kernelt
+
+
+/* -----------------------------------------------------------------------------
+*
+*                           function sgp4select
+*
+*  this function returns the propagation kernel for the gravity model and the
+*    orbit type of an element set, so the choice is made once instead of in
+*    every call to sgp4().
+*
+*  inputs        :
+*    whichconst  - which set of constants to use  72, 84
+*    satrec      - initialised structure from sgp4init() call.
+*
+*  outputs       :
+*    sgp4select  - kernel with the same arguments as sgp4() (sgp4state version)
+  ----------------------------------------------------------------------------*/
+
+template <gravconsttype whichconst>
+static sgp4kernel sgp4selectkind(const elsetrec& satrec)
+{
+     if (satrec.method == 'd')
+         return &sgp4kernelt<whichconst, deepspace>;
+     if (satrec.isimp == 1)
+         return &sgp4kernelt<whichconst, nearsimple>;
+     return &sgp4kernelt<whichconst, nearfull>;
+}
+
+sgp4kernel sgp4select
+     (
+       gravconsttype whichconst, const elsetrec& satrec
+     )
+{
+     switch (whichconst)
+       {
+         case wgs72old:
+           return sgp4selectkind<wgs72old>(satrec);
+         case wgs72:
+           return sgp4selectkind<wgs72>(satrec);
+         default:
+           return sgp4selectkind<wgs84>(satrec);
+       }
+}  // end sgp4select
+
+
+bool sgp4
+     (
+       gravconsttype whichconst, const elsetrec& satrec, sgp4state& state,
+       double tsince, double r[3],  double v[3]
+     )
+{
+     return sgp4select(whichconst, satrec)(satrec, state, tsince, r, v);
 }  // end sgp4
 
 
+/* -----------------------------------------------------------------------------
+*
+*                             procedure sgp4 (elsetrec)
+*
+*  this procedure runs sgp4 on an element set that also holds the propagation
+*    state (error, time and deep space integrator). it is kept for the
+*    existing callers, several propagations of the same satellite at the same
+*    time should use the version with a separate sgp4state.
+*
+*  inputs        :
+*    satrec	 - initialised structure from sgp4init() call.
+*    tsince	 - time eince epoch (minutes)
+*
+*  outputs       :
+*    r           - position vector                     km
+*    v           - velocity                            km/sec
+*    satrec      - error, t and the integrator state are updated
+  ----------------------------------------------------------------------------*/
+
+bool sgp4
+     (
+       gravconsttype whichconst, elsetrec& satrec,  double tsince,
+       double r[3],  double v[3]
+     )
+{
+     return sgp4(sgp4select(whichconst, satrec), satrec, tsince, r, v);
+}  // end sgp4 (elsetrec)
+
+bool sgp4
+     (
+       sgp4kernel kernel, elsetrec& satrec,  double tsince,
+       double r[3],  double v[3]
+     )
+{
+     sgp4state state;
+     bool ok;
+
+     sgp4initstate(satrec, state);
+     ok = kernel(satrec, state, tsince, r, v);
+
+     satrec.t       = state.t;
+     satrec.error   = state.error;
+     satrec.atime   = state.atime;
+     satrec.xli     = state.xli;
+     satrec.xni     = state.xni;
+     memcpy(satrec.ckatime, state.ckatime, sizeof(state.ckatime));
+     memcpy(satrec.ckxli,   state.ckxli,   sizeof(state.ckxli));
+     memcpy(satrec.ckxni,   state.ckxni,   sizeof(state.ckxni));
+     satrec.cknext  = state.cknext;
+     satrec.dssteps = state.dssteps;
+     return ok;
+}  // end sgp4 (kernel, elsetrec)
+
+
+/* -----------------------------------------------------------------------------
+*
+*                           procedure sgp4initstate
+*
+*  this procedure copies the propagation state of an element set, e.g. to
+*    start a new sgp4state from a satrec returned by sgp4init().
+*
+*  inputs        :
+*    satrec      - initialised structure from sgp4init() call.
+*
+*  outputs       :
+*    state       - propagation state
+  ----------------------------------------------------------------------------*/
+
+void sgp4initstate
+     (
+       const elsetrec& satrec, sgp4state& state
+     )
+{
+     state.t       = satrec.t;
+     state.error   = satrec.error;
+     state.atime   = satrec.atime;
+     state.xli     = satrec.xli;
+     state.xni     = satrec.xni;
+     memcpy(state.ckatime, satrec.ckatime, sizeof(state.ckatime));
+     memcpy(state.ckxli,   satrec.ckxli,   sizeof(state.ckxli));
+     memcpy(state.ckxni,   satrec.ckxni,   sizeof(state.ckxni));
+     state.cknext  = satrec.cknext;
+     state.dssteps = satrec.dssteps;
+}  // end sgp4initstate
+
+
 /* -----------------------------------------------------------------------------
 *
 *                           function gstime
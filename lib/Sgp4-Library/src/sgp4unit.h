@@ -63,6 +63,9 @@ typedef enum
   wgs84
 } gravconsttype;
 
+// number of resonance integrator states kept to restart dspace without going back to epoch
+#define DSCHECKPOINTS 4
+
 typedef struct elsetrec
 {
   long int  satnum;
@@ -88,11 +91,30 @@ typedef struct elsetrec
          xgh3   , xgh4   , xh2    , xh3      , xi2    , xi3     , xl2   , xl3   ,
          xl4    , xlamo  , zmol   , zmos     , atime  , xli     , xni;
 
+  /* Deep Space resonance integrator checkpoints (states at atime = k * 720 min) */
+  double ckatime[DSCHECKPOINTS], ckxli[DSCHECKPOINTS], ckxni[DSCHECKPOINTS];
+  int    cknext;
+  long int dssteps;   // total number of resonance integration steps
+
   double a      , altp   , alta   , epochdays, jdsatepoch       , nddot , ndot  ,
          bstar  , rcse   , inclo  , nodeo    , ecco             , argpo , mo    ,
          no;
 } elsetrec;
 
+// the part of elsetrec changed by sgp4(), kept apart so a const elsetrec can be shared
+// between several propagations at different times
+typedef struct sgp4state
+{
+  double t;
+  int    error;
+
+  /* Deep Space resonance integrator */
+  double atime, xli, xni;
+  double ckatime[DSCHECKPOINTS], ckxli[DSCHECKPOINTS], ckxni[DSCHECKPOINTS];
+  int    cknext;
+  long int dssteps;
+} sgp4state;
+
 
 // --------------------------- function declarations ----------------------------
 bool sgp4init
@@ -103,12 +125,43 @@ bool sgp4init
        const double xnodeo,  elsetrec& satrec
      );
 
+// these two choose the kernel with sgp4select() on every call; repeated propagations of the
+// same element set should keep the kernel (Sgp4, Sgp4Model, Sgp4Batch) and call it directly
 bool sgp4
      (
        gravconsttype whichconst, elsetrec& satrec,  double tsince,
        double r[3],  double v[3]
      );
 
+bool sgp4
+     (
+       gravconsttype whichconst, const elsetrec& satrec, sgp4state& state,
+       double tsince, double r[3],  double v[3]
+     );
+
+void sgp4initstate
+     (
+       const elsetrec& satrec, sgp4state& state
+     );
+
+// propagation kernel specialised for one gravity model and orbit type, see sgp4select()
+typedef bool (*sgp4kernel)
+     (
+       const elsetrec& satrec, sgp4state& state,
+       double tsince, double r[3],  double v[3]
+     );
+
+sgp4kernel sgp4select
+     (
+       gravconsttype whichconst, const elsetrec& satrec
+     );
+
+bool sgp4
+     (
+       sgp4kernel kernel, elsetrec& satrec,  double tsince,
+       double r[3],  double v[3]
+     );
+
 double  gstime
         (
           double jdut1
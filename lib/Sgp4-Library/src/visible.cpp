@@ -96,66 +96,61 @@ void sun ( double jd, double rsun[3] ){
 
 }
 
-//returns angle between sun surface and earth surface, from the viewpoint of the satellite
-double Sgp4::visiblewrap(double jdCe) {
-	double rsun[3];   //vector between earth and sun
-	double razell[3];
-
-	sun(jdC, rsun);  //calculate sun poistion vector
-	rv2azel(rsun, siteLatRad, siteLonRad, siteAlt, jdC, razell);  //calc sun satEl
-
-	double rsunsat[3]; //vector between sat and sun
-	double rearth[3];
-	double magsunsat, magearth;
-	double phiearth, phisun, phi;
-	double rnomearth, rnomsun;
-
-	sgp4wrap(jdCe);
-
-	rearth[0] = -ro[0];
-	rearth[1] = -ro[1];
-	rearth[2] = -ro[2];
-
-	rsunsat[0] = rsun[0] + rearth[0];
-	rsunsat[1] = rsun[1] + rearth[1];
-	rsunsat[2] = rsun[2] + rearth[2];
-
-	magsunsat = mag(rsunsat);
-	magearth = mag(rearth);
-
-	phiearth = asin(earthradius / magearth);
-	phisun = asin(sunradius / magsunsat);
-
-	phi = acos(dot(rearth, rsunsat) / magsunsat / magearth);
+void suncacheclear(suncache& cache){
+  cache.jd0 = 0.0;
+}
 
-	return phi - phisun - phiearth;   ///grens op bijschaduw
-	//return -phiearth + phisun + phi;  ///grens op echte schaduw
+//sun vector and its direction in the horizon system of the site at jd
+static void sunedge(const ObserverFrame& frame, double jd, double rsun[3], double sez[3]){
+  double razel[3];
 
+  sun(jd, rsun);
+  rv2azel(rsun, frame, jd, razel);
+  sez[0] = -cos(razel[2]) * cos(razel[1]);
+  sez[1] = cos(razel[2]) * sin(razel[1]);
+  sez[2] = sin(razel[2]);
 }
 
+void sunlook(suncache& cache, const ObserverFrame& frame, double jd, double rsun[3], double* az, double* el){
 
-//calculate if satellite is visible
-int16_t Sgp4::visible(bool& notdark, double& deltaphi){
+  double step = SUN_BUCKET / 1440.0;
+  double jd0 = floor(jd / step) * step;
+  int i;
 
-    double rsun[3];   //vector between earth and sun
-    double razell[3];
-
-    sun(jdC, rsun);  //calculate sun poistion vector
-    rv2azel(rsun, siteLatRad, siteLonRad, siteAlt, jdC, razell);  //calc sun satEl
+  if (jd0 != cache.jd0){
+    if (cache.jd0 != 0.0 && fabs(jd0 - cache.jd0 - step) < step * 0.5){  //next bucket: its start is the end of the cached one
+      for (i = 0; i < 3; i++){
+        cache.rsun0[i] = cache.rsun1[i];
+        cache.sez0[i] = cache.sez1[i];
+      }
+    }else{
+      sunedge(frame, jd0, cache.rsun0, cache.sez0);
+    }
+    sunedge(frame, jd0 + step, cache.rsun1, cache.sez1);
+    cache.jd0 = jd0;
+  }
+
+  double f = (jd - jd0) / step;
+  double sez[3];
+  for (i = 0; i < 3; i++){
+    rsun[i] = cache.rsun0[i] + f * (cache.rsun1[i] - cache.rsun0[i]);
+    sez[i] = cache.sez0[i] + f * (cache.sez1[i] - cache.sez0[i]);
+  }
+  if (el) *el = asin(sez[2] / mag(sez));
+  if (az) *az = atan2(sez[1], -sez[0]);   //same convention as rv2azel()
+}
 
-    sunEl = razell[2] * 180 / pi;
-      sunAz = razell[1] * 180 / pi;
-  	  notdark = (razell[2] > sunoffset); //sun aboven -6°  => not dark enough
+//approach to the surface coverage with a square sun and earth
+int16_t sunlit(const double rsat[3], const double rsun[3], double* deltaphi){
 
     double rsunsat[3]; //vector between sat and sun
     double rearth[3];
     double magsunsat, magearth;
     double phiearth, phisun, phi;
-	double rnomearth, rnomsun;
 
-    rearth[0] = -ro[0];
-    rearth[1] = -ro[1];
-    rearth[2] = -ro[2];
+    rearth[0] = -rsat[0];
+    rearth[1] = -rsat[1];
+    rearth[2] = -rsat[2];
 
     rsunsat[0] = rsun[0] + rearth[0];
     rsunsat[1] = rsun[1] + rearth[1];
@@ -168,26 +163,58 @@ int16_t Sgp4::visible(bool& notdark, double& deltaphi){
     phisun = asin(sunradius/magsunsat);
 
     phi = acos(dot(rearth,rsunsat)/magsunsat/magearth);
-	deltaphi = phi - phisun - phiearth;
+    if (deltaphi) *deltaphi = phi - phisun - phiearth;   ///grens op bijschaduw
 
     if (phiearth > phisun && phi < phiearth - phisun){   //umbral eclipse
         return 0;
     }
 
     if (phiearth < phisun && phi < phisun - phiearth){  //partial eclipse
-      return (int16_t)(( 1 - phiearth*phiearth/(phisun*phisun) )*1000);  //approach to the surface coverage with a square sun and earth
+      return (int16_t)(( 1 - phiearth*phiearth/(phisun*phisun) )*1000);
     }
 
     if (fabs(phiearth-phisun) < phi && phi < phiearth + phisun){  //penumbral eclipse
         if (phiearth > phisun){
-             return (int16_t)(( (phisun+phi-phiearth)/(phisun*2.0) )*1000);  //approach to the surface coverage with a square sun and earth
+             return (int16_t)(( (phisun+phi-phiearth)/(phisun*2.0) )*1000);
         }else{
-             return (int16_t)(( 1 - phiearth*(phisun - phi + phiearth)/(2.0*phisun*phisun) )*1000);  //approach to the surface coverage with a square sun and earth
+             return (int16_t)(( 1 - phiearth*(phisun - phi + phiearth)/(2.0*phisun*phisun) )*1000);
         }
     }
 
     return 1000;  //no eclipse => visible
+}
+
+visibletype illumination(const double rsat[3], const double rsun[3], double sunel, double sunoffset){
+  if (sunel > sunoffset) return sgp4daylight;
+  if (sunlit(rsat, rsun, NULL) < 1000) return eclipsed;
+  return lighted;
+}
+
+//returns angle between sun surface and earth surface, from the viewpoint of the satellite
+double Sgp4::visiblewrap(double jdCe) {
+	double rsun[3];   //vector between earth and sun
+	double deltaphi;
+
+	sgp4wrap(jdCe);
+	sunlook(suncached, observer(jdCe), jdCe, rsun, NULL, NULL);  //cached: no sun az/el needed here
+	sunlit(ro, rsun, &deltaphi);
+	return deltaphi;   ///grens op bijschaduw
+}
+
+
+//calculate if satellite is visible
+int16_t Sgp4::visible(bool& notdark, double& deltaphi){
+
+    double rsun[3];   //vector between earth and sun
+    double az, el;
+
+    sunlook(suncached, observer(jdC), jdC, rsun, &az, &el);  //sun position and sun satEl from the cache
+
+    sunEl = el * 180 / pi;
+    sunAz = az * 180 / pi;
+    notdark = (el > sunoffset); //sun aboven -6°  => not dark enough
 
+    return sunlit(ro, rsun, &deltaphi);
 }
 
 int16_t Sgp4::visible() {
@@ -0,0 +1,384 @@
+#include "ConjunctionScreener.h"
+#include <brent.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <math.h>
+
+static constexpr double JD_UNIX_EPOCH   = 2440587.5;
+static constexpr double SECONDS_PER_DAY = 86400.0;
+static constexpr double EARTH_RADIUS_KM = 6378.135;   // unidade de alta/altp (wgs72)
+static constexpr double EARTH_MU        = 398600.8;   // km³/s²
+
+static constexpr double SHELL_MARGIN_KM = 25.0;   // termos periódicos do SGP4 e arrasto na janela, por casca
+static constexpr double SPEED_MARGIN    = 1.05;   // velocidade osculadora acima da média no perigeu
+static constexpr double TCA_TOLERANCE_S = 0.001;  // precisão do TCA em brentmin() (15 m a 15 km/s)
+static constexpr double FAR_KM          = 1e9;    // distância devolvida com erro de propagação
+
+static constexpr int GRID_BITS = 10;
+static constexpr long GRID_SIZE = 1L << GRID_BITS;   // células por eixo (posições além ficam na borda)
+
+/// Par em refinamento, passado a separation() por brentmin().
+struct PairProbe {
+    Sgp4Batch* batch;
+    double jdStart;
+    int a;
+    int b;
+    long* evaluations;
+};
+
+static long microsNow() {
+    using namespace std::chrono;
+    return static_cast<long>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+static inline uint32_t pairKey(uint16_t a, uint16_t b) {
+    return (static_cast<uint32_t>(a) << 16) | b;
+}
+
+static inline uint32_t cellKey(long x, long y, long z) {
+    return (static_cast<uint32_t>(x) << (2 * GRID_BITS)) | (static_cast<uint32_t>(y) << GRID_BITS) |
+           static_cast<uint32_t>(z);
+}
+
+static inline double dot3(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static inline void sub3(const double a[3], const double b[3], double out[3]) {
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+ConjunctionScreener::ConjunctionScreener()
+    : threshold(10.0), step(60), jdStart(0.0), startUnix(0), window(0), cellSize(1.0), shellGap(0.0), rejected(0),
+      sample(0), samples(0), tPrev(0.0), done(true), stats() {}
+
+void ConjunctionScreener::clear() {
+    batch.clear();
+    indices.clear();
+    low.clear();
+    high.clear();
+    speed.clear();
+    conjunctions.clear();
+    rejected = 0;
+    done = true;
+    stats = ConjunctionStats();
+}
+
+//
+// Casca de perigeu/apogeu e velocidade máxima a partir dos elementos médios
+//
+bool ConjunctionScreener::addSatellite(uint16_t index, const elsetrec& satrec) {
+    stats.satellites++;
+    if (satrec.error != 0 || satrec.no <= 0.0 || satrec.ecco >= 1.0 || indices.size() >= 0xFFFF) {
+        rejected++;
+        stats.failed++;
+        return false;
+    }
+    double perigee = (satrec.altp + 1.0) * EARTH_RADIUS_KM;
+    double apogee  = (satrec.alta + 1.0) * EARTH_RADIUS_KM;
+    double a = (perigee + apogee) / 2.0;
+    double perigeeSpeed = sqrt(EARTH_MU / a * (1.0 + satrec.ecco) / (1.0 - satrec.ecco));
+
+    batch.add(satrec);
+    indices.push_back(index);
+    low.push_back(static_cast<float>(perigee));
+    high.push_back(static_cast<float>(apogee));
+    speed.push_back(static_cast<float>(perigeeSpeed * SPEED_MARGIN));
+    return true;
+}
+
+//
+// Sort-and-sweep: em ordem de perigeu, cada casca só pode sobrepor as seguintes até
+// o primeiro perigeu acima do seu apogeu
+//
+void ConjunctionScreener::sweepShells() {
+    const int n = static_cast<int>(indices.size());
+    std::vector<uint16_t> order(n);
+    for (int i = 0; i < n; i++) {
+        order[i] = static_cast<uint16_t>(i);
+    }
+    std::sort(order.begin(), order.end(), [this](uint16_t a, uint16_t b) { return low[a] < low[b]; });
+
+    partnered.assign(n, 0);
+    stats.shellPairs = 0;
+    for (int i = 0; i < n; i++) {
+        uint16_t a = order[i];
+        for (int j = i + 1; j < n && low[order[j]] <= high[a] + shellGap; j++) {
+            stats.shellPairs++;
+            partnered[a] = 1;
+            partnered[order[j]] = 1;
+        }
+    }
+    stats.isolated = static_cast<int>(std::count(partnered.begin(), partnered.end(), 0));
+}
+
+uint32_t ConjunctionScreener::cellOf(const double r[3]) const {
+    long c[3];
+    for (int i = 0; i < 3; i++) {
+        c[i] = static_cast<long>(floor(r[i] / cellSize)) + GRID_SIZE / 2;
+        c[i] = c[i] < 0 ? 0 : (c[i] >= GRID_SIZE ? GRID_SIZE - 1 : c[i]);
+    }
+    return cellKey(c[0], c[1], c[2]);
+}
+
+//
+// Grade espacial: satélites ordenados por célula; para cada célula, as 9 colunas vizinhas
+// (x, y) são faixas contínuas de z na ordem das chaves
+//
+void ConjunctionScreener::flagPairs(const double r[][3], const int8_t error[]) {
+    const int n = static_cast<int>(indices.size());
+    cells.clear();
+    flagged.clear();
+    for (int i = 0; i < n; i++) {
+        if (partnered[i] && error[i] == 0) {
+            Cell cell = { cellOf(r[i]), static_cast<uint16_t>(i) };
+            cells.push_back(cell);
+        }
+    }
+    std::sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) { return a.key < b.key; });
+
+    auto keyLess = [](const Cell& cell, uint32_t key) { return cell.key < key; };
+    auto lessKey = [](uint32_t key, const Cell& cell) { return key < cell.key; };
+
+    for (size_t c = 0; c < cells.size();) {
+        const uint32_t key = cells[c].key;
+        size_t e = c;
+        while (e < cells.size() && cells[e].key == key) {
+            e++;
+        }
+        long x = key >> (2 * GRID_BITS);
+        long y = (key >> GRID_BITS) & (GRID_SIZE - 1);
+        long z = key & (GRID_SIZE - 1);
+        long zLow = z > 0 ? z - 1 : z;
+        long zHigh = z < GRID_SIZE - 1 ? z + 1 : z;
+
+        for (long nx = x - 1; nx <= x + 1; nx++) {
+            for (long ny = y - 1; ny <= y + 1; ny++) {
+                if (nx < 0 || ny < 0 || nx >= GRID_SIZE || ny >= GRID_SIZE) {
+                    continue;
+                }
+                auto first = std::lower_bound(cells.begin(), cells.end(), cellKey(nx, ny, zLow), keyLess);
+                auto last = std::upper_bound(first, cells.end(), cellKey(nx, ny, zHigh), lessKey);
+                for (size_t p = c; p < e; p++) {
+                    const uint16_t a = cells[p].sat;
+                    for (auto q = first; q != last; ++q) {
+                        const uint16_t b = q->sat;
+                        if (a >= b || !shellsOverlap(a, b)) {
+                            continue;   // cada par uma vez, a partir do menor índice
+                        }
+                        stats.checks++;
+                        double d[3];
+                        sub3(r[b], r[a], d);
+                        double limit = reach(a, b);
+                        if (dot3(d, d) < limit * limit) {
+                            flagged.push_back(pairKey(a, b));
+                        }
+                    }
+                }
+            }
+        }
+        c = e;
+    }
+    std::sort(flagged.begin(), flagged.end());
+}
+
+double ConjunctionScreener::separation(double t, void* data) {
+    PairProbe* probe = static_cast<PairProbe*>(data);
+    double jd = probe->jdStart + t / SECONDS_PER_DAY;
+    double ra[3], va[3], rb[3], vb[3], d[3];
+    *probe->evaluations += 2;
+    if (probe->batch->state(probe->a, jd, ra, va) != 0 || probe->batch->state(probe->b, jd, rb, vb) != 0) {
+        return FAR_KM;
+    }
+    sub3(rb, ra, d);
+    return sqrt(dot3(d, d));
+}
+
+void ConjunctionScreener::refine(uint16_t a, uint16_t b, double t0, double t1, double guess) {
+    stats.candidates++;
+    PairProbe probe = { &batch, jdStart, a, b, &stats.evaluations };
+    if (!(guess > t0 && guess < t1)) {
+        guess = (t0 + t1) / 2.0;
+    }
+    double tca;
+    double distance = brentmin(t0, guess, t1, &ConjunctionScreener::separation, &probe, TCA_TOLERANCE_S, &tca);
+    if (tca < 0.0 || distance >= threshold) {
+        return;
+    }
+
+    double jd = jdStart + tca / SECONDS_PER_DAY;
+    double ra[3], va[3], rb[3], vb[3], dv[3];
+    batch.state(a, jd, ra, va);
+    batch.state(b, jd, rb, vb);
+    stats.evaluations += 2;
+    sub3(vb, va, dv);
+
+    Conjunction conjunction;
+    conjunction.first    = indices[a] < indices[b] ? indices[a] : indices[b];
+    conjunction.second   = indices[a] < indices[b] ? indices[b] : indices[a];
+    conjunction.tca      = startUnix + static_cast<unsigned long>(tca + 0.5);
+    conjunction.distance = static_cast<float>(distance);
+    conjunction.speed    = static_cast<float>(sqrt(dot3(dv, dv)));
+    conjunctions.push_back(conjunction);
+    stats.conjunctions++;
+}
+
+int ConjunctionScreener::screen(unsigned long unixStart, unsigned long duration) {
+    if (begin(unixStart, duration)) {
+        run(0);
+    }
+    return stats.conjunctions;
+}
+
+//
+// Cascas, tamanho da célula e memória das amostras; a varredura em si é feita por run()
+//
+bool ConjunctionScreener::begin(unsigned long unixStart, unsigned long duration) {
+    const int n = static_cast<int>(indices.size());
+    conjunctions.clear();
+    stats.failed = rejected;
+    stats.isolated = 0;
+    stats.pairs = static_cast<long>(n) * (n - 1) / 2;
+    stats.shellPairs = 0;
+    stats.checks = 0;
+    stats.candidates = 0;
+    stats.conjunctions = 0;
+    stats.evaluations = 0;
+    done = true;
+    sample = 0;
+    samples = 0;
+    if (n < 2) {
+        return false;
+    }
+
+    startUnix = unixStart;
+    window = duration;
+    jdStart = JD_UNIX_EPOCH + unixStart / SECONDS_PER_DAY;
+    shellGap = threshold + 2.0 * SHELL_MARGIN_KM;
+    sweepShells();
+
+    double maxSpeed = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (partnered[i] && speed[i] > maxSpeed) {
+            maxSpeed = speed[i];
+        }
+    }
+    cellSize = threshold + maxSpeed * step;   // o maior reach() de um par
+
+    rPrev.assign(n * 3, 0.0);
+    vPrev.assign(n * 3, 0.0);
+    rCur.assign(n * 3, 0.0);
+    vCur.assign(n * 3, 0.0);
+    errPrev.assign(n, 0);
+    errCur.assign(n, 0);
+    failed.assign(n, 0);
+    previous.clear();
+
+    samples = (duration + step - 1) / step;
+    tPrev = 0.0;
+    done = false;
+    return true;
+}
+
+//
+// Varredura da janela: uma propagação do grupo por passo, grade espacial na amostra e
+// refinamento dos pares próximos em que a distância passa de decrescente a crescente
+//
+bool ConjunctionScreener::run(unsigned long budgetUs) {
+    if (done) {
+        return true;
+    }
+    const int n = static_cast<int>(indices.size());
+    long t0 = microsNow();
+
+    while (sample <= samples) {
+        unsigned long k = sample;
+        double t = static_cast<double>(k * step < window ? k * step : window);
+        double (*r0)[3] = reinterpret_cast<double (*)[3]>(rPrev.data());
+        double (*v0)[3] = reinterpret_cast<double (*)[3]>(vPrev.data());
+        double (*r1)[3] = reinterpret_cast<double (*)[3]>(rCur.data());
+        double (*v1)[3] = reinterpret_cast<double (*)[3]>(vCur.data());
+
+        batch.propagate(jdStart + t / SECONDS_PER_DAY, r1, v1, errCur.data());
+        stats.evaluations += n;
+        for (int i = 0; i < n; i++) {
+            failed[i] |= errCur[i] != 0;
+        }
+        flagPairs(r1, errCur.data());
+
+        if (k > 0) {
+            // Um mínimo abaixo do limite entre as amostras deixa o par próximo em uma delas
+            merged.clear();
+            std::set_union(previous.begin(), previous.end(), flagged.begin(), flagged.end(),
+                           std::back_inserter(merged));
+            for (uint32_t key : merged) {
+                uint16_t a = static_cast<uint16_t>(key >> 16);
+                uint16_t b = static_cast<uint16_t>(key & 0xFFFF);
+                if (errPrev[a] || errPrev[b] || errCur[a] || errCur[b]) {
+                    continue;
+                }
+                double dr0[3], dv0[3], dr1[3], dv1[3];
+                sub3(r0[b], r0[a], dr0);
+                sub3(v0[b], v0[a], dv0);
+                sub3(r1[b], r1[a], dr1);
+                sub3(v1[b], v1[a], dv1);
+                double rate0 = dot3(dr0, dv0);
+                double rate1 = dot3(dr1, dv1);
+                if (rate0 >= 0.0 || rate1 < 0.0) {
+                    continue;   // sem mínimo da distância entre as amostras
+                }
+                // Limite inferior da distância no intervalo pela velocidade relativa máxima
+                double bound = (sqrt(dot3(dr0, dr0)) + sqrt(dot3(dr1, dr1)) - (speed[a] + speed[b]) * (t - tPrev)) / 2.0;
+                if (bound >= threshold) {
+                    continue;
+                }
+                // Movimento relativo retilíneo a partir de cada amostra; a gravidade desvia a
+                // trajetória relativa no máximo (g1 + g2) * span² / 2 ao longo do intervalo
+                double span = t - tPrev;
+                double bend = EARTH_MU * (1.0 / (low[a] * low[a]) + 1.0 / (low[b] * low[b])) * span * span / 2.0;
+                double dv2 = dot3(dv0, dv0);
+                double line0 = dv2 > 0.0 ? sqrt(fmax(dot3(dr0, dr0) - rate0 * rate0 / dv2, 0.0)) : 0.0;
+                double dv12 = dot3(dv1, dv1);
+                double line1 = dv12 > 0.0 ? sqrt(fmax(dot3(dr1, dr1) - rate1 * rate1 / dv12, 0.0)) : 0.0;
+                if (fmax(line0, line1) - bend >= threshold) {
+                    continue;
+                }
+                double guess = dv2 > 0.0 ? tPrev - rate0 / dv2 : (tPrev + t) / 2.0;
+                refine(a, b, tPrev, t, guess);
+            }
+        }
+
+        rPrev.swap(rCur);
+        vPrev.swap(vCur);
+        errPrev.swap(errCur);
+        previous.swap(flagged);
+        tPrev = t;
+        sample++;
+
+        if (budgetUs > 0 && sample <= samples && static_cast<unsigned long>(microsNow() - t0) >= budgetUs) {
+            return false;
+        }
+    }
+
+    // Fim da janela: libera as amostras e ordena o resultado
+    std::vector<double>().swap(rPrev);
+    std::vector<double>().swap(vPrev);
+    std::vector<double>().swap(rCur);
+    std::vector<double>().swap(vCur);
+    stats.failed += static_cast<int>(std::count(failed.begin(), failed.end(), 1));
+    std::sort(conjunctions.begin(), conjunctions.end(), [](const Conjunction& a, const Conjunction& b) {
+        return a.tca < b.tca || (a.tca == b.tca && (a.first < b.first || (a.first == b.first && a.second < b.second)));
+    });
+    done = true;
+    return true;
+}
+
+float ConjunctionScreener::progress() const {
+    if (done) {
+        return 1.0f;
+    }
+    return samples > 0 ? static_cast<float>(sample) / (samples + 1) : 0.0f;
+}
@@ -0,0 +1,168 @@
+#include "ElementCache.h"
+#include "SatelliteTracker.h"
+#include <stddef.h>
+
+ElementCache::ElementCache()
+    : count(0), valid(false) {}
+
+//
+// Abre o cache de um arquivo de TLE; se não existir ou estiver desatualizado, recria-o
+//
+bool ElementCache::open(const char* tleFilePath, const std::vector<SatelliteData>& satellites) {
+    char cachePath[32];
+    cachePathFor(tleFilePath, cachePath, sizeof(cachePath));
+    close();
+
+    if (SPIFFS.exists(cachePath)) {
+        file = SPIFFS.open(cachePath, FILE_READ);
+        if (file && matches(satellites)) {
+            valid = true;
+            Serial.printf("[ElementCache] Cache %s válido (%u registros)\n", cachePath, (unsigned)count);
+            return true;
+        }
+        close();
+    }
+
+    if (!rebuild(cachePath, satellites)) {
+        Serial.printf("[ElementCache] Erro ao gravar %s\n", cachePath);
+        SPIFFS.remove(cachePath);
+        return false;
+    }
+
+    file = SPIFFS.open(cachePath, FILE_READ);
+    if (!file || !matches(satellites)) {
+        close();
+        return false;
+    }
+    valid = true;
+    Serial.printf("[ElementCache] Cache %s criado (%u registros)\n", cachePath, (unsigned)count);
+    return true;
+}
+
+void ElementCache::close() {
+    if (file) {
+        file.close();
+    }
+    count = 0;
+    valid = false;
+}
+
+//
+// Lê o registro de um satélite diretamente do arquivo de cache
+//
+bool ElementCache::load(int index, elsetrec& satrec) {
+    if (!valid || index < 0 || static_cast<uint32_t>(index) >= count) {
+        return false;
+    }
+
+    size_t pos = sizeof(Header) + static_cast<size_t>(index) * sizeof(Record)
+                 + offsetof(Record, satrec);
+    if (!file.seek(pos) ||
+        file.read(reinterpret_cast<uint8_t*>(&satrec), sizeof(elsetrec)) != sizeof(elsetrec)) {
+        return false;
+    }
+    return satrec.error == 0;
+}
+
+//
+// Recria o cache: um twoline2rv() por satélite, feito uma única vez por arquivo de TLE
+//
+bool ElementCache::rebuild(const char* cachePath, const std::vector<SatelliteData>& satellites) {
+    fs::File out = SPIFFS.open(cachePath, FILE_WRITE);
+    if (!out) {
+        return false;
+    }
+
+    Header header = { CACHE_MAGIC, CACHE_VERSION, sizeof(Record),
+                      static_cast<uint32_t>(satellites.size()) };
+    bool ok = out.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+
+    // twoline2rv() altera as linhas recebidas; trabalha sobre cópias
+    char line1[130];
+    char line2[130];
+    Record record;
+
+    for (size_t i = 0; ok && i < satellites.size(); i++) {
+        const SatelliteData& sat = satellites[i];
+        memset(&record, 0, sizeof(record));
+        record.norad = noradId(sat);
+        record.checksum = tleChecksum(sat);
+
+        strncpy(line1, sat.tle_line1, sizeof(line1) - 1);
+        line1[sizeof(line1) - 1] = '\0';
+        strncpy(line2, sat.tle_line2, sizeof(line2) - 1);
+        line2[sizeof(line2) - 1] = '\0';
+
+        if (strlen(line1) >= 69 && strlen(line2) >= 69) {
+            // Mesmo modo e constantes utilizados pela classe Sgp4
+            twoline2rv(line1, line2, 'i', wgs84, record.satrec);
+        } else {
+            record.satrec.error = 1;
+        }
+
+        ok = out.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record)) == sizeof(record);
+    }
+    out.close();
+    return ok;
+}
+
+//
+// Confere cabeçalho e chaves (NORAD + checksum) de todos os registros
+//
+bool ElementCache::matches(const std::vector<SatelliteData>& satellites) {
+    Header header;
+    if (!file.seek(0) ||
+        file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+        header.recordSize != sizeof(Record) || header.count != satellites.size()) {
+        return false;
+    }
+
+    uint32_t key[2];
+    for (size_t i = 0; i < satellites.size(); i++) {
+        if (!file.seek(sizeof(Header) + i * sizeof(Record)) ||
+            file.read(reinterpret_cast<uint8_t*>(key), sizeof(key)) != sizeof(key)) {
+            return false;
+        }
+        if (key[0] != noradId(satellites[i]) || key[1] != tleChecksum(satellites[i])) {
+            return false;
+        }
+    }
+    count = header.count;
+    return true;
+}
+
+uint32_t ElementCache::noradId(const SatelliteData& sat) {
+    char id[6];
+    strncpy(id, sat.tle_line1 + 2, 5);
+    id[5] = '\0';
+    return static_cast<uint32_t>(strtoul(id, nullptr, 10));
+}
+
+uint32_t ElementCache::tleChecksum(const SatelliteData& sat) {
+    uint32_t hash = 2166136261u;
+    for (const char* p = sat.tle_line1; *p; p++) {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+    for (const char* p = sat.tle_line2; *p; p++) {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+    return hash;
+}
+
+void ElementCache::cachePathFor(const char* tleFilePath, char* buffer, size_t bufferSize) {
+    strncpy(buffer, tleFilePath, bufferSize - 1);
+    buffer[bufferSize - 1] = '\0';
+
+    char* dot = strrchr(buffer, '.');
+    if (dot == nullptr || strchr(dot, '/') != nullptr) {
+        dot = buffer + strlen(buffer);
+    }
+    // Garante espaço para a nova extensão (nomes do SPIFFS são limitados a 31 caracteres)
+    if (static_cast<size_t>(dot - buffer) + 5 > bufferSize) {
+        dot = buffer + bufferSize - 5;
+    }
+    strcpy(dot, ".elc");
+}
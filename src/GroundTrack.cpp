@@ -0,0 +1,171 @@
+#include "GroundTrack.h"
+#include <math.h>
+
+static constexpr double JD_UNIX_EPOCH   = 2440587.5;
+static constexpr double SECONDS_PER_DAY = 86400.0;
+static constexpr double EARTH_RADIUS_KM = 6378.135;   // wgs72, o mesmo de ijk2ll()
+static constexpr double DEG             = M_PI / 180.0;
+
+//
+// Distância (graus) de p ao segmento a-b, no plano longitude/latitude do mapa
+//
+static double segmentDistance(const TrackPoint& p, const TrackPoint& a, const TrackPoint& b) {
+    double dx = b.lon - a.lon;
+    double dy = b.lat - a.lat;
+    double px = p.lon - a.lon;
+    double py = p.lat - a.lat;
+    double length2 = dx * dx + dy * dy;
+    if (length2 > 0.0) {
+        double t = (px * dx + py * dy) / length2;
+        if (t > 1.0) {
+            px -= dx;
+            py -= dy;
+        } else if (t > 0.0) {
+            px -= t * dx;
+            py -= t * dy;
+        }
+    }
+    return sqrt(px * px + py * py);
+}
+
+GroundTrack::GroundTrack() : step(10), tolerance(0.25), newSegment(true), stats() {}
+
+//
+// Amostra o ponto subsatélite e corta o traço na linha de data
+//
+int GroundTrack::generate(const Sgp4Model& model, unsigned long startUnix, double orbits) {
+    block.clear();
+    vertices.clear();
+    starts.clear();
+    newSegment = true;
+    stats = TrackStats();
+
+    const elsetrec& satrec = model.elements();
+    if (satrec.error != 0 || satrec.no <= 0.0 || orbits <= 0.0) {
+        return 0;
+    }
+
+    double period = 2.0 * M_PI / satrec.no * 60.0;   // s (no em rad/min)
+    long count = static_cast<long>(orbits * period / step) + 1;
+    double jdStart = JD_UNIX_EPOCH + startUnix / SECONDS_PER_DAY;
+
+    Sgp4Context ctx;
+    model.initcontext(ctx);
+    bool previous = false;
+    TrackPoint last = {0.0f, 0.0f};
+
+    for (long i = 0; i < count; i++) {
+        double jd = jdStart + i * static_cast<double>(step) / SECONDS_PER_DAY;
+        stats.samples++;
+        if (!model.state(ctx, jd)) {
+            stats.failed++;
+            endSegment();
+            previous = false;
+            continue;
+        }
+        ctx.satJd = jd;
+        model.subpoint(ctx);
+        TrackPoint point = {static_cast<float>(ctx.satLat), static_cast<float>(ctx.satLon)};
+
+        // Mais de 180° de um passo ao outro: cruzou a linha de data
+        if (previous && fabsf(point.lon - last.lon) > 180.0f) {
+            float edge = last.lon > 0.0f ? 180.0f : -180.0f;
+            float unwrapped = point.lon + 2.0f * edge;
+            float f = (edge - last.lon) / (unwrapped - last.lon);
+            float lat = last.lat + f * (point.lat - last.lat);
+            addSample(lat, edge);
+            endSegment();
+            addSample(lat, -edge);
+        }
+        addSample(point.lat, point.lon);
+        last = point;
+        previous = true;
+    }
+    endSegment();
+
+    stats.vertices = static_cast<int>(vertices.size());
+    stats.segments = static_cast<int>(starts.size());
+    return stats.vertices;
+}
+
+//
+// Raio da área de visibilidade: ângulo central até o ponto que vê o satélite na elevação mínima
+//
+double GroundTrack::footprintRadius(double altitudeKm, double minElevation) {
+    if (altitudeKm <= 0.0) {
+        return 0.0;
+    }
+    double elevation = minElevation * DEG;
+    double lambda = acos(EARTH_RADIUS_KM * cos(elevation) / (EARTH_RADIUS_KM + altitudeKm)) - elevation;
+    return lambda > 0.0 ? lambda / DEG : 0.0;
+}
+
+void GroundTrack::addSample(float lat, float lon) {
+    TrackPoint point = {lat, lon};
+    block.push_back(point);
+    if (static_cast<int>(block.size()) >= MAX_BLOCK) {
+        flushBlock(false);
+    }
+}
+
+void GroundTrack::endSegment() {
+    // Um ponto isolado (entre um erro e a linha de data, ou o último de um bloco já passado) não forma trecho
+    if (block.size() >= 2) {
+        flushBlock(true);
+    }
+    block.clear();
+    newSegment = true;
+}
+
+//
+// Douglas–Peucker iterativo sobre o bloco: mantém o ponto mais distante da corda
+// enquanto ele estiver a mais de tolerance, com uma pilha explícita de intervalos
+//
+void GroundTrack::flushBlock(bool last) {
+    size_t n = block.size();
+    keep.assign(n, 0);
+    keep[0] = 1;
+    keep[n - 1] = 1;
+
+    ranges.clear();
+    ranges.push_back(static_cast<uint32_t>(n - 1));
+    while (!ranges.empty()) {
+        uint32_t range = ranges.back();
+        ranges.pop_back();
+        size_t first = range >> 16;
+        size_t end = range & 0xFFFF;
+
+        double worst = tolerance;
+        size_t split = 0;
+        for (size_t i = first + 1; i < end; i++) {
+            double distance = segmentDistance(block[i], block[first], block[end]);
+            if (distance > worst) {
+                worst = distance;
+                split = i;
+            }
+        }
+        if (split != 0) {
+            keep[split] = 1;
+            ranges.push_back(static_cast<uint32_t>(first << 16 | split));
+            ranges.push_back(static_cast<uint32_t>(split << 16 | end));
+        }
+    }
+
+    // O primeiro ponto de um bloco de continuação já foi passado como último do anterior
+    bool continuation = !newSegment;
+    if (!continuation) {
+        starts.push_back(static_cast<uint32_t>(vertices.size()));
+    }
+    for (size_t i = continuation ? 1 : 0; i < n; i++) {
+        if (keep[i]) {
+            vertices.push_back(block[i]);
+        }
+    }
+    newSegment = last;
+
+    if (!last) {
+        TrackPoint tail = block[n - 1];
+        block.clear();
+        block.push_back(tail);
+    }
+}
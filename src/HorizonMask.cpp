@@ -0,0 +1,105 @@
+#include "HorizonMask.h"
+#include "Config.h"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static constexpr double EARTH_RADIUS_KM = 6371.0;
+
+// Distância aproximada entre dois locais próximos (km)
+static double siteDistanceKm(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * PI / 180.0;
+    double dLon = (lon2 - lon1) * PI / 180.0 * cos((lat1 + lat2) / 2.0 * PI / 180.0);
+    return EARTH_RADIUS_KM * sqrt(dLat * dLat + dLon * dLon);
+}
+
+HorizonMask::HorizonMask()
+    : valid(false), loaded(false), loadedLat(0.0), loadedLon(0.0), sum(0) {
+    horizoninit(mask, nullptr, nullptr, 0);
+}
+
+bool HorizonMask::update(double lat, double lon) {
+    if (loaded && siteDistanceKm(lat, lon, loadedLat, loadedLon) < RELOAD_KM) {
+        return valid;
+    }
+    loaded = true;
+    loadedLat = lat;
+    loadedLon = lon;
+    valid = load(lat, lon);
+    return valid;
+}
+
+//
+// Percorre as seções do arquivo e guarda os pontos da mais próxima que contém o local
+//
+bool HorizonMask::load(double lat, double lon) {
+    fs::File file = SPIFFS.open(HORIZON_MASK_FILE, FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<double> az, el;           // seção escolhida
+    std::vector<double> sectionAz, sectionEl;
+    double bestDistance = 1e9;
+    bool inSection = true;                // pontos antes de "site": qualquer local
+    double sectionDistance = 1e8;         // pior que qualquer seção com local
+
+    // Fecha a seção corrente, mantendo-a se for a mais próxima até agora
+    auto closeSection = [&]() {
+        if (inSection && !sectionAz.empty() && sectionDistance < bestDistance) {
+            bestDistance = sectionDistance;
+            az.swap(sectionAz);
+            el.swap(sectionEl);
+        }
+        sectionAz.clear();
+        sectionEl.clear();
+    };
+
+    while (file.available()) {
+        String line = file.readStringUntil('\n');
+        line.trim();
+        if (line.length() == 0 || line.startsWith("#")) {
+            continue;
+        }
+
+        double a, b, radius;
+        if (line.startsWith("site")) {
+            closeSection();
+            if (sscanf(line.c_str() + 4, "%lf %lf %lf", &a, &b, &radius) == 3) {
+                sectionDistance = siteDistanceKm(lat, lon, a, b);
+                inSection = sectionDistance <= radius;
+            } else {
+                Serial.printf("[HorizonMask] Linha inválida: %s\n", line.c_str());
+                inSection = false;
+            }
+        } else if (sscanf(line.c_str(), "%lf %lf", &a, &b) == 2) {
+            if (inSection && static_cast<int>(sectionAz.size()) < MAX_POINTS) {
+                sectionAz.push_back(a);
+                sectionEl.push_back(b);
+            }
+        } else {
+            Serial.printf("[HorizonMask] Linha inválida: %s\n", line.c_str());
+        }
+    }
+    closeSection();
+    file.close();
+
+    if (az.empty()) {
+        Serial.println("[HorizonMask] Nenhuma máscara para o local, horizonte plano");
+        horizoninit(mask, nullptr, nullptr, 0);
+        return false;
+    }
+
+    horizoninit(mask, az.data(), el.data(), static_cast<int>(az.size()));
+
+    // FNV-1a da tabela
+    sum = 2166136261u;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(mask.el);
+    for (size_t i = 0; i < sizeof(mask.el); i++) {
+        sum = (sum ^ bytes[i]) * 16777619u;
+    }
+
+    Serial.printf("[HorizonMask] %d pontos, elevação de %.1f° a %.1f°\n", (int)az.size(),
+                  mask.minel * 180.0 / PI, mask.maxel * 180.0 / PI);
+    return true;
+}
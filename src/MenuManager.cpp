@@ -70,10 +70,15 @@ static void drawMenuArea(const std::vector<MenuItem>& menu, size_t currentIndex)
     int16_t yMenu = MAIN_MENU_Y + (MAIN_MENU_HEADER_HEIGHT - menuHeight) / 2;
     tft.drawString(menu_header, xMenu, yMenu);
     
-    // Lista de itens do menu
+    // Lista de itens do menu (fonte menor quando os itens não cabem na área)
     tft.setTextFont(2);
     int posY = MAIN_MENU_Y + 25; // um pouco abaixo do cabeçalho
     int incY = 20;
+    int available = MAIN_MENU_Y + MAIN_MENU_HEIGHT - posY;
+    if (static_cast<int>(menu.size()) * incY > available) {
+        tft.setTextFont(1);
+        incY = available / static_cast<int>(menu.size());
+    }
     for (size_t i = 0; i < menu.size(); i++) {
         if (i == currentIndex) {
             tft.setTextColor(TFT_BLACK, TFT_WHITE);
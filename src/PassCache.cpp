@@ -0,0 +1,202 @@
+#include "PassCache.h"
+#include "ElementCache.h"
+#include "SatelliteTracker.h"
+#include <math.h>
+
+static constexpr double EARTH_RADIUS_KM = 6371.0;
+
+// Distância aproximada (km) entre dois observadores próximos
+static double siteDistanceKm(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * PI / 180.0;
+    double dLon = remainder(lon2 - lon1, 360.0) * PI / 180.0 * cos((lat1 + lat2) / 2.0 * PI / 180.0);
+    return EARTH_RADIUS_KM * sqrt(dLat * dLat + dLon * dLon);
+}
+
+PassCache::PassCache()
+    : useCounter(0) {
+    strcpy(path, "/passes.pc");
+}
+
+//
+// Lê todas as entradas do arquivo para a RAM
+//
+bool PassCache::begin(const char* filePath) {
+    strncpy(path, filePath, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    entries.clear();
+    useCounter = 0;
+
+    fs::File file = SPIFFS.open(path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    Header header;
+    bool ok = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              header.magic == CACHE_MAGIC && header.version == CACHE_VERSION &&
+              header.entrySize == sizeof(Entry) && header.count <= MAX_ENTRIES;
+    if (ok) {
+        entries.resize(header.count);
+        size_t bytes = header.count * sizeof(Entry);
+        ok = file.read(reinterpret_cast<uint8_t*>(entries.data()), bytes) == bytes;
+    }
+    file.close();
+
+    if (!ok) {
+        Serial.printf("[PassCache] %s inválido, cache vazio\n", path);
+        entries.clear();
+        return false;
+    }
+    for (const Entry& e : entries) {
+        if (e.lastUse > useCounter) {
+            useCounter = e.lastUse;
+        }
+    }
+    Serial.printf("[PassCache] %s: %d satélites\n", path, (int)entries.size());
+    return true;
+}
+
+PassKey PassCache::makeKey(const SatelliteData& sat, double lat, double lon, double alt, double minElevation,
+                           uint32_t horizon) {
+    PassKey key;
+    key.norad        = ElementCache::noradId(sat);
+    key.checksum     = ElementCache::tleChecksum(sat);
+    key.lat          = static_cast<float>(lat);
+    key.lon          = static_cast<float>(lon);
+    key.alt          = static_cast<float>(alt);
+    key.minElevation = static_cast<int16_t>(lround(minElevation * 10.0));
+    key.horizon      = horizon;
+    return key;
+}
+
+//
+// Passagens guardadas na janela e o instante a partir do qual falta pesquisar
+//
+unsigned long PassCache::lookup(const PassKey& key, unsigned long startUnix, unsigned long endUnix,
+                                std::vector<PassData>& passes) {
+    passes.clear();
+    Entry* e = find(key.norad);
+    if (e == nullptr) {
+        return startUnix;
+    }
+
+    // TLE, observador, horizonte ou elevação mínima mudaram (ou o relógio voltou): só esta entrada é descartada
+    if (!sameKey(e->key, key) || startUnix < e->coveredFrom) {
+        Serial.printf("[PassCache] Entrada %u descartada\n", (unsigned)key.norad);
+        e->count = 0;
+        e->coveredFrom = e->coveredUntil = 0;
+        e->key = key;
+        return startUnix;
+    }
+    e->lastUse = ++useCounter;
+
+    // Remove as passagens encerradas
+    int first = 0;
+    while (first < e->count && e->passes[first].los < startUnix) {
+        first++;
+    }
+    if (first > 0) {
+        memmove(e->passes, e->passes + first, (e->count - first) * sizeof(Window));
+        e->count -= first;
+        e->coveredFrom = startUnix;
+    }
+
+    for (int i = 0; i < e->count && e->passes[i].aos <= endUnix; i++) {
+        PassData pass;
+        pass.startPassUnix = e->passes[i].aos;
+        pass.endPassUnix   = e->passes[i].los;
+        passes.push_back(std::move(pass));
+    }
+
+    if (e->coveredUntil >= endUnix) {
+        return endUnix + 1;
+    }
+    return e->coveredUntil > startUnix ? e->coveredUntil : startUnix;
+}
+
+//
+// Estende a entrada com as passagens de um intervalo recém-pesquisado
+//
+void PassCache::store(const PassKey& key, unsigned long fromUnix, unsigned long untilUnix,
+                      const std::vector<PassData>& passes) {
+    Entry* e = find(key.norad);
+    if (e == nullptr) {
+        if (static_cast<int>(entries.size()) < MAX_ENTRIES) {
+            entries.push_back(Entry());
+            e = &entries.back();
+        } else {
+            // Substitui o satélite usado há mais tempo
+            e = &entries[0];
+            for (Entry& candidate : entries) {
+                if (candidate.lastUse < e->lastUse) {
+                    e = &candidate;
+                }
+            }
+        }
+        memset(e, 0, sizeof(Entry));
+        e->key = key;
+    }
+    if (!sameKey(e->key, key) || e->coveredUntil < fromUnix) {
+        // Intervalo não contínuo com o guardado: recomeça a entrada
+        e->key = key;
+        e->count = 0;
+    }
+    if (e->count == 0) {
+        e->coveredFrom = fromUnix;
+    }
+    e->lastUse = ++useCounter;
+    e->coveredUntil = untilUnix;
+
+    for (const PassData& pass : passes) {
+        // A busca estendida pode reencontrar a última passagem guardada
+        if (e->count > 0 && pass.startPassUnix <= e->passes[e->count - 1].los) {
+            continue;
+        }
+        if (e->count >= MAX_PASSES) {
+            // Sem espaço: o intervalo coberto termina na última passagem guardada
+            e->coveredUntil = e->passes[e->count - 1].los;
+            break;
+        }
+        e->passes[e->count].aos = pass.startPassUnix;
+        e->passes[e->count].los = pass.endPassUnix;
+        e->count++;
+    }
+
+    if (!save()) {
+        Serial.printf("[PassCache] Erro ao gravar %s\n", path);
+    }
+}
+
+void PassCache::clear() {
+    entries.clear();
+    useCounter = 0;
+    SPIFFS.remove(path);
+}
+
+PassCache::Entry* PassCache::find(uint32_t norad) {
+    for (Entry& e : entries) {
+        if (e.key.norad == norad) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+bool PassCache::save() {
+    fs::File file = SPIFFS.open(path, FILE_WRITE);
+    if (!file) {
+        return false;
+    }
+    Header header = { CACHE_MAGIC, CACHE_VERSION, sizeof(Entry), static_cast<uint32_t>(entries.size()) };
+    size_t bytes = entries.size() * sizeof(Entry);
+    bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              file.write(reinterpret_cast<const uint8_t*>(entries.data()), bytes) == bytes;
+    file.close();
+    return ok;
+}
+
+bool PassCache::sameKey(const PassKey& a, const PassKey& b) {
+    return a.norad == b.norad && a.checksum == b.checksum && a.minElevation == b.minElevation &&
+           a.horizon == b.horizon && siteDistanceKm(a.lat, a.lon, b.lat, b.lon) < SITE_MOVE_KM &&
+           fabs(a.alt - b.alt) < ALT_MOVE_M;
+}
@@ -0,0 +1,506 @@
+#include "PassPredictor.h"
+#include <chrono>
+#include <memory>
+
+static constexpr double JD_UNIX_EPOCH   = 2440587.5;
+static constexpr double SECONDS_PER_DAY = 86400.0;
+
+static constexpr double SPEED_OF_LIGHT_KMS      = 299792.458;
+static constexpr int SAMPLE_BLOCK               = 32;     // pontos por chamada a timeline() em samplePath()
+
+// Varredura da rede
+static constexpr unsigned long NETWORK_MAX_STEP = 600;    // maior passo abaixo do horizonte (s)
+static constexpr unsigned long NETWORK_MAX_PASS = 7200;   // fecha passagens ainda abertas após o fim da janela
+static constexpr double EARTH_MU_KM3S2          = 398600.4418;
+static constexpr double EARTH_RADIUS_KM         = 6378.137;
+static constexpr double SITE_SPEED_KMS          = 0.47;   // rotação da Terra no equador
+
+//
+// Limite da taxa de elevação (graus/s) abaixo do horizonte: velocidade no perigeu somada à da
+// estação, dividida pela menor distância em que o satélite ainda está no horizonte. Abaixo do
+// horizonte a distância só aumenta, então a elevação não sobe mais rápido que isso.
+//
+double PassPredictor::maxElevationRate(const elsetrec& satrec) {
+    double period = 2.0 * pi / satrec.no * 60.0;   // no em rad/min
+    double a  = cbrt(EARTH_MU_KM3S2 * period * period / (4.0 * pi * pi));
+    double rp = a * (1.0 - satrec.ecco);
+    double vp = sqrt(EARTH_MU_KM3S2 * (1.0 + satrec.ecco) / rp);
+    double rho = rp * rp - EARTH_RADIUS_KM * EARTH_RADIUS_KM;
+    if (rho <= 0.0) {
+        return 0.0;   // perigeu abaixo da superfície: sem salto de passo
+    }
+    return (vp + SITE_SPEED_KMS) / sqrt(rho) * 180.0 / pi;
+}
+
+static unsigned long julianToUnix(double jd) {
+    return static_cast<unsigned long>((jd - JD_UNIX_EPOCH) * SECONDS_PER_DAY);
+}
+
+PassPredictor::PassPredictor()
+    : minElevation(10.0), pathStep(10), iterations(500), downlinkHz(0.0), stats() {}
+
+//
+// Todas as passagens da janela, com a geração incremental sem orçamento de tempo
+//
+int PassPredictor::generate(Sgp4& sat, unsigned long startUnix, unsigned long duration, std::vector<PassData>& passes) {
+    passes.clear();
+
+    PassGenerator generator;
+    if (!generator.begin(*this, sat, startUnix, duration)) {
+        return -1;
+    }
+    PassData passData;
+    while (generator.next(passData)) {
+        passes.push_back(std::move(passData));
+    }
+    return stats.passes;
+}
+
+//
+// Amostra a trajetória entre AOS e LOS na grade de pathStep, em blocos de SAMPLE_BLOCK
+// pontos na pilha; PassPath guarda só os pontos em que a direção muda
+//
+void PassPredictor::samplePath(Sgp4& sat, PassData& pass) {
+    int numPoints = static_cast<int>((pass.endPassUnix - pass.startPassUnix) / pathStep) + 1;
+    pass.path.begin(pass.startPassUnix, pathStep, downlinkHz, numPoints);
+
+    double az[SAMPLE_BLOCK];
+    double el[SAMPLE_BLOCK];
+    double rangeRate[SAMPLE_BLOCK];
+    visibletype light[SAMPLE_BLOCK];
+    for (int first = 0; first < numPoints; first += SAMPLE_BLOCK) {
+        int count = numPoints - first < SAMPLE_BLOCK ? numPoints - first : SAMPLE_BLOCK;
+        unsigned long t0 = pass.startPassUnix + pathStep * first;
+        // Iluminação na mesma varredura: o Sol vem do cache do Sgp4, sem propagação extra
+        sat.timeline(t0, pathStep, count, az, el, nullptr, downlinkHz > 0.0 ? rangeRate : nullptr, light);
+        for (int i = 0; i < count; i++) {
+            pass.path.add(t0 + pathStep * i, az[i], el[i], downlinkHz > 0.0 ? rangeRate[i] : 0.0, light[i]);
+        }
+    }
+    pass.path.finish();
+    stats.pathPoints += numPoints;
+    stats.pathStored += static_cast<long>(pass.path.size());
+    if (pass.path.visible()) {
+        stats.visible++;
+    }
+}
+
+//
+// Passagens de todas as estações a partir de uma única propagação por instante
+//
+int PassPredictor::generate(const Sgp4Model& model, const Sgp4Sites& sites, unsigned long startUnix,
+                            unsigned long duration, std::vector<std::vector<PassData>>& passes) {
+    stats = PassStats();
+    int numSites = sites.size();
+    passes.assign(numSites, std::vector<PassData>());
+    if (numSites == 0) {
+        return 0;
+    }
+
+    // Estado de cada estação durante a varredura
+    struct SiteScan {
+        bool pruned;         ///< Descartada pelo pré-filtro geométrico
+        bool open;           ///< Passagem em andamento
+        double maxEl;        ///< Elevação máxima da passagem (graus)
+        double prevEl;       ///< Elevação na amostra anterior (graus)
+        PassData pass;
+    };
+    unsigned long endUnixTime = startUnix + duration;
+    double jdStart = JD_UNIX_EPOCH + startUnix / SECONDS_PER_DAY;
+    double jdEnd   = JD_UNIX_EPOCH + (endUnixTime + NETWORK_MAX_PASS) / SECONDS_PER_DAY;
+
+    // Estações que o satélite não alcança ficam fora da varredura (e do cálculo do salto)
+    std::vector<SiteScan> scan(numSites);
+    for (int k = 0; k < numSites; k++) {
+        SiteScan& s = scan[k];
+        s.pruned = model.passfilter(sites.frame(k), jdStart, jdEnd, minElevation) == passnever;
+        s.open = false;
+        s.maxEl = -90.0;
+        s.prevEl = -90.0;
+        stats.pruned += s.pruned ? 1 : 0;
+    }
+    if (stats.pruned == numSites) {
+        return 0;
+    }
+
+    std::unique_ptr<double[][3]> razel(new double[numSites][3]);
+    std::unique_ptr<double[][3]> rates(new double[numSites][3]);
+    bool doppler = downlinkHz > 0.0;
+    double maxRate = maxElevationRate(model.elements());
+
+    Sgp4Context ctx;
+    model.initcontext(ctx);
+
+    unsigned long t = startUnix;
+    unsigned long prevT = startUnix;
+    int openPasses = 0;
+
+    while (t <= endUnixTime || (openPasses > 0 && t <= endUnixTime + NETWORK_MAX_PASS)) {
+        double jd = JD_UNIX_EPOCH + t / SECONDS_PER_DAY;
+        bool ok = model.state(ctx, jd);
+        stats.evaluations++;
+        if (ok) {
+            sites.look(ctx.ro, ctx.vo, jd, razel.get(), doppler ? rates.get() : nullptr);
+        }
+
+        double deficit = 90.0;   // menor distância angular de uma estação até o horizonte (graus)
+        for (int k = 0; k < numSites; k++) {
+            SiteScan& s = scan[k];
+            if (s.pruned) {
+                continue;
+            }
+            double el = ok ? razel[k][2] * 180.0 / pi : -90.0;
+            if (-el < deficit) {
+                deficit = -el;
+            }
+
+            if (el >= 0.0) {
+                if (!s.open) {
+                    if (t > endUnixTime) {
+                        s.prevEl = el;
+                        continue;   // só fecha as passagens que começaram na janela
+                    }
+                    s.open = true;
+                    s.maxEl = el;
+                    s.pass = PassData();
+                    s.pass.startPassUnix = t;
+                    s.pass.path.begin(t, pathStep, downlinkHz);
+                    if (t > startUnix && s.prevEl < 0.0) {
+                        // AOS: cruzamento de 0° entre a amostra anterior e a atual
+                        s.pass.startPassUnix = prevT + static_cast<unsigned long>(
+                            (t - prevT) * (-s.prevEl) / (el - s.prevEl) + 0.5);
+                    }
+                    openPasses++;
+                }
+                s.pass.path.add(t, floatmod(razel[k][1] * 180.0 / pi + 360.0, 360.0), el,
+                                doppler ? rates[k][0] : 0.0);
+                stats.pathPoints++;
+                if (el > s.maxEl) {
+                    s.maxEl = el;
+                }
+            } else if (s.open) {
+                // LOS: cruzamento de 0° entre a amostra anterior e a atual
+                s.pass.endPassUnix = prevT + static_cast<unsigned long>(
+                    (t - prevT) * s.prevEl / (s.prevEl - el) + 0.5);
+                if (s.maxEl >= minElevation) {
+                    s.pass.path.finish();
+                    stats.pathStored += static_cast<long>(s.pass.path.size());
+                    passes[k].push_back(std::move(s.pass));
+                }
+                s.open = false;
+                openPasses--;
+            }
+            s.prevEl = el;
+        }
+
+        // Abaixo do horizonte de todas as estações, salta o tempo que a elevação levaria
+        // para chegar a 0° na taxa máxima; acima, amostra a trajetória a cada pathStep
+        unsigned long step = pathStep;
+        if (deficit > 0.0 && maxRate > 0.0) {
+            double jump = deficit / maxRate;
+            if (jump > NETWORK_MAX_STEP) {
+                jump = NETWORK_MAX_STEP;
+            }
+            if (jump > step) {
+                step = static_cast<unsigned long>(jump);
+            }
+        }
+        prevT = t;
+        t += step;
+    }
+
+    // Passagens que não terminaram (órbitas altas): fim na última amostra
+    for (int k = 0; k < numSites; k++) {
+        SiteScan& s = scan[k];
+        if (s.open) {
+            s.pass.endPassUnix = prevT;
+            if (s.maxEl >= minElevation) {
+                s.pass.path.finish();
+                stats.pathStored += static_cast<long>(s.pass.path.size());
+                passes[k].push_back(std::move(s.pass));
+            }
+        }
+        stats.passes += static_cast<int>(passes[k].size());
+    }
+    return stats.passes;
+}
+
+//
+// Doppler do ponto interpolado da trajetória (zero fora da passagem)
+//
+double PassPredictor::dopplerAt(const PassData& pass, unsigned long unixTime) {
+    const PassPath& path = pass.path;
+    if (path.empty() || unixTime < path.front().timestamp || unixTime > path.back().timestamp) {
+        return 0.0;
+    }
+    return path.at(unixTime).doppler;
+}
+
+PassPath::PassPath()
+    : pending(), hasPending(false), startUnix(0), step(1), downlinkHz(0.0f) {}
+
+void PassPath::begin(unsigned long start, unsigned long stepSeconds, double frequencyHz, size_t capacity) {
+    points.clear();
+    lights.clear();
+    if (capacity > 0) {
+        points.reserve(capacity);
+    }
+    hasPending = false;
+    startUnix  = start;
+    step       = static_cast<uint16_t>(stepSeconds == 0 ? 1 : (stepSeconds > 65535 ? 65535 : stepSeconds));
+    downlinkHz = static_cast<float>(frequencyHz);
+}
+
+//
+// Guarda o ponto se a direção (ou a taxa da distância) mudou desde o último guardado; senão
+// ele fica pendente, para fechar a trajetória em finish()
+//
+void PassPath::add(unsigned long unixTime, double azimuth, double elevation, double rangeRate) {
+    Point p = encode(unixTime, azimuth, elevation, rangeRate);
+    if (points.empty() || changed(p)) {
+        points.push_back(p);
+        hasPending = false;
+    } else {
+        pending = p;
+        hasPending = true;
+    }
+}
+
+void PassPath::add(unsigned long unixTime, double azimuth, double elevation, double rangeRate, visibletype light) {
+    add(unixTime, azimuth, elevation, rangeRate);
+    if (lights.empty() || lights.back().light != light) {
+        Light change;
+        change.tick  = tickOf(unixTime);
+        change.light = static_cast<uint8_t>(light);
+        lights.push_back(change);
+    }
+}
+
+void PassPath::finish() {
+    if (hasPending) {
+        points.push_back(pending);
+        hasPending = false;
+    }
+    if (points.capacity() > points.size()) {
+        points.shrink_to_fit();
+    }
+    if (lights.capacity() > lights.size()) {
+        lights.shrink_to_fit();
+    }
+}
+
+void PassPath::clear() {
+    std::vector<Point>().swap(points);
+    std::vector<Light>().swap(lights);
+    hasPending = false;
+}
+
+SatPosition PassPath::operator[](size_t i) const {
+    const Point& p = points[i];
+    SatPosition position;
+    position.timestamp = startUnix + static_cast<unsigned long>(p.tick) * step;
+    position.azimuth   = p.azimuth / 100.0;
+    position.elevation = p.elevation / 100.0;
+    // Aproximando (taxa negativa) => frequência recebida maior
+    position.doppler   = static_cast<float>(-downlinkHz * (p.rangeRate / 2000.0) / SPEED_OF_LIGHT_KMS);
+    return position;
+}
+
+//
+// Interpola entre os dois pontos guardados que cercam o instante
+//
+SatPosition PassPath::at(unsigned long unixTime) const {
+    if (points.empty()) {
+        SatPosition none = {unixTime, 0.0, 0.0, 0.0f};
+        return none;
+    }
+    double tick = unixTime > startUnix ? static_cast<double>(unixTime - startUnix) / step : 0.0;
+
+    // Primeiro ponto depois do instante
+    size_t lo = 0;
+    size_t hi = points.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (points[mid].tick <= tick) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return (*this)[0];
+    }
+    if (lo == points.size()) {
+        return (*this)[lo - 1];
+    }
+
+    SatPosition a = (*this)[lo - 1];
+    SatPosition b = (*this)[lo];
+    double frac = (tick - points[lo - 1].tick) / (points[lo].tick - points[lo - 1].tick);
+    double dAz = b.azimuth - a.azimuth;
+    if (dAz > 180.0) {
+        dAz -= 360.0;
+    } else if (dAz < -180.0) {
+        dAz += 360.0;
+    }
+
+    SatPosition position;
+    position.timestamp = unixTime;
+    position.azimuth   = floatmod(a.azimuth + frac * dAz + 360.0, 360.0);
+    position.elevation = a.elevation + frac * (b.elevation - a.elevation);
+    position.doppler   = static_cast<float>(a.doppler + frac * (b.doppler - a.doppler));
+    return position;
+}
+
+//
+// Última mudança de iluminação até o instante
+//
+visibletype PassPath::light(unsigned long unixTime) const {
+    double tick = unixTime > startUnix ? static_cast<double>(unixTime - startUnix) / step : 0.0;
+    visibletype current = sgp4daylight;
+    for (const Light& change : lights) {
+        if (change.tick > tick) {
+            break;
+        }
+        current = static_cast<visibletype>(change.light);
+    }
+    return current;
+}
+
+bool PassPath::visible() const {
+    for (const Light& change : lights) {
+        if (change.light == lighted) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t PassPath::tickOf(unsigned long unixTime) const {
+    unsigned long ticks = unixTime > startUnix ? (unixTime - startUnix + step / 2) / step : 0;
+    return static_cast<uint16_t>(ticks > 65535 ? 65535 : ticks);
+}
+
+PassPath::Point PassPath::encode(unsigned long unixTime, double azimuth, double elevation, double rangeRate) const {
+    Point p;
+    p.tick = tickOf(unixTime);
+    long az = lround(azimuth * 100.0) % 36000;
+    p.azimuth = static_cast<uint16_t>(az < 0 ? az + 36000 : az);
+    p.elevation = static_cast<int16_t>(lround(fmax(-90.0, fmin(90.0, elevation)) * 100.0));
+    p.rangeRate = static_cast<int16_t>(lround(fmax(-16.0, fmin(16.0, rangeRate)) * 2000.0));
+    return p;
+}
+
+//
+// Distância angular aproximada até o último ponto guardado (azimute escalado por cos(el))
+//
+bool PassPath::changed(const Point& p) const {
+    const Point& last = points.back();
+    double dEl = (p.elevation - last.elevation) / 100.0;
+    int dAzCenti = static_cast<int>(p.azimuth) - static_cast<int>(last.azimuth);
+    if (dAzCenti > 18000) {
+        dAzCenti -= 36000;
+    } else if (dAzCenti < -18000) {
+        dAzCenti += 36000;
+    }
+    double dAz = dAzCenti / 100.0 * cos((p.elevation + last.elevation) / 200.0 * pi / 180.0);
+    if (dEl * dEl + dAz * dAz >= MIN_ANGLE_DEG * MIN_ANGLE_DEG) {
+        return true;
+    }
+    return fabs((p.rangeRate - last.rangeRate) / 2000.0) >= MIN_RATE_KMS;
+}
+
+PassGenerator::PassGenerator()
+    : predictor(nullptr), sat(nullptr), startUnix(0), endUnix(0), failures(0), startEvaluations(0), elapsedUs(0), done(true) {}
+
+static long microsNow() {
+    using namespace std::chrono;
+    return static_cast<long>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+bool PassGenerator::begin(PassPredictor& owner, Sgp4& satellite, unsigned long windowStart, unsigned long duration) {
+    predictor = &owner;
+    sat = &satellite;
+    startUnix = windowStart;
+    endUnix = windowStart + duration;
+    failures = 0;
+    elapsedUs = 0;
+    done = true;
+    predictor->stats = PassStats();
+    predictor->stats.firstPassUs = -1;
+
+    long t0 = microsNow();
+
+    // Pré-filtro geométrico: sem busca de Brent para um satélite que não sobe na janela
+    if (sat->passfilter(JD_UNIX_EPOCH + startUnix / SECONDS_PER_DAY, JD_UNIX_EPOCH + endUnix / SECONDS_PER_DAY,
+                        predictor->minElevation) == passnever) {
+        predictor->stats.pruned = 1;
+        return true;
+    }
+
+    // Inicializa o ponto de predição
+    if (!sat->initpredpoint(startUnix, 0.0)) {
+        return false;
+    }
+    startEvaluations = sat->evaluations;
+    elapsedUs = microsNow() - t0;
+    done = false;
+    return true;
+}
+
+//
+// Uma revolução de nextpass() por vez, até achar uma passagem ou esgotar o orçamento
+//
+bool PassGenerator::next(PassData& pass, unsigned long budgetUs) {
+    if (done) {
+        return false;
+    }
+    PassStats& stats = predictor->stats;
+    long t0 = microsNow();
+    double jdEnd = JD_UNIX_EPOCH + endUnix / SECONDS_PER_DAY;
+    passinfo overpass;
+    bool found = false;
+
+    while (!found) {
+        if (!sat->nextpass(&overpass, 1, false, predictor->minElevation)) {
+            // Sem passagem nesta revolução: termina além da janela ou após as iterações máximas
+            if (sat->getpredpoint() > jdEnd || ++failures >= predictor->iterations) {
+                done = true;
+                break;
+            }
+        } else {
+            failures = 0;
+            stats.dssteps += overpass.dssteps;
+            stats.edgeEvaluations += overpass.edgeevaluations;
+            unsigned long passStartUnix = julianToUnix(overpass.jdstart);
+            unsigned long passEndUnix   = julianToUnix(overpass.jdstop);
+            if (passStartUnix > endUnix) {
+                done = true;
+                break;
+            }
+            // Uma passagem já encerrada antes da janela (o ponto de predição caiu logo após ela) é ignorada
+            if (passEndUnix < passStartUnix) {
+                stats.rejected++;
+            } else if (passEndUnix >= startUnix) {
+                pass.startPassUnix = passStartUnix;
+                pass.endPassUnix   = passEndUnix;
+                predictor->samplePath(*sat, pass);
+                found = true;
+            }
+        }
+        if (!found && budgetUs > 0 && static_cast<unsigned long>(microsNow() - t0) >= budgetUs) {
+            break;
+        }
+    }
+
+    elapsedUs += microsNow() - t0;
+    stats.steps++;
+    stats.evaluations = sat->evaluations - startEvaluations;
+    if (found) {
+        stats.passes++;
+        if (stats.firstPassUs < 0) {
+            stats.firstPassUs = elapsedUs;
+        }
+    }
+    return found;
+}
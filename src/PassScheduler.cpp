@@ -0,0 +1,244 @@
+#include "PassScheduler.h"
+#include "PassPredictor.h"   // PassPredictor::maxElevationRate()
+#include <algorithm>
+
+static constexpr double JD_UNIX_EPOCH   = 2440587.5;
+static constexpr double SECONDS_PER_DAY = 86400.0;
+
+static constexpr unsigned long MIN_STEP     = 10;     // menor passo da varredura (s)
+static constexpr unsigned long MAX_STEP     = 600;    // maior passo da varredura (s)
+static constexpr unsigned long MAX_PASS     = 7200;   // fecha passagens ainda abertas após a janela (s)
+static constexpr double TCA_MARGIN_DEG      = 2.0;    // amostras abaixo do mínimo que ainda refinam o TCA
+static constexpr double GOLDEN_RATIO        = 0.6180339887498949;
+
+static unsigned long clampStep(double seconds) {
+    if (seconds < MIN_STEP) return MIN_STEP;
+    if (seconds > MAX_STEP) return MAX_STEP;
+    return static_cast<unsigned long>(seconds);
+}
+
+PassScheduler::PassScheduler()
+    : minElevation(10.0), horizon(nullptr), stats() {
+    suncacheclear(sun);
+}
+
+void PassScheduler::clear() {
+    passes.clear();
+    stats = ScheduleStats();
+}
+
+bool PassScheduler::look(unsigned long t, double& el, double& az) {
+    stats.evaluations++;
+    bool ok = model.propagate(ctx, JD_UNIX_EPOCH + t / SECONDS_PER_DAY);
+    el = ctx.razel[2] * 180.0 / pi;
+    if (horizon != nullptr) {
+        el -= horizonelevation(*horizon, ctx.razel[1]) * 180.0 / pi;
+    }
+    az = floatmod(ctx.razel[1] * 180.0 / pi + 360.0, 360.0);
+    return ok;
+}
+
+visibletype PassScheduler::light(unsigned long t) {
+    double rsun[3];
+    double sunEl;
+    sunlook(sun, model.observerframe(), JD_UNIX_EPOCH + t / SECONDS_PER_DAY, rsun, nullptr, &sunEl);
+    return illumination(ctx.ro, rsun, sunEl, SUN_DARK_ELEVATION * pi / 180.0);
+}
+
+//
+// Elevação da máscara acima do seu ponto mais baixo (graus); a elevação real sobe no máximo
+// PassPredictor::maxElevationRate(), então só esta parte da distância até a máscara é segura para o salto
+//
+double PassScheduler::horizonSlack(double az) const {
+    if (horizon == nullptr) {
+        return 0.0;
+    }
+    return (horizonelevation(*horizon, az * pi / 180.0) - horizon->minel) * 180.0 / pi;
+}
+
+unsigned long PassScheduler::crossing(unsigned long tAbove, unsigned long tBelow, double& az) {
+    double el, azMid;
+    while (tAbove + 1 < tBelow || tBelow + 1 < tAbove) {
+        unsigned long mid = tAbove / 2 + tBelow / 2 + (tAbove % 2 + tBelow % 2) / 2;
+        look(mid, el, azMid);
+        if (el >= 0.0) {
+            tAbove = mid;
+            az = azMid;
+        } else {
+            tBelow = mid;
+        }
+    }
+    return tAbove;
+}
+
+//
+// Varre a janela do satélite: saltos abaixo do horizonte, passos curtos acima dele
+//
+int PassScheduler::addSatellite(uint16_t index, const elsetrec& satrec, unsigned long startUnix,
+                                unsigned long duration) {
+    stats.satellites++;
+    model.init("", satrec);
+    model.polar(JD_UNIX_EPOCH + startUnix / SECONDS_PER_DAY);
+
+    // Pré-filtro geométrico: nenhuma propagação para quem não sobe acima da elevação mínima
+    // (sobre o ponto mais baixo da máscara; "sempre" precisa passar também do mais alto)
+    double jdStart = JD_UNIX_EPOCH + startUnix / SECONDS_PER_DAY;
+    double jdStop  = JD_UNIX_EPOCH + (startUnix + duration + MAX_PASS) / SECONDS_PER_DAY;
+    double lowest  = horizon != nullptr ? horizon->minel * 180.0 / pi : 0.0;
+    passclass filter = model.passfilter(jdStart, jdStop, minElevation + lowest);
+    if (filter == passnever) {
+        stats.pruned++;
+        return 0;
+    }
+    if (filter == passalways &&
+        (horizon == nullptr || model.passfilter(jdStart, jdStop, minElevation + horizon->maxel * 180.0 / pi) == passalways)) {
+        stats.always++;
+    }
+    model.initcontext(ctx);
+
+    double maxRate = PassPredictor::maxElevationRate(satrec);
+    double period = satrec.no > 0.0 ? 2.0 * pi / satrec.no * 60.0 : SECONDS_PER_DAY;
+    unsigned long aboveStep = clampStep(period / 100.0);
+    unsigned long endUnix = startUnix + duration;
+    int added = 0;
+
+    unsigned long t = startUnix;
+    double el, az;
+    if (!look(t, el, az)) {
+        stats.failed++;
+        return 0;
+    }
+
+    while (t <= endUnix) {
+        // Abaixo do horizonte: salta o tempo mínimo para a elevação chegar a 0°
+        while (el < 0.0 && t <= endUnix) {
+            unsigned long step = maxRate > 0.0 ? clampStep((-el - horizonSlack(az)) / maxRate) : MIN_STEP;
+            unsigned long prev = t;
+            t += step;
+            if (!look(t, el, az)) {
+                stats.failed++;
+                return added;
+            }
+            if (el >= 0.0) {
+                t = crossing(t, prev, az);
+                el = 0.0;
+            }
+        }
+        if (t > endUnix) {
+            break;
+        }
+
+        // Acima do horizonte: AOS (refinado, ou o início da janela) e busca do máximo
+        ScheduledPass pass;
+        pass.satellite  = index;
+        pass.aos        = t;
+        pass.aosAzimuth = static_cast<float>(az);
+        int sight = light(t);   // ordem de visibletype: daylight < eclipsed < lighted
+
+        unsigned long best = t;
+        double bestEl = el;
+        double bestAz = az;
+        unsigned long prev = t;
+        double prevAz = az;
+        while (el >= 0.0 && t <= endUnix + MAX_PASS) {
+            prev = t;
+            prevAz = az;
+            t += aboveStep;
+            if (!look(t, el, az)) {
+                stats.failed++;
+                return added;
+            }
+            if (el >= 0.0 && sight != lighted) {
+                int current = light(t);
+                sight = current > sight ? current : sight;
+            }
+            if (el > bestEl) {
+                bestEl = el;
+                bestAz = az;
+                best = t;
+            }
+        }
+
+        // LOS entre a última amostra acima e a primeira abaixo do horizonte
+        double losAz = az;
+        if (el < 0.0) {
+            losAz = prevAz;
+            t = crossing(prev, t, losAz);
+        }
+        pass.los        = t;
+        pass.losAzimuth = static_cast<float>(losAz);
+
+        // TCA por seção áurea em torno da melhor amostra
+        if (bestEl >= minElevation - TCA_MARGIN_DEG) {
+            double a = best > pass.aos + aboveStep ? best - aboveStep : pass.aos;
+            double b = best + aboveStep < pass.los ? best + aboveStep : pass.los;
+            double c = b - GOLDEN_RATIO * (b - a);
+            double d = a + GOLDEN_RATIO * (b - a);
+            double elC, elD, azTmp;
+            look(static_cast<unsigned long>(c), elC, azTmp);
+            look(static_cast<unsigned long>(d), elD, azTmp);
+            while (b - a > 1.0) {
+                if (elC > elD) {
+                    b = d; d = c; elD = elC;
+                    c = b - GOLDEN_RATIO * (b - a);
+                    look(static_cast<unsigned long>(c), elC, azTmp);
+                } else {
+                    a = c; c = d; elC = elD;
+                    d = a + GOLDEN_RATIO * (b - a);
+                    look(static_cast<unsigned long>(d), elD, azTmp);
+                }
+            }
+            unsigned long tca = static_cast<unsigned long>((a + b) / 2.0);
+            double tcaEl, tcaAz;
+            look(tca, tcaEl, tcaAz);
+            if (tcaEl < bestEl) {
+                tca = best;
+                tcaEl = bestEl;
+                tcaAz = bestAz;
+            }
+
+            if (tcaEl >= minElevation) {
+                pass.tca = tca;
+                pass.sight = static_cast<uint8_t>(sight);
+                if (sight == lighted) {
+                    stats.visible++;
+                }
+                // Máximo acima da máscara; a elevação guardada é a real
+                pass.maxElevation = static_cast<float>(tcaEl + horizonSlack(tcaAz) + lowest);
+                passes.push_back(pass);
+                stats.passes++;
+                added++;
+            }
+        }
+
+        // Continua a varredura a partir do LOS
+        if (!look(t, el, az)) {
+            stats.failed++;
+            return added;
+        }
+        if (el >= 0.0) {
+            el = -1e-6;   // LOS arredondado para o último segundo acima do horizonte
+        }
+    }
+    return added;
+}
+
+void PassScheduler::finish() {
+    std::sort(passes.begin(), passes.end(), [](const ScheduledPass& a, const ScheduledPass& b) {
+        return a.aos < b.aos || (a.aos == b.aos && a.satellite < b.satellite);
+    });
+}
+
+int PassScheduler::nextPasses(unsigned long unixTime, int maxCount, std::vector<ScheduledPass>& out,
+                              bool visibleOnly) const {
+    out.clear();
+    for (const ScheduledPass& pass : passes) {
+        if (static_cast<int>(out.size()) >= maxCount) {
+            break;
+        }
+        if (pass.los >= unixTime && (!visibleOnly || pass.sight == lighted)) {
+            out.push_back(pass);
+        }
+    }
+    return static_cast<int>(out.size());
+}
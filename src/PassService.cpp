@@ -0,0 +1,330 @@
+#include "PassService.h"
+
+static constexpr unsigned long SEND_WAIT_MS = 50;   // espera por espaço na fila entre verificações de cancelamento
+
+#ifdef ARDUINO
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+//
+// Tarefa FreeRTOS fixada em um núcleo, fila de resultados e semáforos
+//
+struct PassService::Channels {
+    SemaphoreHandle_t mutex;     // protege pending, hasPending e stopping
+    SemaphoreHandle_t wake;      // binário: pedido novo ou fim da tarefa
+    SemaphoreHandle_t stopped;   // dado pela tarefa ao sair de run()
+    QueueHandle_t results;       // PassResult por cópia
+    PassService* owner;
+
+    Channels()
+        : mutex(xSemaphoreCreateMutex()),
+          wake(xSemaphoreCreateBinary()),
+          stopped(xSemaphoreCreateBinary()),
+          results(xQueueCreate(QUEUE_LENGTH, sizeof(PassResult))),
+          owner(nullptr) {}
+
+    ~Channels() {
+        if (results) {
+            vQueueDelete(results);
+        }
+        if (stopped) {
+            vSemaphoreDelete(stopped);
+        }
+        if (wake) {
+            vSemaphoreDelete(wake);
+        }
+        if (mutex) {
+            vSemaphoreDelete(mutex);
+        }
+    }
+
+    bool start(PassService* service, int core, unsigned long stackBytes, unsigned priority) {
+        owner = service;
+        if (!mutex || !wake || !stopped || !results) {
+            return false;
+        }
+        return xTaskCreatePinnedToCore(entry, "PassService", stackBytes, this, priority, nullptr, core) == pdPASS;
+    }
+
+    static void entry(void* arg) {
+        Channels* self = static_cast<Channels*>(arg);
+        self->owner->run();
+        xSemaphoreGive(self->stopped);
+        vTaskDelete(nullptr);
+    }
+
+    void join() { xSemaphoreTake(stopped, portMAX_DELAY); }
+    void lock() { xSemaphoreTake(mutex, portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(mutex); }
+    void notify() { xSemaphoreGive(wake); }
+    void waitNotify() { xSemaphoreTake(wake, portMAX_DELAY); }
+
+    bool send(const PassResult& result, unsigned long timeoutMs) {
+        return xQueueSend(results, &result, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+    }
+
+    bool receive(PassResult& result, unsigned long timeoutMs) {
+        return xQueueReceive(results, &result, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+    }
+
+    // Cede o núcleo entre etapas: a tarefa idle do núcleo alimenta o watchdog
+    void pause() { vTaskDelay(1); }
+};
+
+#else
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+//
+// Substituto nativo: std::thread, mutex e fila com capacidade limitada
+//
+struct PassService::Channels {
+    std::thread thread;
+    std::mutex mutex;                    // protege pending, hasPending e stopping
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+    bool woken;                          // semáforo binário wake
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::deque<PassResult> results;
+
+    Channels() : woken(false) {}
+
+    bool start(PassService* service, int, unsigned long, unsigned) {
+        thread = std::thread([service]() { service->run(); });
+        return true;
+    }
+
+    void join() {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> guard(wakeMutex);
+            woken = true;
+        }
+        wakeCv.notify_one();
+    }
+
+    void waitNotify() {
+        std::unique_lock<std::mutex> guard(wakeMutex);
+        wakeCv.wait(guard, [this]() { return woken; });
+        woken = false;
+    }
+
+    bool send(const PassResult& result, unsigned long timeoutMs) {
+        std::unique_lock<std::mutex> guard(queueMutex);
+        if (!queueCv.wait_for(guard, std::chrono::milliseconds(timeoutMs),
+                              [this]() { return results.size() < static_cast<size_t>(QUEUE_LENGTH); })) {
+            return false;
+        }
+        results.push_back(result);
+        queueCv.notify_all();
+        return true;
+    }
+
+    bool receive(PassResult& result, unsigned long timeoutMs) {
+        std::unique_lock<std::mutex> guard(queueMutex);
+        if (!queueCv.wait_for(guard, std::chrono::milliseconds(timeoutMs), [this]() { return !results.empty(); })) {
+            return false;
+        }
+        result = results.front();
+        results.pop_front();
+        queueCv.notify_all();
+        return true;
+    }
+
+    void pause() { std::this_thread::yield(); }
+};
+
+#endif
+
+PassService::PassService()
+    : channels(nullptr), current(0), counter(0), active(0), stepBudgetUs(20000), hasPending(false),
+      stopping(false) {}
+
+PassService::~PassService() {
+    end();
+}
+
+bool PassService::begin(int core, unsigned long stackBytes, unsigned priority) {
+    if (channels != nullptr) {
+        return true;
+    }
+    hasPending = false;
+    stopping = false;
+    channels = new Channels();
+    if (!channels->start(this, core, stackBytes, priority)) {
+        delete channels;
+        channels = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void PassService::end() {
+    if (channels == nullptr) {
+        return;
+    }
+    current = 0;
+    active = 0;
+    channels->lock();
+    stopping = true;
+    hasPending = false;
+    channels->unlock();
+    channels->notify();
+    channels->join();
+    drain();
+    delete channels;
+    channels = nullptr;
+}
+
+//
+// Entrega o pedido à tarefa; o anterior para na próxima verificação entre etapas
+//
+uint32_t PassService::submit(const PassRequest& request) {
+    if (channels == nullptr) {
+        return 0;
+    }
+    channels->lock();
+    uint32_t id = ++counter;
+    if (id == 0) {
+        id = ++counter;   // 0 indica "nenhum pedido"
+    }
+    pending.id = id;
+    pending.request = request;
+    hasPending = true;
+    current = id;
+    channels->unlock();
+    active = id;
+    channels->notify();
+    return id;
+}
+
+void PassService::cancel() {
+    current = 0;
+    active = 0;
+    if (channels == nullptr) {
+        return;
+    }
+    channels->lock();
+    hasPending = false;
+    channels->unlock();
+    drain();
+}
+
+bool PassService::receive(PassResult& result, unsigned long timeoutMs) {
+    if (channels == nullptr) {
+        return false;
+    }
+    while (channels->receive(result, timeoutMs)) {
+        // Resultado de um pedido substituído ou cancelado
+        if (result.request == 0 || result.request != current.load()) {
+            delete result.pass;
+            continue;
+        }
+        if (result.type != PASS_RESULT_FOUND) {
+            active = 0;
+        }
+        return true;
+    }
+    return false;
+}
+
+void PassService::drain() {
+    PassResult result;
+    while (channels->receive(result, 0)) {
+        delete result.pass;
+    }
+}
+
+//
+// Laço da tarefa: espera um pedido, busca as passagens, repete até end()
+//
+void PassService::run() {
+    while (true) {
+        channels->waitNotify();
+        channels->lock();
+        bool stop = stopping;
+        bool start = hasPending;
+        if (start) {
+            work = pending;
+            hasPending = false;
+        }
+        channels->unlock();
+        if (stop) {
+            break;
+        }
+        if (start) {
+            process();
+        }
+    }
+}
+
+//
+// Busca incremental do pedido em work, uma etapa de stepBudgetUs por vez
+//
+void PassService::process() {
+    const uint32_t id = work.id;
+    const PassRequest& request = work.request;
+    PassResult result = { id, PASS_RESULT_FAILED, nullptr, PassStats() };
+
+    sat.setfloat(request.singlePrecision);
+    sat.init(request.name, request.satrec);
+    sat.site(request.lat, request.lon, request.alt);
+    sat.sethorizon(request.useHorizon ? &request.horizon : nullptr);
+    predictor.setMinElevation(request.minElevation);
+    predictor.setDownlinkFrequency(request.downlinkHz);
+
+    PassGenerator generator;
+    if (!generator.begin(predictor, sat, request.startUnix, request.duration)) {
+        push(result);
+        return;
+    }
+
+    PassData* pass = nullptr;
+    while (!generator.finished() && current.load() == id) {
+        if (pass == nullptr) {
+            pass = new PassData();
+        }
+        if (generator.next(*pass, stepBudgetUs)) {
+            result.type = PASS_RESULT_FOUND;
+            result.pass = pass;
+            if (!push(result)) {
+                break;   // cancelado: a passagem não foi entregue
+            }
+            pass = nullptr;
+        }
+        channels->pause();
+    }
+    delete pass;
+
+    if (generator.finished()) {
+        result.type = PASS_RESULT_DONE;
+        result.pass = nullptr;
+        result.stats = predictor.lastStats();
+        push(result);
+    }
+}
+
+bool PassService::push(const PassResult& result) {
+    while (current.load() == result.request) {
+        if (channels->send(result, SEND_WAIT_MS)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,12 +1,14 @@
 #include "SatelliteTracker.h"
 #include <TimeLib.h>
 #include <math.h>
+#include <memory>
 #include "Config.h"
 #include "gps.h"
 #include "OrientationManager.h"
 #include "NotificationManager.h"
 #include "MenuManager.h"
 #include "DisplayConstants.h"
+#include "ProgressBar.h"
 
 // Constantes para conversão de tempo
 static constexpr double JD_UNIX_EPOCH   = 2440587.5;
@@ -22,16 +24,38 @@ extern MenuManager menuManager;         // Gerenciador de menus
 // Construtor da classe SatelliteTracker
 //
 SatelliteTracker::SatelliteTracker()
-    : currentSatelliteIndex(-1),
+    : batchValid(false),
+      pendingFrom(0),
+      pendingUntil(0),
+      scheduleValid(false),
+      scheduleStart(0),
+      approachesValid(false),
+      approachesStart(0),
+      currentAz(0.0),
+      currentEl(-90.0),
+      currentSatelliteIndex(-1),
       currentUnixTime(0)
 {
     // Inicializa o pino do buzzer e garante que esteja desligado
     pinMode(BUZZER_PIN, OUTPUT);
     digitalWrite(BUZZER_PIN, LOW);
+
+    // Doppler das trajetórias na frequência padrão (Config.h)
+    passPredictor.setDownlinkFrequency(DOWNLINK_FREQUENCY_HZ);
+    passService.setStepBudget(PASS_STEP_BUDGET_US);
     
     // Outras inicializações podem ser adicionadas aqui
 }
 
+//
+// Cria a tarefa de previsão no núcleo livre (o loop() do Arduino roda no outro)
+//
+void SatelliteTracker::beginPassService() {
+    if (!passService.begin(PASS_SERVICE_CORE, PASS_SERVICE_STACK, PASS_SERVICE_PRIORITY)) {
+        Serial.println("[beginPassService] Erro ao criar a tarefa de previsão.");
+    }
+}
+
 //=============================================================================
 // Função para desenhar a área exclusiva de notificações
 //=============================================================================
@@ -68,11 +92,30 @@ void SatelliteTracker::drawPassPolar(int centerX, int centerY, int radius, const
     tft.drawString("W", centerX + radius + 5, centerY - 3);
     tft.drawString("E", centerX - radius - 10, centerY - 3);
 
-    // 4) Desenha a trajetória do satélite
+    // 4) Desenha o horizonte local, quando houver máscara para o observador
+    const horizonmask* mask = horizonMask.table();
+    if (mask != nullptr) {
+        int prevX = -1, prevY = -1;
+        for (int az = 0; az <= 360; az += 10) {
+            double el = mask->el[az % 360] * 180.0 / PI;
+            double r = (1.0 - (el > 0.0 ? el : 0.0) / 90.0) * radius;
+            double thetaRad = (90.0 - az) * PI / 180.0;
+            int xPos = centerX + static_cast<int>(r * cos(thetaRad));
+            int yPos = centerY - static_cast<int>(r * sin(thetaRad));
+            if (az > 0) {
+                tft.drawLine(prevX, prevY, xPos, yPos, TFT_DARKGREY);
+            }
+            prevX = xPos;
+            prevY = yPos;
+        }
+    }
+
+    // 5) Desenha a trajetória do satélite (em amarelo onde é visível a olho nu)
     int prevX = -1, prevY = -1;
     for (size_t j = 0; j < pass.path.size(); j++) {
-        double az = pass.path[j].azimuth;
-        double el = pass.path[j].elevation;
+        SatPosition point = pass.path[j];
+        double az = point.azimuth;
+        double el = point.elevation;
         // Mapeia a elevação para um raio proporcional
         double r = (1.0 - (el / 90.0)) * radius;
         // Converte a direção (azimute) em ângulo em radianos, ajustando para coordenadas polares
@@ -81,12 +124,14 @@ void SatelliteTracker::drawPassPolar(int centerX, int centerY, int radius, const
         int xPos = centerX + static_cast<int>(r * cos(thetaRad));
         int yPos = centerY - static_cast<int>(r * sin(thetaRad));
 
+        uint16_t color = pass.path.light(point.timestamp) == lighted ? TFT_YELLOW : TFT_WHITE;
+
         // Desenha um ponto na posição calculada
-        tft.drawPixel(xPos, yPos, TFT_WHITE);
+        tft.drawPixel(xPos, yPos, color);
 
         // Se houver um ponto anterior, liga-os com uma linha
         if (j > 0) {
-            tft.drawLine(prevX, prevY, xPos, yPos, TFT_WHITE);
+            tft.drawLine(prevX, prevY, xPos, yPos, color);
         }
         prevX = xPos;
         prevY = yPos;
@@ -122,6 +167,68 @@ void SatelliteTracker::drawCurrentSatMarker(int centerX, int centerY, int radius
     markerState.lastY = yPos;
 }
 
+//
+// Desenha o mapa equirretangular do traço no solo, com o satélite e a área de visibilidade
+//
+void SatelliteTracker::drawGroundTrackMap(const GroundTrack& track, double lat, double lon, double footprint) {
+    const int x0 = GROUND_MAP_X;
+    const int y0 = GROUND_MAP_Y;
+    const int w = GROUND_MAP_WIDTH;
+    const int h = GROUND_MAP_HEIGHT;
+    auto mapX = [&](double longitude) { return x0 + static_cast<int>((longitude + 180.0) / 360.0 * (w - 1)); };
+    auto mapY = [&](double latitude) { return y0 + static_cast<int>((90.0 - latitude) / 180.0 * (h - 1)); };
+
+    // 1) Fundo, borda e grade a cada 30°
+    tft.fillRect(x0, y0, w, h, TFT_BLACK);
+    for (int longitude = -150; longitude < 180; longitude += 30) {
+        tft.drawFastVLine(mapX(longitude), y0, h, longitude == 0 ? TFT_DARKGREY : TFT_NAVY);
+    }
+    for (int latitude = -60; latitude <= 60; latitude += 30) {
+        tft.drawFastHLine(x0, mapY(latitude), w, latitude == 0 ? TFT_DARKGREY : TFT_NAVY);
+    }
+    tft.drawRect(x0, y0, w, h, TFT_WHITE);
+
+    // 2) Observador
+    int siteX = mapX(getCurrentLongitude());
+    int siteY = mapY(getCurrentLatitude());
+    tft.drawFastHLine(siteX - 3, siteY, 7, TFT_GREEN);
+    tft.drawFastVLine(siteX, siteY - 3, 7, TFT_GREEN);
+
+    // 3) Traço: cada trecho é uma polilinha (os cortes na linha de data não são ligados)
+    const std::vector<TrackPoint>& points = track.points();
+    const std::vector<uint32_t>& starts = track.segments();
+    for (size_t s = 0; s < starts.size(); s++) {
+        size_t end = s + 1 < starts.size() ? starts[s + 1] : points.size();
+        for (size_t i = starts[s] + 1; i < end; i++) {
+            tft.drawLine(mapX(points[i - 1].lon), mapY(points[i - 1].lat),
+                         mapX(points[i].lon), mapY(points[i].lat), TFT_YELLOW);
+        }
+    }
+
+    // 4) Área de visibilidade: pontos a footprint graus de arco do satélite, a cada 10° de rumo
+    double latRad = lat * PI / 180.0;
+    double radius = footprint * PI / 180.0;
+    int prevX = -1, prevY = -1;
+    for (int bearing = 0; bearing <= 360; bearing += 10) {
+        double theta = bearing * PI / 180.0;
+        double edgeLat = asin(sin(latRad) * cos(radius) + cos(latRad) * sin(radius) * cos(theta));
+        double edgeLon = lon + atan2(sin(theta) * sin(radius) * cos(latRad),
+                                     cos(radius) - sin(latRad) * sin(edgeLat)) * 180.0 / PI;
+        edgeLon = fmod(edgeLon + 540.0, 360.0) - 180.0;
+        int xPos = mapX(edgeLon);
+        int yPos = mapY(edgeLat * 180.0 / PI);
+        // Não liga os pontos dos dois lados da linha de data
+        if (bearing > 0 && abs(xPos - prevX) < w / 2) {
+            tft.drawLine(prevX, prevY, xPos, yPos, TFT_CYAN);
+        }
+        prevX = xPos;
+        prevY = yPos;
+    }
+
+    // 5) Satélite
+    tft.fillCircle(mapX(lon), mapY(lat), 3, TFT_RED);
+}
+
 //
 // Retorna os dados de um satélite dado o índice
 //
@@ -143,22 +250,32 @@ void SatelliteTracker::initSatellite(int index) {
         return;
     }
     currentSatelliteIndex = index;
-    sat.init(satellites[index].name,
-             satellites[index].tle_line1,
-             satellites[index].tle_line2);
+    cancelPasses();   // a busca em andamento é do satélite anterior
+    ephemeris.clear();
+    sat.setfloat(SGP4_SINGLE_PRECISION);
+
+    elsetrec satrec;
+    if (elementCache.load(index, satrec)) {
+        sat.init(satellites[index].name, satrec);
+    } else {
+        sat.init(satellites[index].name,
+                 satellites[index].tle_line1,
+                 satellites[index].tle_line2);
+    }
+
+    // Mesmo conjunto de elementos no modelo reentrante, sem novo parse do TLE
+    model.setfloat(SGP4_SINGLE_PRECISION);
+    model.init(satellites[index].name, sat.satrec);
+    model.initcontext(liveContext);
 }
 
 //
-// Funções estáticas auxiliares para conversão entre Unix Time e Julian Date
+// Função estática auxiliar para conversão de Unix Time para Julian Date
 //
 static double unixToJulian(unsigned long unixTime) {
     return (static_cast<double>(unixTime) / SECONDS_PER_DAY) + JD_UNIX_EPOCH;
 }
 
-static unsigned long julianToUnix(double jd) {
-    return static_cast<unsigned long>((jd - JD_UNIX_EPOCH) * SECONDS_PER_DAY);
-}
-
 //
 // Converte o tempo atual do sistema (usando dados do GPS) para Unix Time
 //
@@ -183,11 +300,8 @@ void SatelliteTracker::updateAzElRealTime() {
 
     updateGPS(); // Atualiza os dados do GPS
 
-    // Atualiza os cálculos SGP4 com o tempo atual
-    sat.findsat(calculateUnixTime());
-
-    // Define a posição do observador com base nos dados atuais do GPS
-    sat.site(getCurrentLatitude(), getCurrentLongitude(), getCurrentAltitude());
+    // Atualiza a posição com o tempo atual (efemérides quando disponíveis)
+    updateSatellitePosition(calculateUnixTime());
 }
 
 //
@@ -199,57 +313,319 @@ void SatelliteTracker::updateAndGeneratePasses(double lat, double lon, double al
         Serial.println("Coordenadas inválidas.");
         return;
     }
+    if (currentSatelliteIndex < 0) {
+        Serial.println("Nenhum satélite selecionado.");
+        return;
+    }
     updateGPS();
     sat.site(lat, lon, alt);
-
-    passes.clear();
+    horizonMask.update(lat, lon);
+    sat.sethorizon(horizonMask.table());
 
     unsigned long startUnixTime = calculateUnixTime();
     unsigned long endUnixTime   = startUnixTime + duracao;
-    unsigned long localUnixTime = startUnixTime;
 
-    // Inicializa o ponto de predição
-    if (!sat.initpredpoint(localUnixTime, 0.0)) {
-        Serial.println("Erro initpredpoint.");
-        return;
+    // Passagens já previstas; pesquisa só o intervalo que falta
+    PassKey key = PassCache::makeKey(satellites[currentSatelliteIndex], lat, lon, alt,
+                                     passPredictor.getMinElevation(), horizonMask.checksum());
+    unsigned long missingFrom = passCache.lookup(key, startUnixTime, endUnixTime, passes);
+
+    // Trajetórias das passagens do cache: uma chamada a timeline() por passagem, sem busca
+    for (PassData& pass : passes) {
+        passPredictor.samplePath(sat, pass);
+    }
+
+    cancelPasses();
+    if (missingFrom <= endUnixTime) {
+        // Busca do intervalo que falta na tarefa de previsão, com cópias dos elementos e da máscara
+        PassRequest& request = serviceRequest;
+        // Nome truncado ao tamanho de Sgp4::satName, que recebe a cópia na tarefa
+        snprintf(request.name, sizeof(request.name), "%.*s", static_cast<int>(sizeof(request.name) - 1),
+                 satellites[currentSatelliteIndex].name);
+        request.satrec          = sat.satrec;
+        request.lat             = lat;
+        request.lon             = lon;
+        request.alt             = alt;
+        request.startUnix       = missingFrom;
+        request.duration        = endUnixTime - missingFrom;
+        request.minElevation    = passPredictor.getMinElevation();
+        request.downlinkHz      = passPredictor.getDownlinkFrequency();
+        request.singlePrecision = SGP4_SINGLE_PRECISION;
+        request.useHorizon      = horizonMask.table() != nullptr;
+        if (request.useHorizon) {
+            request.horizon = *horizonMask.table();
+        }
+        if (passService.submit(request) != 0) {
+            pendingKey   = key;
+            pendingFrom  = missingFrom;
+            pendingUntil = endUnixTime;
+            Serial.printf("[updateAndGeneratePasses] %d passagens do cache, busca desde %lu s\n",
+                          (int)passes.size(), missingFrom - startUnixTime);
+        } else {
+            // Sem a tarefa de previsão, busca o intervalo aqui mesmo (o loop fica ocupado até o fim)
+            Serial.println("[updateAndGeneratePasses] Tarefa de previsão não iniciada; busca síncrona.");
+            std::vector<PassData> found;
+            if (passPredictor.generate(sat, missingFrom, endUnixTime - missingFrom, found) < 0) {
+                Serial.println("[updateAndGeneratePasses] Erro initpredpoint.");
+            } else {
+                passCache.store(key, missingFrom, endUnixTime, found);
+            }
+            for (PassData& pass : found) {
+                // A busca pode reencontrar a última passagem vinda do cache
+                if (passes.empty() || pass.startPassUnix > passes.back().endPassUnix) {
+                    passes.push_back(std::move(pass));
+                }
+            }
+            Serial.printf("Total de passagens geradas: %d\n", (int)passes.size());
+        }
+    } else {
+        Serial.printf("[updateAndGeneratePasses] %d passagens do cache.\n", (int)passes.size());
+    }
+
+    // Efemérides para o mesmo período: consultas em tempo real sem rodar o SGP4
+    ephemeris.site(lat, lon, alt);
+    if (ephemeris.fit(sat.satrec, startUnixTime, duracao / 3600.0)) {
+        Serial.printf("[updateAndGeneratePasses] Efemérides: %d segmentos, %u bytes\n",
+                      ephemeris.size(), (unsigned)ephemeris.bytes());
     }
+}
+
+//
+// Lê os resultados da tarefa de previsão; no fim, grava o intervalo pesquisado no cache
+//
+bool SatelliteTracker::collectPasses() {
+    bool added = false;
+    PassResult result;
+    while (passService.poll(result)) {
+        if (result.type == PASS_RESULT_FAILED) {
+            Serial.println("[collectPasses] Erro initpredpoint.");
+            foundPasses.clear();
+            break;
+        }
+
+        if (result.type == PASS_RESULT_FOUND) {
+            PassData window;
+            window.startPassUnix = result.pass->startPassUnix;
+            window.endPassUnix   = result.pass->endPassUnix;
+            foundPasses.push_back(window);
+
+            // A busca pode reencontrar a última passagem vinda do cache
+            if (passes.empty() || result.pass->startPassUnix > passes.back().endPassUnix) {
+                passes.push_back(std::move(*result.pass));
+                added = true;
+            }
+            delete result.pass;
+            continue;
+        }
+
+        const PassStats& stats = result.stats;
+        if (stats.firstPassUs >= 0) {
+            Serial.printf("[collectPasses] Primeira passagem em %ld ms\n", stats.firstPassUs / 1000);
+        }
+        if (stats.pruned > 0) {
+            Serial.println("[collectPasses] Satélite não sobe acima da elevação mínima (pré-filtro geométrico).");
+        }
+        if (stats.rejected > 0) {
+            Serial.printf("[collectPasses] Passagens inválidas descartadas: %d\n", stats.rejected);
+        }
+        if (stats.dssteps > 0) {
+            Serial.printf("[collectPasses] Passos de integração deep space: %ld\n", stats.dssteps);
+        }
+        Serial.printf("[collectPasses] Propagações em nextpass(): %ld em %d etapas\n",
+                      stats.evaluations, stats.steps);
+        Serial.printf("Total de passagens geradas: %d\n", (int)passes.size());
+
+        passCache.store(pendingKey, pendingFrom, pendingUntil, foundPasses);
+        foundPasses.clear();
+        break;
+    }
+    return added;
+}
+
+void SatelliteTracker::cancelPasses() {
+    passService.cancel();
+    foundPasses.clear();
+}
 
-    passinfo overpass;
+//
+// Gera passagens do satélite selecionado para várias estações com propagação compartilhada
+//
+int SatelliteTracker::generateNetworkPasses(const Sgp4Sites& sites, unsigned long duracao,
+                                            std::vector<std::vector<PassData>>& sitePasses) {
+    unsigned long startUnixTime = calculateUnixTime();
+    int total = passPredictor.generate(model, sites, startUnixTime, duracao, sitePasses);
 
-    while (localUnixTime <= endUnixTime) {
-        // Procura a próxima passagem
-        if (sat.nextpass(&overpass, 500, false, 10.0)) {
-            PassData passData;
-            unsigned long passStartUnix = julianToUnix(overpass.jdstart);
-            unsigned long passEndUnix   = julianToUnix(overpass.jdstop);
+    const PassStats& stats = passPredictor.lastStats();
+    Serial.printf("[generateNetworkPasses] %d estações (%d fora de alcance), %d passagens, %ld propagações\n",
+                  sites.size(), stats.pruned, total, stats.evaluations);
+    return total;
+}
 
-            if (passEndUnix < passStartUnix) {
-                Serial.println("Dados de passagem inválidos.");
-                continue;
+//
+// Propaga todos os satélites carregados para um mesmo instante utilizando o propagador em lote
+//
+int SatelliteTracker::propagateAll(unsigned long unixTime, std::vector<SatPosition>& positions) {
+    const int count = static_cast<int>(satellites.size());
+    positions.resize(count);
+    if (count == 0) {
+        return 0;
+    }
+
+    // Reconstrói o lote somente quando o grupo de TLEs mudou
+    if (!batchValid) {
+        batch.clear();
+        batch.reserve(count);
+        elsetrec satrec;
+        for (int i = 0; i < count; i++) {
+            if (elementCache.load(i, satrec)) {
+                batch.add(satrec);
+            } else if (batch.add(satellites[i].tle_line1, satellites[i].tle_line2) < 0) {
+                batch.addinvalid();   // mantém o alinhamento dos índices; propaga sempre com erro
             }
+        }
+        batchValid = true;
+        Serial.printf("[propagateAll] Lote criado: %d satélites (%d deep space)\n", count, batch.deepcount());
+    }
 
-            passData.startPassUnix = passStartUnix;
-            passData.endPassUnix   = passEndUnix;
-
-            // Coleta pontos a cada 10 segundos durante a passagem
-            for (unsigned long t = passStartUnix; t <= passEndUnix; t += 10) {
-                sat.findsat(t);
-                SatPosition pos;
-                pos.timestamp = t;
-                pos.azimuth   = sat.satAz;
-                pos.elevation = sat.satEl;
-                passData.path.push_back(pos);
+    std::unique_ptr<double[][3]> rv(new double[count][3]);
+    std::unique_ptr<double[][3]> vv(new double[count][3]);
+    std::vector<int8_t> errors(count);
+
+    double jd = unixToJulian(unixTime);
+    int ok = batch.propagate(jd, rv.get(), vv.get(), errors.data());
+
+    // Dados do observador calculados uma vez para todos os satélites
+    ObserverFrame frame;
+    observerframe(getCurrentLatitude() * PI / 180.0, getCurrentLongitude() * PI / 180.0,
+                  getCurrentAltitude() / 1000.0, jd, frame);
+    double razel[3];
+
+    for (int i = 0; i < count; i++) {
+        positions[i].timestamp = unixTime;
+        positions[i].doppler   = 0.0f;
+        if (errors[i] != 0) {
+            positions[i].azimuth   = 0.0;
+            positions[i].elevation = -90.0;
+            continue;
+        }
+        rv2azel(rv[i], frame, jd, razel);
+        positions[i].azimuth   = fmod(razel[1] * 180.0 / PI + 360.0, 360.0);
+        positions[i].elevation = razel[2] * 180.0 / PI;
+    }
+    return ok;
+}
+
+//
+// Prevê as passagens de todo o grupo carregado em uma linha do tempo única
+//
+int SatelliteTracker::updateGroupSchedule(double lat, double lon, double alt) {
+    unsigned long startUnixTime = calculateUnixTime();
+    unsigned long t0 = millis();
+
+    scheduler.clear();
+    scheduler.setSite(lat, lon, alt);
+    horizonMask.update(lat, lon);
+    scheduler.setHorizon(horizonMask.table());
+    scheduler.setMinElevation(GROUP_PASS_MIN_ELEVATION);
+    scheduler.setFloat(SGP4_SINGLE_PRECISION);
+
+    const int count = static_cast<int>(satellites.size());
+    elsetrec satrec;
+    Sgp4Model parsed;
+
+    // Satélites em etapas: entre elas atualiza a barra, o GPS e as notificações, e BACK cancela
+    clearProgressBar(PROGRESS_BAR_X, PROGRESS_BAR_Y, PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT);
+    int lastProgress = -1;
+    int i = 0;
+    while (i < count) {
+        unsigned long stepStart = micros();
+        do {
+            if (elementCache.load(i, satrec)) {
+                scheduler.addSatellite(i, satrec, startUnixTime, GROUP_PASS_HORIZON_S);
+            } else if (parsed.init(satellites[i].name, satellites[i].tle_line1, satellites[i].tle_line2)) {
+                scheduler.addSatellite(i, parsed.elements(), startUnixTime, GROUP_PASS_HORIZON_S);
             }
-            passes.push_back(passData);
+            i++;
+        } while (i < count && micros() - stepStart < GROUP_PASS_STEP_BUDGET_US);
 
-            // Avança 5 minutos após o fim da passagem
-            localUnixTime = passEndUnix + 300;
-        } else {
-            // Se não encontrar passagem, incrementa 5 minutos
-            localUnixTime += 300;
+        int progress = i * 100 / count;
+        if (progress != lastProgress) {
+            drawProgressBar(PROGRESS_BAR_X, PROGRESS_BAR_Y, PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT, progress, false);
+            lastProgress = progress;
+        }
+        updateGPS();
+        notificationManager.checkNotifications();
+        if (i < count && digitalRead(BTN_BACK) == LOW) {
+            Serial.printf("[updateGroupSchedule] Previsão cancelada em %d%%.\n", progress);
+            scheduler.clear();
+            scheduleValid = false;
+            return -1;
         }
+        delay(1);
     }
-    Serial.printf("Total de passagens geradas: %d\n", (int)passes.size());
+    scheduler.finish();
+    scheduleValid = true;
+    scheduleStart = startUnixTime;
+
+    const ScheduleStats& stats = scheduler.lastStats();
+    unsigned long elapsed = millis() - t0;
+    Serial.printf("[updateGroupSchedule] %d satélites (%d descartados pelo pré-filtro, %d com erro), %d passagens em %lu ms, %ld propagações/satélite\n",
+                  stats.satellites, stats.pruned, stats.failed, stats.passes, elapsed,
+                  stats.satellites > 0 ? stats.evaluations / stats.satellites : 0L);
+    return stats.passes;
+}
+
+//
+// Procura aproximações entre todos os satélites do grupo carregado
+//
+int SatelliteTracker::updateConjunctions() {
+    unsigned long startUnixTime = calculateUnixTime();
+    unsigned long t0 = millis();
+
+    // Triagem local: o lote de elementos só ocupa a RAM durante a busca
+    ConjunctionScreener screener;
+    screener.setThreshold(CONJUNCTION_THRESHOLD_KM);
+    screener.setStep(CONJUNCTION_STEP_S);
+
+    const int count = static_cast<int>(satellites.size());
+    elsetrec satrec;
+    Sgp4Model parsed;
+    for (int i = 0; i < count; i++) {
+        if (elementCache.load(i, satrec)) {
+            screener.addSatellite(i, satrec);
+        } else if (parsed.init(satellites[i].name, satellites[i].tle_line1, satellites[i].tle_line2)) {
+            screener.addSatellite(i, parsed.elements());
+        }
+    }
+
+    // Varredura em etapas: entre elas atualiza a barra, o GPS e as notificações, e BACK cancela
+    clearProgressBar(PROGRESS_BAR_X, PROGRESS_BAR_Y, PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT);
+    bool finished = !screener.begin(startUnixTime, CONJUNCTION_WINDOW_S);
+    int lastProgress = -1;
+    while (!finished) {
+        finished = screener.run(CONJUNCTION_STEP_BUDGET_US);
+        int progress = static_cast<int>(screener.progress() * 100.0f);
+        if (progress != lastProgress) {
+            drawProgressBar(PROGRESS_BAR_X, PROGRESS_BAR_Y, PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT, progress, false);
+            lastProgress = progress;
+        }
+        updateGPS();
+        notificationManager.checkNotifications();
+        if (!finished && digitalRead(BTN_BACK) == LOW) {
+            Serial.printf("[updateConjunctions] Triagem cancelada em %d%%.\n", progress);
+            return -1;
+        }
+        delay(1);
+    }
+    approaches = screener.results();
+    approachesValid = true;
+    approachesStart = startUnixTime;
+
+    const ConjunctionStats& stats = screener.lastStats();
+    unsigned long elapsed = millis() - t0;
+    Serial.printf("[updateConjunctions] %d satélites, %ld pares (%ld com cascas sobrepostas), %ld refinados, %d aproximações em %lu ms\n",
+                  stats.satellites, stats.pairs, stats.shellPairs, stats.candidates, stats.conjunctions, elapsed);
+    return stats.conjunctions;
 }
 
 //
@@ -260,10 +636,17 @@ bool SatelliteTracker::loadTLEFile(const char* filePath) {
     if (!file) {
         Serial.printf("Arquivo %s não encontrado.\n", filePath);
         satellites.clear();
+        batchValid = false;
+        scheduleValid = false;
+        approachesValid = false;
+        elementCache.close();
         return false;
     }
 
     satellites.clear();
+    batchValid = false;
+    scheduleValid = false;
+    approachesValid = false;
     while (file.available()) {
         // Lê o nome do satélite
         String name = file.readStringUntil('\n');
@@ -294,6 +677,9 @@ bool SatelliteTracker::loadTLEFile(const char* filePath) {
     }
     file.close();
 
+    // Elementos pré-inicializados: evita twoline2rv()/sgp4init() a cada seleção
+    elementCache.open(filePath, satellites);
+
     Serial.printf("Carregado: %d satélites de %s\n", (int)satellites.size(), filePath);
     return !satellites.empty();
 }
@@ -358,17 +744,32 @@ void SatelliteTracker::formatUnixTime(time_t unixTime, char* buffer, size_t buff
 // Atualiza a posição do satélite utilizando o SGP4 e os dados do GPS
 //
 void SatelliteTracker::updateSatellitePosition(unsigned long currentTime) {
-    // Calcula a posição do satélite para o tempo atual
-    sat.findsat(currentTime);
-    // Atualiza a posição do observador utilizando os dados do GPS
-    sat.site(getCurrentLatitude(), getCurrentLongitude(), getCurrentAltitude());
+    // Atualiza a posição do observador utilizando os dados do GPS (as efemérides são fixas
+    // à Terra: só o referencial do observador é refeito, e apenas quando o local muda)
+    double lat = getCurrentLatitude();
+    double lon = getCurrentLongitude();
+    double alt = getCurrentAltitude();
+    ephemeris.site(lat, lon, alt);
+
+    // Dentro da janela ajustada, avalia os polinômios em vez de propagar o SGP4
+    if (ephemeris.azel(currentTime, currentAz, currentEl)) {
+        return;
+    }
+
+    model.site(lat, lon, alt);
+
+    // Calcula a posição do satélite para o tempo atual sem alterar o objeto 'sat'
+    // (apenas azimute/elevação: o ponto subsatélite não é usado aqui)
+    model.findsat(liveContext, currentTime, findazel);
+    currentAz = liveContext.satAz;
+    currentEl = liveContext.satEl;
 }
 
 //
 // Retorna a elevação atual do satélite, conforme calculado pelo SGP4
 //
 double SatelliteTracker::getCurrentElevation() const {
-    return sat.satEl;
+    return currentEl;
 }
 
 //=============================================================================
@@ -377,6 +778,27 @@ double SatelliteTracker::getCurrentElevation() const {
 void SatelliteTracker::showEachPass() {
     const auto& passes = getPasses();
 
+    // Sem passagens no cache, espera a primeira da tarefa de previsão com botões e GPS ativos
+    if (passes.empty() && isGeneratingPasses()) {
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextFont(2);
+        tft.drawString("Computing passes...", 10, 10);
+        while (passes.empty() && isGeneratingPasses()) {
+            collectPasses();
+            updateGPS();
+            if (digitalRead(BTN_BACK) == LOW) {
+                Serial.println("[showEachPass] Busca cancelada.");
+                cancelPasses();
+                tft.fillScreen(TFT_BLACK);
+                delay(200);
+                return;
+            }
+            delay(20);
+        }
+        tft.fillScreen(TFT_BLACK);
+    }
+
     if (passes.empty()) {
         Serial.println("[showEachPass] Nenhuma passagem encontrada.");
         tft.fillScreen(TFT_BLACK);
@@ -392,6 +814,8 @@ void SatelliteTracker::showEachPass() {
     int currentPass = 0;
 
     while (true) {
+        // Passagens seguintes enviadas pela tarefa de previsão desde a última atualização
+        collectPasses();
         updateAzElRealTime();
 
         // Desenha a passagem e a posição atual
@@ -430,6 +854,7 @@ void SatelliteTracker::showEachPass() {
         tft.print(currentPass + 1);
         tft.print("/");
         tft.print(passes.size());
+        tft.print(isGeneratingPasses() ? "+ " : "  ");   // ainda procurando passagens
         tft.setCursor(10, 280);
         tft.print("AOS: ");
         tft.print(buffer_start);
@@ -512,6 +937,7 @@ void SatelliteTracker::showEachPass() {
         }
         else if (digitalRead(BTN_BACK) == LOW) {
             Serial.println("[showEachPass] Saindo da visualização de passagens.");
+            cancelPasses();
             tft.fillScreen(TFT_BLACK);
             delay(200);
             break;
@@ -520,6 +946,320 @@ void SatelliteTracker::showEachPass() {
     }
 }
 
+void SatelliteTracker::showGroupPasses() {
+    const int maxVisibleItems = 18;
+    unsigned long now = calculateUnixTime();
+
+    // Recalcula quando o grupo mudou ou quando a janela já passou da metade
+    if (!scheduleValid || now > scheduleStart + GROUP_PASS_HORIZON_S / 2) {
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextFont(2);
+        tft.drawString("Computing passes...", 10, 10);
+        if (updateGroupSchedule(getCurrentLatitude(), getCurrentLongitude(), getCurrentAltitude()) < 0) {
+            tft.fillScreen(TFT_BLACK);
+            delay(200);
+            menuManager.drawMenu();
+            return;
+        }
+    }
+
+    std::vector<ScheduledPass> upcoming;
+    getGroupPasses(now, maxVisibleItems, upcoming, GROUP_PASS_VISIBLE_ONLY != 0);
+    if (upcoming.empty()) {
+        Serial.println("[showGroupPasses] Nenhuma passagem encontrada.");
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextFont(2);
+        tft.drawString("No passes found", 10, 10);
+        delay(2000);
+        tft.fillScreen(TFT_BLACK);
+        menuManager.drawMenu();
+        return;
+    }
+
+    Serial.printf("[showGroupPasses] Exibindo %d passagens do grupo.\n", (int)upcoming.size());
+    int selectedPass = 0;
+    int previousPass = -1;
+    delay(200);
+
+    while (true) {
+        if (previousPass != selectedPass) {
+            Area menuArea = { MENU_X, MENU_Y,
+                              MENU_WIDTH, MENU_HEIGHT,
+                              MENU_HEADER_HEIGHT };
+            MenuManager::drawArea(menuArea, "NEXT PASSES", TFT_BLACK, TFT_WHITE, TFT_WHITE);
+            tft.fillRect(MENU_X + 1,
+                         MENU_Y + MENU_HEADER_HEIGHT + 1,
+                         MENU_WIDTH - 2,
+                         MENU_HEIGHT - MENU_HEADER_HEIGHT - 2,
+                         TFT_BLACK);
+
+            // Uma linha por passagem: nome, AOS local, elevação máxima e "*" se visível a olho nu
+            tft.setTextFont(1);
+            int posY = MENU_Y + MENU_HEADER_HEIGHT + 5;
+            for (int i = 0; i < static_cast<int>(upcoming.size()); i++) {
+                const ScheduledPass& pass = upcoming[i];
+                char aos[25];
+                char line[48];
+                formatUnixTime(pass.aos + getTimezone() * SECS_PER_HOUR, aos, sizeof(aos), true);
+                snprintf(line, sizeof(line), "%-14.14s %s %3.0f%s",
+                         getSatellite(pass.satellite).name, aos, pass.maxElevation,
+                         pass.sight == lighted ? "*" : "");
+                if (i == selectedPass) {
+                    tft.setTextColor(TFT_BLACK, TFT_WHITE);
+                } else {
+                    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+                }
+                tft.drawString(line, MENU_X + 5, posY);
+                posY += MENU_ITEM_SPACING;
+            }
+            previousPass = selectedPass;
+        }
+
+        if (digitalRead(BTN_NEXT) == LOW) {
+            selectedPass = (selectedPass + 1) % upcoming.size();
+            delay(200);
+        }
+        else if (digitalRead(BTN_PREV) == LOW) {
+            selectedPass = (selectedPass - 1 + upcoming.size()) % upcoming.size();
+            delay(200);
+        }
+        else if (digitalRead(BTN_SELECT) == LOW) {
+            int index = upcoming[selectedPass].satellite;
+            Serial.printf("[showGroupPasses] Satélite %d selecionado.\n", index);
+            tft.fillScreen(TFT_BLACK);
+            delay(500);
+            initSatellite(index);
+            updateAndGeneratePasses(
+                getCurrentLatitude(),
+                getCurrentLongitude(),
+                getCurrentAltitude(),
+                86400 // 24 horas
+            );
+            showEachPass();
+            previousPass = -1;
+        }
+        else if (digitalRead(BTN_BACK) == LOW) {
+            Serial.println("[showGroupPasses] Saindo da lista de passagens do grupo.");
+            tft.fillScreen(TFT_BLACK);
+            delay(200);
+            break;
+        }
+        delay(50);
+    }
+
+    menuManager.drawMenu();
+}
+
+//
+// Lista as próximas aproximações entre satélites do grupo
+//
+void SatelliteTracker::showConjunctions() {
+    const int maxVisibleItems = 18;
+    unsigned long now = calculateUnixTime();
+
+    // Refaz a triagem quando o grupo mudou ou quando a janela já passou da metade
+    if (!approachesValid || now > approachesStart + CONJUNCTION_WINDOW_S / 2) {
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextFont(2);
+        tft.drawString("Screening pairs...", 10, 10);
+        if (updateConjunctions() < 0) {
+            tft.fillScreen(TFT_BLACK);
+            delay(200);
+            menuManager.drawMenu();
+            return;
+        }
+    }
+
+    std::vector<Conjunction> upcoming;
+    for (const Conjunction& c : approaches) {
+        if (static_cast<int>(upcoming.size()) >= maxVisibleItems) {
+            break;
+        }
+        if (c.tca >= now) {
+            upcoming.push_back(c);
+        }
+    }
+    if (upcoming.empty()) {
+        Serial.println("[showConjunctions] Nenhuma aproximação encontrada.");
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextFont(2);
+        tft.drawString("No close approaches", 10, 10);
+        delay(2000);
+        tft.fillScreen(TFT_BLACK);
+        menuManager.drawMenu();
+        return;
+    }
+
+    Serial.printf("[showConjunctions] Exibindo %d aproximações.\n", (int)upcoming.size());
+    int selected = 0;
+    int previous = -1;
+    delay(200);
+
+    while (true) {
+        if (previous != selected) {
+            Area menuArea = { MENU_X, MENU_Y,
+                              MENU_WIDTH, MENU_HEIGHT,
+                              MENU_HEADER_HEIGHT };
+            MenuManager::drawArea(menuArea, "CLOSE APPROACHES", TFT_BLACK, TFT_WHITE, TFT_WHITE);
+            tft.fillRect(MENU_X + 1,
+                         MENU_Y + MENU_HEADER_HEIGHT + 1,
+                         MENU_WIDTH - 2,
+                         MENU_HEIGHT - MENU_HEADER_HEIGHT - 2,
+                         TFT_BLACK);
+
+            // Uma linha por aproximação: os dois satélites, TCA local e distância (km)
+            tft.setTextFont(1);
+            int posY = MENU_Y + MENU_HEADER_HEIGHT + 5;
+            for (int i = 0; i < static_cast<int>(upcoming.size()); i++) {
+                const Conjunction& c = upcoming[i];
+                char tca[25];
+                char line[48];
+                formatUnixTime(c.tca + getTimezone() * SECS_PER_HOUR, tca, sizeof(tca), true);
+                snprintf(line, sizeof(line), "%-8.8s %-8.8s %s %4.1f",
+                         getSatellite(c.first).name, getSatellite(c.second).name, tca, c.distance);
+                if (i == selected) {
+                    tft.setTextColor(TFT_BLACK, TFT_WHITE);
+                } else {
+                    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+                }
+                tft.drawString(line, MENU_X + 5, posY);
+                posY += MENU_ITEM_SPACING;
+            }
+            previous = selected;
+        }
+
+        if (digitalRead(BTN_NEXT) == LOW) {
+            selected = (selected + 1) % upcoming.size();
+            delay(200);
+        }
+        else if (digitalRead(BTN_PREV) == LOW) {
+            selected = (selected - 1 + upcoming.size()) % upcoming.size();
+            delay(200);
+        }
+        else if (digitalRead(BTN_SELECT) == LOW) {
+            // Detalhes da aproximação selecionada, até o próximo botão
+            const Conjunction& c = upcoming[selected];
+            char tca[25];
+            char line[48];
+            formatUnixTime(c.tca + getTimezone() * SECS_PER_HOUR, tca, sizeof(tca));
+            tft.fillScreen(TFT_BLACK);
+            tft.setTextColor(TFT_WHITE, TFT_BLACK);
+            tft.setTextFont(2);
+            tft.drawString(getSatellite(c.first).name, 10, 10);
+            tft.drawString(getSatellite(c.second).name, 10, 30);
+            snprintf(line, sizeof(line), "TCA %s", tca);
+            tft.drawString(line, 10, 60);
+            snprintf(line, sizeof(line), "Distance %.3f km", c.distance);
+            tft.drawString(line, 10, 80);
+            snprintf(line, sizeof(line), "Rel. speed %.2f km/s", c.speed);
+            tft.drawString(line, 10, 100);
+            Serial.printf("[showConjunctions] %s x %s: %s, %.3f km, %.2f km/s\n", getSatellite(c.first).name,
+                          getSatellite(c.second).name, tca, c.distance, c.speed);
+            delay(500);
+            while (digitalRead(BTN_SELECT) == HIGH && digitalRead(BTN_BACK) == HIGH) {
+                delay(50);
+            }
+            tft.fillScreen(TFT_BLACK);
+            delay(200);
+            previous = -1;
+        }
+        else if (digitalRead(BTN_BACK) == LOW) {
+            Serial.println("[showConjunctions] Saindo da lista de aproximações.");
+            tft.fillScreen(TFT_BLACK);
+            delay(200);
+            break;
+        }
+        delay(50);
+    }
+
+    menuManager.drawMenu();
+}
+
+//
+// Exibe o traço no solo do satélite selecionado, com a posição e a área de visibilidade atuais
+//
+void SatelliteTracker::showGroundTrack() {
+    if (currentSatelliteIndex < 0) {
+        Serial.println("[showGroundTrack] Nenhum satélite selecionado.");
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextFont(2);
+        tft.drawString("No satellite selected", 10, 10);
+        delay(2000);
+        tft.fillScreen(TFT_BLACK);
+        menuManager.drawMenu();
+        return;
+    }
+
+    // Traço local: os vértices só ocupam a RAM enquanto o mapa está aberto
+    GroundTrack track;
+    track.setStep(GROUND_TRACK_STEP_S);
+    track.setTolerance(GROUND_TRACK_TOLERANCE_DEG);
+    unsigned long period = static_cast<unsigned long>(2.0 * PI / model.elements().no * 60.0);
+    unsigned long trackStart = 0;
+    unsigned long lastDraw = 0;
+    Sgp4Context ctx;
+    model.initcontext(ctx);
+
+    Area menuArea = { MENU_X, MENU_Y,
+                      MENU_WIDTH, MENU_HEIGHT,
+                      MENU_HEADER_HEIGHT };
+    MenuManager::drawArea(menuArea, "GROUND TRACK", TFT_BLACK, TFT_WHITE, TFT_WHITE);
+    delay(200);
+
+    while (true) {
+        if (lastDraw == 0 || millis() - lastDraw >= 5000) {
+            unsigned long now = calculateUnixTime();
+
+            // Refaz o traço a cada órbita
+            if (trackStart == 0 || now >= trackStart + period) {
+                unsigned long t0 = millis();
+                trackStart = now;
+                track.generate(model, trackStart, GROUND_TRACK_ORBITS);
+                const TrackStats& stats = track.lastStats();
+                Serial.printf("[showGroundTrack] %d amostras, %d vértices em %d trechos, %lu ms\n",
+                              stats.samples, stats.vertices, stats.segments, millis() - t0);
+            }
+
+            model.findsat(ctx, now, findgeodetic);
+            double footprint = GroundTrack::footprintRadius(ctx.satAlt);
+            drawGroundTrackMap(track, ctx.satLat, ctx.satLon, footprint);
+
+            // Posição atual e raio da área de visibilidade (horizonte plano)
+            char line[48];
+            tft.fillRect(MENU_X + 1, GROUND_MAP_Y + GROUND_MAP_HEIGHT + 2, MENU_WIDTH - 2, 100, TFT_BLACK);
+            tft.setTextFont(2);
+            tft.setTextColor(TFT_WHITE, TFT_BLACK);
+            int posY = GROUND_MAP_Y + GROUND_MAP_HEIGHT + 10;
+            tft.drawString(getSatellite(currentSatelliteIndex).name, 10, posY);
+            snprintf(line, sizeof(line), "Lat %7.2f  Lon %8.2f", ctx.satLat, ctx.satLon);
+            tft.drawString(line, 10, posY + 20);
+            snprintf(line, sizeof(line), "Alt %.0f km", ctx.satAlt);
+            tft.drawString(line, 10, posY + 40);
+            snprintf(line, sizeof(line), "Footprint %.0f km", footprint * PI / 180.0 * 6378.135);
+            tft.drawString(line, 10, posY + 60);
+            snprintf(line, sizeof(line), "%.0f orbits, %d vertices", GROUND_TRACK_ORBITS,
+                     static_cast<int>(track.points().size()));
+            tft.drawString(line, 10, posY + 80);
+            lastDraw = millis();
+        }
+
+        if (digitalRead(BTN_BACK) == LOW) {
+            Serial.println("[showGroundTrack] Saindo do mapa do traço no solo.");
+            tft.fillScreen(TFT_BLACK);
+            delay(200);
+            break;
+        }
+        delay(50);
+    }
+
+    menuManager.drawMenu();
+}
+
 void SatelliteTracker::trackSatellite() {
     Serial.println("[trackSatellite] Entrando no menu de seleção de satélite.");
     tft.fillScreen(TFT_BLACK);
@@ -89,6 +89,8 @@ void setup() {
   // Step 5: Configure the GPS
   // showSetupMessage("Configuring GPS...", 265);
   setupGPS();
+  tracker.beginPassCache();   // depende do SPIFFS montado em setupGPS()
+  tracker.beginPassService(); // previsão de passagens no núcleo 0
   progress += stepIncrement;
   drawProgressBar(progressBarX, progressBarY, progressBarWidth, progressBarHeight, progress, false);
 
@@ -118,6 +120,9 @@ void setup() {
   menuManager.addMenuItem("TLE UPDATE", []() { tleManager.forceUpdateAllTle(); });
   menuManager.addMenuItem("BRIGHTNESS", controlBacklight);
   menuManager.addMenuItem("MANUAL TRACK", []() { tracker.manualTrack(); });
+  menuManager.addMenuItem("NEXT PASSES", []() { tracker.showGroupPasses(); });
+  menuManager.addMenuItem("APPROACHES", []() { tracker.showConjunctions(); });
+  menuManager.addMenuItem("GROUND TRACK", []() { tracker.showGroundTrack(); });
   progress += stepIncrement;
   drawProgressBar(progressBarX, progressBarY, progressBarWidth, progressBarHeight, progress, false);
 